@@ -8,266 +8,1380 @@
 */
 
 #include "AlgorithmicEngine.h"
+#include <algorithm>
 #include <cmath>
 
 // ============================================================================
 // Markov Chain Implementation
 // ============================================================================
-MarkovChain::MarkovChain(int order) : order(order)
+const MarkovModel::StateSlot* MarkovModel::findState(juce::uint64 key) const
 {
+    if (stateTable.empty())
+        return nullptr;
+
+    const auto mask = static_cast<juce::uint64>(stateTable.size() - 1);
+    auto index = MarkovChain::hashKey(key) & mask;
+
+    while (stateTable[index].key != 0)
+    {
+        if (stateTable[index].key == key)
+            return &stateTable[index];
+        index = (index + 1) & mask;
+    }
+
+    return nullptr;
+}
+
+const MarkovModelFile::StateRecord* MarkovModel::findMappedState(juce::uint64 key) const
+{
+    const auto* begin = MarkovModelFile::getStates(mappedHeader);
+    const auto* end = begin + mappedHeader->numStates;
+
+    auto it = std::lower_bound(begin, end, key, [](const MarkovModelFile::StateRecord& state, juce::uint64 k) {
+        return state.key < k;
+    });
+
+    return (it != end && it->key == key) ? it : nullptr;
+}
+
+MarkovChain::MarkovChain(int initialOrder)
+    : order(juce::jlimit(1, maxOrder, initialOrder)),
+      publisher(std::make_unique<MarkovModel>())
+{
+    compile();
+}
+
+juce::uint64 MarkovChain::packState(const int* stateValues, int stateLength)
+{
+    juce::uint64 key = static_cast<juce::uint64>(stateLength) << 56;
+
+    for (int i = 0; i < stateLength; ++i)
+        key |= static_cast<juce::uint64>(juce::jlimit(0, 127, stateValues[i])) << (7 * (stateLength - 1 - i));
+
+    return key;
+}
+
+juce::uint64 MarkovChain::hashKey(juce::uint64 key)
+{
+    // SplitMix64 finalizer
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
 }
 
 void MarkovChain::addTransition(const std::vector<int>& state, int nextValue, float probability)
 {
-    if (state.size() != order)
+    if (state.size() != getOrder())
         return;
 
-    transitionTable[state][nextValue] = probability;
+    const juce::ScopedLock lock(writeLock);
+    transitionWeights[packState(state.data(), getOrder())][juce::jlimit(0, 127, nextValue)] = juce::jmax(0.0f, probability);
 }
 
 void MarkovChain::learn(const std::vector<int>& sequence)
 {
-    if (sequence.size() <= order)
+    const int currentOrder = getOrder();
+    if (sequence.size() <= currentOrder)
         return;
 
     // Count transitions
-    std::map<std::vector<int>, std::map<int, int>> counts;
+    std::map<juce::uint64, std::map<int, int>> counts;
 
-    for (size_t i = 0; i <= sequence.size() - order - 1; ++i)
+    for (size_t i = 0; i <= sequence.size() - currentOrder - 1; ++i)
     {
-        std::vector<int> state(sequence.begin() + i, sequence.begin() + i + order);
-        int next = sequence[i + order];
-        counts[state][next]++;
+        auto key = packState(sequence.data() + i, currentOrder);
+        int next = juce::jlimit(0, 127, sequence[i + currentOrder]);
+        counts[key][next]++;
     }
 
+    const juce::ScopedLock lock(writeLock);
+
     // Convert counts to probabilities
-    for (const auto& [state, nextMap] : counts)
+    for (const auto& [key, nextMap] : counts)
     {
         int total = 0;
         for (const auto& [next, count] : nextMap)
             total += count;
 
-        for (const auto& [next, count] : nextMap)
-        {
-            float probability = static_cast<float>(count) / total;
-            addTransition(state, next, probability);
-        }
+        auto& weights = transitionWeights[key];
+        for (const auto& [next, count] : nextMap)
+            weights[next] = static_cast<float>(count) / total;
+    }
+
+    compileLocked();
+}
+
+void MarkovChain::replaceLearnedTransitions(WeightTable weights)
+{
+    const juce::ScopedLock lock(writeLock);
+    learnedWeights = std::move(weights);
+    compileLocked();
+}
+
+void MarkovChain::compile()
+{
+    const juce::ScopedLock lock(writeLock);
+    compileLocked();
+}
+
+void MarkovChain::buildAliasTable(const std::vector<float>& weights,
+                                  std::vector<float>& probabilities,
+                                  std::vector<int>& aliases)
+{
+    const int n = static_cast<int>(weights.size());
+    probabilities.assign(n, 1.0f);
+    aliases.assign(n, 0);
+
+    float total = 0.0f;
+    for (float weight : weights)
+        total += weight;
+
+    if (n == 0 || total <= 0.0f)
+        return;
+
+    std::vector<float> scaled(n);
+    std::vector<int> small, large;
+
+    for (int i = 0; i < n; ++i)
+    {
+        scaled[i] = weights[i] * n / total;
+        (scaled[i] < 1.0f ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        int less = small.back(); small.pop_back();
+        int more = large.back(); large.pop_back();
+
+        probabilities[less] = scaled[less];
+        aliases[less] = more;
+
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0f;
+        (scaled[more] < 1.0f ? small : large).push_back(more);
+    }
+
+    // Leftovers keep probability 1.0 (they are 1.0 up to rounding)
+}
+
+void MarkovChain::compileLocked()
+{
+    auto model = std::make_unique<MarkovModel>();
+    model->order = getOrder();
+    model->mappedFile = mappedModelFile;
+    model->mappedHeader = modelFileHeader;
+
+    size_t tableSize = 16;
+    while (tableSize < (transitionWeights.size() + learnedWeights.size()) * 2)
+        tableSize <<= 1;
+
+    model->stateTable.assign(tableSize, MarkovModel::StateSlot{});
+    const auto mask = static_cast<juce::uint64>(tableSize - 1);
+
+    std::vector<float> weights, probabilities;
+    std::vector<int> aliases;
+
+    auto addState = [&](juce::uint64 key, const std::map<int, float>& nextMap)
+    {
+        weights.clear();
+        float total = 0.0f;
+        for (const auto& [next, weight] : nextMap)
+        {
+            weights.push_back(weight);
+            total += weight;
+        }
+
+        if (weights.empty() || total <= 0.0f)
+            return;
+
+        buildAliasTable(weights, probabilities, aliases);
+
+        const int first = static_cast<int>(model->aliasEntries.size());
+        int column = 0;
+
+        for (const auto& [next, weight] : nextMap)
+        {
+            MarkovModel::AliasEntry entry;
+            entry.value = next;
+            entry.probability = probabilities[column];
+            entry.alias = aliases[column];
+            model->aliasEntries.push_back(entry);
+            ++column;
+        }
+
+        // Linear probing insert
+        auto index = hashKey(key) & mask;
+        while (model->stateTable[index].key != 0)
+            index = (index + 1) & mask;
+
+        model->stateTable[index].key = key;
+        model->stateTable[index].firstEntry = first;
+        model->stateTable[index].numEntries = column;
+        ++model->numStates;
+    };
+
+    // Sum of two distributions, each normalized, so neither table's scale dominates
+    auto blend = [](const std::map<int, float>& a, const std::map<int, float>& b)
+    {
+        auto total = [](const std::map<int, float>& m) {
+            float sum = 0.0f;
+            for (const auto& [next, weight] : m)
+                sum += weight;
+            return sum;
+        };
+
+        std::map<int, float> blended;
+        for (const auto* table : { &a, &b })
+        {
+            const float sum = total(*table);
+            if (sum > 0.0f)
+                for (const auto& [next, weight] : *table)
+                    blended[next] += weight / sum;
+        }
+        return blended;
+    };
+
+    for (const auto& [key, nextMap] : transitionWeights)
+    {
+        auto learned = learnedWeights.find(key);
+        if (learned != learnedWeights.end())
+            addState(key, blend(nextMap, learned->second));
+        else
+            addState(key, nextMap);
+    }
+
+    for (const auto& [key, nextMap] : learnedWeights)
+        if (transitionWeights.find(key) == transitionWeights.end())
+            addState(key, nextMap);
+
+    // States of the mapped file (those also edited are counted twice)
+    if (modelFileHeader != nullptr)
+        model->numStates += static_cast<int>(modelFileHeader->numStates);
+
+    publisher.publish(std::move(model));
+}
+
+bool MarkovChain::loadModelFile(const juce::File& modelFile)
+{
+    auto mapped = std::make_shared<juce::MemoryMappedFile>(modelFile, juce::MemoryMappedFile::readOnly);
+    const auto* header = MarkovModelFile::validate(mapped->getData(), mapped->getSize());
+    if (header == nullptr)
+        return false;
+
+    const juce::ScopedLock lock(writeLock);
+    if (static_cast<int>(header->order) != getOrder())
+        learnedWeights.clear();
+
+    order.store(static_cast<int>(header->order), std::memory_order_relaxed);
+    mappedModelFile = std::move(mapped);
+    modelFileHeader = header;
+    transitionWeights.clear();
+    compileLocked();
+    return true;
+}
+
+bool MarkovChain::hasModelFile() const
+{
+    const juce::ScopedLock lock(writeLock);
+    return mappedModelFile != nullptr;
+}
+
+int MarkovChain::getNumStates() const
+{
+    const juce::ScopedLock lock(writeLock);
+    return publisher.getLatest().numStates;
+}
+
+int MarkovChain::sampleState(const MarkovModel& model, juce::uint64 key)
+{
+    const auto* slot = model.findState(key);
+
+    // Fall back to the mapped file for states that were not edited or learned
+    if (slot == nullptr && model.mappedHeader != nullptr)
+    {
+        const auto* state = model.findMappedState(key);
+        if (state == nullptr || state->numTransitions == 0
+            || state->firstTransition + static_cast<juce::uint64>(state->numTransitions) > model.mappedHeader->numTransitions)
+            return defaultNote;
+
+        const auto* table = MarkovModelFile::getTransitions(model.mappedHeader) + state->firstTransition;
+        const int n = static_cast<int>(state->numTransitions);
+
+        float u = random.nextFloat() * n;
+        int column = juce::jmin(static_cast<int>(u), n - 1);
+
+        if (u - column < table[column].probability || table[column].alias >= n)
+            return table[column].value;
+        return table[table[column].alias].value;
+    }
+
+    if (slot == nullptr)
+        return defaultNote;
+
+    float u = random.nextFloat() * slot->numEntries;
+    int column = juce::jmin(static_cast<int>(u), slot->numEntries - 1);
+    const auto& entry = model.aliasEntries[slot->firstEntry + column];
+
+    if (u - column < entry.probability)
+        return entry.value;
+    return model.aliasEntries[slot->firstEntry + entry.alias].value;
+}
+
+int MarkovChain::generate(const std::vector<int>& currentState)
+{
+    return generate(currentState.data(), static_cast<int>(currentState.size()));
+}
+
+int MarkovChain::generate(const int* stateValues, int stateLength)
+{
+    const auto& model = publisher.acquire();
+    if (stateLength != model.order)
+        return defaultNote;
+
+    return sampleState(model, packState(stateValues, model.order));
+}
+
+int MarkovChain::generate(const NoteHistoryRing& history)
+{
+    const auto& model = publisher.acquire();
+    if (history.size() < model.order)
+        return defaultNote;
+
+    std::array<int, maxOrder> state;
+    for (int i = 0; i < model.order; ++i)
+        state[static_cast<size_t>(i)] = history.getRecent(model.order - 1 - i);
+
+    return sampleState(model, packState(state.data(), model.order));
+}
+
+void MarkovChain::reset()
+{
+    const juce::ScopedLock lock(writeLock);
+    transitionWeights.clear();
+    learnedWeights.clear();
+    mappedModelFile.reset();
+    modelFileHeader = nullptr;
+    compileLocked();
+}
+
+void MarkovChain::setOrder(int newOrder)
+{
+    const juce::ScopedLock lock(writeLock);
+    order.store(juce::jlimit(1, maxOrder, newOrder), std::memory_order_relaxed);
+    transitionWeights.clear();
+    learnedWeights.clear();
+    mappedModelFile.reset();
+    modelFileHeader = nullptr;
+    compileLocked();
+}
+
+// ============================================================================
+// Variable-Order Markov Implementation
+// ============================================================================
+int ContextTrie::findChild(int nodeIndex, int token) const
+{
+    const auto& children = nodes[static_cast<size_t>(nodeIndex)].children;
+
+    auto it = std::lower_bound(children.begin(), children.end(), static_cast<juce::uint16>(token),
+                               [](const std::pair<juce::uint16, juce::uint32>& child, juce::uint16 t) {
+                                   return child.first < t;
+                               });
+
+    return (it != children.end() && it->first == token) ? static_cast<int>(it->second) : -1;
+}
+
+VariableOrderMarkov::VariableOrderMarkov()
+    : publisher(std::make_unique<ContextTrie>())
+{
+}
+
+void VariableOrderMarkov::learn(const std::vector<MarkovEvent>& events, int numContextEvents)
+{
+    if (events.size() <= static_cast<size_t>(juce::jmax(0, numContextEvents)))
+        return;
+
+    const juce::ScopedLock lock(writeLock);
+    publishChunksLocked({ Chunk { events, numContextEvents } });
+}
+
+void VariableOrderMarkov::learn(const std::vector<std::vector<MarkovEvent>>& sequences)
+{
+    std::vector<Chunk> chunks;
+    for (const auto& events : sequences)
+        if (!events.empty())
+            chunks.push_back({ events, 0 });
+
+    if (chunks.empty())
+        return;
+
+    const juce::ScopedLock lock(writeLock);
+    publishChunksLocked(std::move(chunks));
+}
+
+void VariableOrderMarkov::publishChunksLocked(std::vector<Chunk> chunks)
+{
+    // Reuse the previous trie once the audio thread has let go of it, replaying
+    // what the latest one added; otherwise fall back to copying the latest
+    auto trie = publisher.reclaimPrevious();
+    if (trie != nullptr)
+    {
+        if (resetSincePrevious)
+            trie->nodes.assign(1, ContextTrie::Node{});
+
+        for (const auto& chunk : lastPublishedChunks)
+            learnLocked(*trie, chunk.events, chunk.numContextEvents);
+    }
+    else
+    {
+        trie = publisher.copyLatest();
+    }
+
+    for (const auto& chunk : chunks)
+        learnLocked(*trie, chunk.events, chunk.numContextEvents);
+
+    publisher.publish(std::move(trie));
+    lastPublishedChunks = std::move(chunks);
+    resetSincePrevious = false;
+    trained.store(true, std::memory_order_relaxed);
+}
+
+void VariableOrderMarkov::learnLocked(ContextTrie& trie, const std::vector<MarkovEvent>& events, int numContextEvents) const
+{
+    std::vector<int> tokens;
+    tokens.reserve(events.size());
+    for (const auto& event : events)
+        tokens.push_back(JointToken::encode(event));
+
+    const int maxContext = getMaxOrder();
+
+    auto increment = [](std::vector<std::pair<juce::uint16, juce::uint32>>& entries, juce::uint16 token) -> juce::uint32& {
+        auto it = std::lower_bound(entries.begin(), entries.end(), token,
+                                   [](const std::pair<juce::uint16, juce::uint32>& e, juce::uint16 t) { return e.first < t; });
+        if (it == entries.end() || it->first != token)
+            it = entries.insert(it, { token, 0 });
+        return it->second;
+    };
+
+    for (size_t i = static_cast<size_t>(juce::jmax(0, numContextEvents)); i < tokens.size(); ++i)
+    {
+        const auto next = static_cast<juce::uint16>(tokens[i]);
+        int nodeIndex = 0;
+
+        // Count the next token in every context from order 0 up to maxContext
+        for (int depth = 0; ; ++depth)
+        {
+            auto& node = trie.nodes[static_cast<size_t>(nodeIndex)];
+            ++increment(node.counts, next);
+            ++node.total;
+
+            if (depth >= maxContext || depth >= static_cast<int>(i))
+                break;
+
+            const auto older = static_cast<juce::uint16>(tokens[i - 1 - depth]);
+            int child = trie.findChild(nodeIndex, older);
+
+            if (child < 0)
+            {
+                // Node budget reached: longer contexts are not stored
+                if (trie.nodes.size() >= maxNodes)
+                    break;
+
+                child = static_cast<int>(trie.nodes.size());
+                increment(trie.nodes[static_cast<size_t>(nodeIndex)].children, older) = static_cast<juce::uint32>(child);
+                trie.nodes.emplace_back();
+            }
+
+            nodeIndex = child;
+        }
+    }
+}
+
+void VariableOrderMarkov::reset()
+{
+    const juce::ScopedLock lock(writeLock);
+    trained.store(false, std::memory_order_relaxed);
+    publisher.publish(std::make_unique<ContextTrie>());
+    lastPublishedChunks.clear();
+    resetSincePrevious = true;
+}
+
+void VariableOrderMarkov::setMaxOrder(int newOrder)
+{
+    order.store(juce::jlimit(1, maxOrder, newOrder), std::memory_order_relaxed);
+    reset();
+}
+
+int VariableOrderMarkov::getNumNodes() const
+{
+    const juce::ScopedLock lock(writeLock);
+    return static_cast<int>(publisher.getLatest().nodes.size());
+}
+
+int VariableOrderMarkov::generateToken(const NoteHistoryRing& tokenHistory)
+{
+    const auto& trie = publisher.acquire();
+
+    // Walk the current context as deep as the trie goes (bounded by maxOrder)
+    std::array<int, maxOrder + 1> path;
+    path[0] = 0;
+    int depth = 0;
+
+    const int maxDepth = juce::jmin(tokenHistory.size(), getMaxOrder());
+    while (depth < maxDepth)
+    {
+        int child = trie.findChild(path[static_cast<size_t>(depth)], tokenHistory.getRecent(depth));
+        if (child < 0)
+            break;
+        path[static_cast<size_t>(++depth)] = child;
+    }
+
+    // Back off from the longest context; PPM-C escape = distinct / (total + distinct)
+    for (; depth >= 0; --depth)
+    {
+        const auto& node = trie.nodes[static_cast<size_t>(path[static_cast<size_t>(depth)])];
+        if (node.total == 0)
+            continue;
+
+        const auto distinct = static_cast<float>(node.counts.size());
+        if (depth > 0 && random.nextFloat() < distinct / (node.total + distinct))
+            continue;
+
+        auto target = static_cast<juce::uint32>(random.nextFloat() * node.total);
+        for (const auto& [token, count] : node.counts)
+        {
+            if (target < count)
+                return token;
+            target -= count;
+        }
+        return node.counts.back().first;
+    }
+
+    return -1;
+}
+
+// ============================================================================
+// L-System Implementation
+// ============================================================================
+LSystemEngine::LSystemEngine() : axiom("A")
+{
+    // Default interpretation (C major degrees, octave and semitone shifts)
+    const char noteSymbols[] = { 'A', 'B', 'C', 'D', 'E', 'F', 'G' };
+    const int intervals[] = { 0, 2, 4, 5, 7, 9, 11 };
+    for (int i = 0; i < 7; ++i)
+        setSymbolAction(noteSymbols[i], SymbolAction::Note, intervals[i]);
+
+    setSymbolAction('+', SymbolAction::OctaveUp);
+    setSymbolAction('-', SymbolAction::OctaveDown);
+    setSymbolAction('[', SymbolAction::SemitoneUp);
+    setSymbolAction(']', SymbolAction::SemitoneDown);
+
+    setParametricAxiom(axiom);
+}
+
+void LSystemEngine::setAxiom(const juce::String& ax)
+{
+    axiom = ax;
+    setParametricAxiom(ax);
+}
+
+void LSystemEngine::addRule(char symbol, const juce::String& replacement, float probability)
+{
+    LSystemRule rule;
+    rule.symbol = symbol;
+    rule.replacement = replacement;
+    rule.probability = juce::jlimit(0.0f, 1.0f, probability);
+    rules[symbol].push_back(rule);
+
+    addParametricRule(juce::String::charToString(symbol), replacement, rule.probability);
+}
+
+void LSystemEngine::clearRules()
+{
+    rules.clear();
+    for (auto& symbolRules : compiledRules)
+        symbolRules.clear();
+    resetStream();
+}
+
+bool LSystemEngine::setParametricAxiom(const juce::String& axiomText)
+{
+    CompiledLSystemRule compiled;
+    if (!LSystemCompiler::compileAxiom(axiomText, compiled, lastError))
+        return false;
+
+    compiledAxiom = std::move(compiled);
+    resetStream();
+    return true;
+}
+
+bool LSystemEngine::addParametricRule(const juce::String& predecessor, const juce::String& successor,
+                                      float probability, const juce::String& leftContext,
+                                      const juce::String& rightContext, const juce::String& condition)
+{
+    CompiledLSystemRule compiled;
+    if (!LSystemCompiler::compileRule(predecessor, successor, probability, leftContext, rightContext,
+                                      condition, compiled, lastError))
+        return false;
+
+    if (!juce::isPositiveAndBelow(static_cast<int>(compiled.symbol), 128))
+    {
+        lastError = "Symbol must be ASCII";
+        return false;
+    }
+
+    compiledRules[static_cast<size_t>(compiled.symbol)].push_back(std::move(compiled));
+    resetStream();
+    return true;
+}
+
+void LSystemEngine::setSymbolAction(char symbol, SymbolAction action, int interval)
+{
+    if (!juce::isPositiveAndBelow(static_cast<int>(symbol), 128))
+        return;
+
+    actions[static_cast<size_t>(symbol)] = { action, interval };
+}
+
+juce::String LSystemEngine::iterate(int generations)
+{
+    juce::String current = axiom;
+
+    for (int gen = 0; gen < generations; ++gen)
+    {
+        juce::String next;
+
+        for (auto c : current)
+        {
+            auto it = rules.find(c);
+            if (it != rules.end() && !it->second.empty())
+            {
+                // Stochastic rule selection
+                float r = random.nextFloat();
+                float cumulative = 0.0f;
+                bool replaced = false;
+
+                for (const auto& rule : it->second)
+                {
+                    cumulative += rule.probability;
+                    if (r <= cumulative)
+                    {
+                        next += rule.replacement;
+                        replaced = true;
+                        break;
+                    }
+                }
+
+                if (!replaced)
+                    next += c;
+            }
+            else
+            {
+                next += c;
+            }
+        }
+
+        current = next;
+    }
+
+    return current;
+}
+
+std::vector<int> LSystemEngine::toMidiNotes(const juce::String& sequence, int baseNote)
+{
+    std::vector<int> notes;
+    int currentNote = baseNote;
+
+    for (auto c : sequence)
+    {
+        if (!juce::isPositiveAndBelow(static_cast<int>(c), 128))
+            continue;
+
+        const auto& entry = actions[static_cast<size_t>(c)];
+        switch (entry.action)
+        {
+            case SymbolAction::Note:         notes.push_back(currentNote + entry.interval); break;
+            case SymbolAction::OctaveUp:     currentNote = juce::jlimit(0, 127, currentNote + 12); break;
+            case SymbolAction::OctaveDown:   currentNote = juce::jlimit(0, 127, currentNote - 12); break;
+            case SymbolAction::SemitoneUp:   currentNote = juce::jlimit(0, 127, currentNote + 1); break;
+            case SymbolAction::SemitoneDown: currentNote = juce::jlimit(0, 127, currentNote - 1); break;
+            case SymbolAction::None:
+            default: break;
+        }
+    }
+
+    return notes;
+}
+
+void LSystemEngine::setGenerations(int generations)
+{
+    streamGenerations = juce::jlimit(0, maxGenerations, generations);
+    resetStream();
+}
+
+void LSystemEngine::setBaseNote(int note)
+{
+    baseNote = juce::jlimit(0, 127, note);
+    resetStream();
+}
+
+void LSystemEngine::resetStream()
+{
+    stackSize = 0;
+    currentNote = baseNote;
+}
+
+char LSystemEngine::neighbourSymbol(int level, int index, int direction) const
+{
+    // Look beside the module in its own replacement, then beside each enclosing
+    // module; a neighbour found there is that many generations older
+    int generationsBehind = 0;
+
+    for (;;)
+    {
+        const auto& frame = stack[static_cast<size_t>(level)];
+        const int neighbour = index + direction;
+
+        if (juce::isPositiveAndBelow(neighbour, static_cast<int>(frame.rule->successor.size())))
+            return expandedEdgeSymbol(frame.rule->instantiate(neighbour, frame.params.data()),
+                                      generationsBehind, direction);
+
+        if (level == 0)
+            return 0;
+
+        --level;
+        index = stack[static_cast<size_t>(level)].position - 1;
+        ++generationsBehind;
+    }
+}
+
+char LSystemEngine::expandedEdgeSymbol(LSystemModule module, int generations, int direction) const
+{
+    // Rewrite the neighbour forward, keeping only the module on the edge facing us
+    for (int g = 0; g < generations; ++g)
+    {
+        bool ambiguous = false;
+        const auto* rule = deterministicRule(module, ambiguous);
+
+        if (ambiguous)
+            break;
+        if (rule == nullptr)
+            continue;   // No rule applies: the module is copied unchanged
+        if (rule->successor.empty())
+            break;      // Deleted: the true neighbour lies further out
+
+        const int edge = direction < 0 ? static_cast<int>(rule->successor.size()) - 1 : 0;
+        module = rule->instantiate(edge, module.params.data());
+    }
+
+    return module.symbol;
+}
+
+const CompiledLSystemRule* LSystemEngine::deterministicRule(const LSystemModule& module, bool& ambiguous) const
+{
+    ambiguous = false;
+
+    if (!juce::isPositiveAndBelow(static_cast<int>(module.symbol), 128))
+        return nullptr;
+
+    const CompiledLSystemRule* match = nullptr;
+
+    for (const auto& rule : compiledRules[static_cast<size_t>(module.symbol)])
+    {
+        if (rule.numFormals > module.numParams || !rule.conditionHolds(module.params.data()))
+            continue;
+
+        // Context rules depend on this module's own neighbours; several matches or a
+        // probability below one are a random choice made when the module is reached
+        if (match != nullptr || rule.leftContext != 0 || rule.rightContext != 0 || rule.probability < 1.0f)
+        {
+            ambiguous = true;
+            return nullptr;
+        }
+
+        match = &rule;
+    }
+
+    return match;
+}
+
+const CompiledLSystemRule* LSystemEngine::chooseRule(const LSystemModule& module, int level, int index)
+{
+    if (!juce::isPositiveAndBelow(static_cast<int>(module.symbol), 128))
+        return nullptr;
+
+    const auto& candidates = compiledRules[static_cast<size_t>(module.symbol)];
+    if (candidates.empty())
+        return nullptr;
+
+    // Stochastic selection among the rules whose context and condition match
+    float r = random.nextFloat();
+    float cumulative = 0.0f;
+
+    for (const auto& rule : candidates)
+    {
+        if (rule.numFormals > module.numParams)
+            continue;
+        if (rule.leftContext != 0 && neighbourSymbol(level, index, -1) != rule.leftContext)
+            continue;
+        if (rule.rightContext != 0 && neighbourSymbol(level, index, 1) != rule.rightContext)
+            continue;
+        if (!rule.conditionHolds(module.params.data()))
+            continue;
+
+        cumulative += rule.probability;
+        if (r <= cumulative)
+            return &rule;
+    }
+
+    return nullptr;
+}
+
+bool LSystemEngine::nextModule(LSystemModule& module)
+{
+    if (compiledAxiom.successor.empty())
+        return false;
+
+    int restarts = 0;
+
+    for (;;)
+    {
+        if (stackSize == 0)
+        {
+            // Every module expanded to nothing: avoid spinning forever
+            if (++restarts > 2)
+                return false;
+
+            stack[0] = StreamFrame { &compiledAxiom, 0, 0, {} };
+            stackSize = 1;
+        }
+
+        auto& frame = stack[static_cast<size_t>(stackSize - 1)];
+
+        if (frame.position >= static_cast<int>(frame.rule->successor.size()))
+        {
+            // Finished this replacement; the empty stack restarts the axiom
+            --stackSize;
+            continue;
+        }
+
+        const int index = frame.position++;
+        module = frame.rule->instantiate(index, frame.params.data());
+
+        if (frame.generation < streamGenerations)
+        {
+            if (const auto* rule = chooseRule(module, stackSize - 1, index))
+            {
+                // Descend: expand this module one generation deeper with its parameters bound
+                stack[static_cast<size_t>(stackSize++)] = StreamFrame { rule, 0, frame.generation + 1, module.params };
+                continue;
+            }
+        }
+
+        return true;
+    }
+}
+
+char LSystemEngine::nextSymbol()
+{
+    LSystemModule module;
+    return nextModule(module) ? module.symbol : 0;
+}
+
+LSystemNote LSystemEngine::nextEvent()
+{
+    LSystemNote note;
+    LSystemModule module;
+
+    for (int i = 0; i < maxSymbolsPerNote && nextModule(module); ++i)
+    {
+        if (!juce::isPositiveAndBelow(static_cast<int>(module.symbol), 128))
+            continue;
+
+        const auto& entry = actions[static_cast<size_t>(module.symbol)];
+        switch (entry.action)
+        {
+            case SymbolAction::Note:
+                note.pitch = juce::jlimit(0, 127, currentNote + entry.interval);
+                if (module.numParams > 0)
+                    note.durationSteps = juce::jlimit(0.0625f, 64.0f, module.params[0]);
+                if (module.numParams > 1)
+                    note.velocity = juce::jlimit(0.0f, 1.0f, module.params[1]);
+                return note;
+
+            case SymbolAction::OctaveUp:     currentNote = juce::jlimit(0, 127, currentNote + 12); break;
+            case SymbolAction::OctaveDown:   currentNote = juce::jlimit(0, 127, currentNote - 12); break;
+            case SymbolAction::SemitoneUp:   currentNote = juce::jlimit(0, 127, currentNote + 1); break;
+            case SymbolAction::SemitoneDown: currentNote = juce::jlimit(0, 127, currentNote - 1); break;
+            case SymbolAction::None:
+            default: break;
+        }
+    }
+
+    return note;
+}
+
+// ============================================================================
+// Cellular Automaton Implementation
+// ============================================================================
+CellularAutomaton::CellularAutomaton(int size)
+{
+    setRule(rule);
+    setSize(size);
+}
+
+void CellularAutomaton::setSize(int size)
+{
+    numCells = juce::jlimit(1, maxCells, size);
+    numWords = (numCells + 63) / 64;
+
+    history.assign(static_cast<size_t>(historyDepth) * static_cast<size_t>(numWords), 0);
+    initialState.assign(static_cast<size_t>(numWords), 0);
+    restart(initialState);
+}
+
+void CellularAutomaton::setRule(int ruleNumber)
+{
+    rule = juce::jlimit(0, 255, ruleNumber);
+
+    for (int k = 0; k < 8; ++k)
+        ruleMasks[static_cast<size_t>(k)] = ((rule >> k) & 1) ? ~juce::uint64 { 0 } : juce::uint64 { 0 };
+}
+
+void CellularAutomaton::setState(const std::vector<bool>& state)
+{
+    if (!state.empty() && static_cast<int>(state.size()) != numCells)
+        setSize(static_cast<int>(state.size()));
+
+    std::fill(initialState.begin(), initialState.end(), 0);
+    for (int i = 0; i < numCells && i < static_cast<int>(state.size()); ++i)
+        if (state[static_cast<size_t>(i)])
+            initialState[static_cast<size_t>(i >> 6)] |= juce::uint64 { 1 } << (i & 63);
+
+    restart(initialState);
+}
+
+void CellularAutomaton::randomizeState(float density)
+{
+    std::fill(initialState.begin(), initialState.end(), 0);
+    for (int i = 0; i < numCells; ++i)
+        if (random.nextFloat() < density)
+            initialState[static_cast<size_t>(i >> 6)] |= juce::uint64 { 1 } << (i & 63);
+
+    restart(initialState);
+}
+
+void CellularAutomaton::reset()
+{
+    restart(initialState);
+}
+
+void CellularAutomaton::restart(const std::vector<juce::uint64>& words)
+{
+    head = 0;
+    historyCount = 1;
+    std::copy(words.begin(), words.end(), row(0));
+}
+
+juce::uint64 CellularAutomaton::lastWordMask() const
+{
+    const int usedBits = numCells - (numWords - 1) * 64;
+    return usedBits == 64 ? ~juce::uint64 { 0 } : (juce::uint64 { 1 } << usedBits) - 1;
+}
+
+void CellularAutomaton::step()
+{
+    // Evaluate 64 cells per word: the rule table becomes a tree of bitwise
+    // selects on (left, center, right), so no per-cell branching or lookup
+    const int nextHead = (head + 1) % historyDepth;
+    const juce::uint64* current = currentRow();
+    juce::uint64* next = row(nextHead);
+
+    const int lastWord = numWords - 1;
+    const int lastBit = (numCells - 1) & 63;
+    const juce::uint64 firstCell = current[0] & 1;
+    const juce::uint64 lastCell = (current[lastWord] >> lastBit) & 1;
+
+    const auto select = [](juce::uint64 condition, juce::uint64 whenSet, juce::uint64 whenClear)
+    {
+        return (condition & whenSet) | (~condition & whenClear);
+    };
+
+    for (int w = 0; w < numWords; ++w)
+    {
+        const juce::uint64 center = current[w];
+
+        // Left neighbour of cell i is cell i - 1 (wrapping to the last cell)
+        const juce::uint64 carryIn = (w == 0) ? lastCell : (current[w - 1] >> 63);
+        const juce::uint64 left = (center << 1) | carryIn;
+
+        // Right neighbour of cell i is cell i + 1 (wrapping to the first cell)
+        juce::uint64 right = center >> 1;
+        if (w == lastWord)
+            right |= firstCell << lastBit;
+        else
+            right |= current[w + 1] << 63;
+
+        const juce::uint64 centerSet = select(right, ruleMasks[3], ruleMasks[2]);
+        const juce::uint64 centerClear = select(right, ruleMasks[1], ruleMasks[0]);
+        const juce::uint64 leftClear = select(center, centerSet, centerClear);
+
+        const juce::uint64 centerSetL = select(right, ruleMasks[7], ruleMasks[6]);
+        const juce::uint64 centerClearL = select(right, ruleMasks[5], ruleMasks[4]);
+        const juce::uint64 leftSet = select(center, centerSetL, centerClearL);
+
+        next[w] = select(left, leftSet, leftClear);
+    }
+
+    next[lastWord] &= lastWordMask();
+
+    head = nextHead;
+    historyCount = juce::jmin(historyCount + 1, historyDepth);
+}
+
+bool CellularAutomaton::getCell(int index) const
+{
+    if (!juce::isPositiveAndBelow(index, numCells))
+        return false;
+
+    return (currentRow()[index >> 6] >> (index & 63)) & 1;
+}
+
+std::vector<bool> CellularAutomaton::getState() const
+{
+    std::vector<bool> state(static_cast<size_t>(numCells));
+    for (int i = 0; i < numCells; ++i)
+        state[static_cast<size_t>(i)] = getCell(i);
+    return state;
+}
+
+const juce::uint64* CellularAutomaton::getHistoryRow(int generationsAgo) const
+{
+    if (!juce::isPositiveAndBelow(generationsAgo, historyCount))
+        return nullptr;
+
+    const int slot = (head - generationsAgo + historyDepth) % historyDepth;
+    return history.data() + static_cast<size_t>(slot) * static_cast<size_t>(numWords);
+}
+
+bool CellularAutomaton::getHistoryCell(int generationsAgo, int index) const
+{
+    const auto* words = getHistoryRow(generationsAgo);
+    if (words == nullptr || !juce::isPositiveAndBelow(index, numCells))
+        return false;
+
+    return (words[index >> 6] >> (index & 63)) & 1;
+}
+
+// ============================================================================
+// Life Automaton Implementation
+// ============================================================================
+namespace
+{
+    // Row neighbours on the torus: bit c of the result holds column c -/+ 1
+    inline juce::uint64 columnLeft(juce::uint64 row)  { return (row << 1) | (row >> 63); }
+    inline juce::uint64 columnRight(juce::uint64 row) { return (row >> 1) | (row << 63); }
+}
+
+LifeAutomaton::LifeAutomaton()
+{
+    setRule("B3/S23");
+}
+
+bool LifeAutomaton::setRule(const juce::String& ruleString)
+{
+    juce::uint16 birth = 0, survival = 0;
+    juce::uint16* target = nullptr;
+
+    for (auto c : ruleString)
+    {
+        if (c == 'B' || c == 'b')
+            target = &birth;
+        else if (c == 'S' || c == 's')
+            target = &survival;
+        else if (c >= '0' && c <= '8' && target != nullptr)
+            *target = static_cast<juce::uint16>(*target | (1u << (c - '0')));
+        else if (c != '/' && c != ' ')
+            return false;
+    }
+
+    setRule(birth, survival);
+    return true;
+}
+
+void LifeAutomaton::setRule(juce::uint16 birthCounts, juce::uint16 survivalCounts)
+{
+    birthMask = static_cast<juce::uint16>(birthCounts & 0x1ff);
+    survivalMask = static_cast<juce::uint16>(survivalCounts & 0x1ff);
+
+    numTerms = 0;
+    for (int n = 0; n <= 8; ++n)
+    {
+        const bool births = (birthMask >> n) & 1;
+        const bool survives = (survivalMask >> n) & 1;
+        if (!births && !survives)
+            continue;
+
+        auto& term = terms[static_cast<size_t>(numTerms++)];
+        for (size_t bit = 0; bit < term.countBits.size(); ++bit)
+            term.countBits[bit] = ((n >> bit) & 1) ? ~juce::uint64 { 0 } : 0;
+        term.whenDead = births ? ~juce::uint64 { 0 } : 0;
+        term.whenAlive = survives ? ~juce::uint64 { 0 } : 0;
     }
 }
 
-int MarkovChain::generate(const std::vector<int>& currentState)
+juce::String LifeAutomaton::getRuleString() const
 {
-    if (currentState.size() != order)
-        return 60; // Default middle C
+    juce::String text("B");
+    for (int n = 0; n <= 8; ++n)
+        if ((birthMask >> n) & 1)
+            text += static_cast<char>('0' + n);
 
-    auto it = transitionTable.find(currentState);
-    if (it == transitionTable.end() || it->second.empty())
-        return 60;
+    text += "/S";
+    for (int n = 0; n <= 8; ++n)
+        if ((survivalMask >> n) & 1)
+            text += static_cast<char>('0' + n);
 
-    // Weighted random selection
-    float r = random.nextFloat();
-    float cumulative = 0.0f;
+    return text;
+}
+
+void LifeAutomaton::clear()
+{
+    cells.fill(0);
+    previous.fill(0);
+    generation = 0;
+}
 
-    for (const auto& [value, probability] : it->second)
+void LifeAutomaton::randomize(float density)
+{
+    density = juce::jlimit(0.0f, 1.0f, density);
+
+    for (int row = 0; row < numRows; ++row)
     {
-        cumulative += probability;
-        if (r <= cumulative)
-            return value;
+        juce::uint64 bits = 0;
+        for (int column = 0; column < numColumns; ++column)
+            if (random.nextFloat() < density)
+                bits |= juce::uint64 { 1 } << column;
+
+        cells[static_cast<size_t>(row)] = bits;
     }
 
-    // Fallback to last option
-    return it->second.rbegin()->first;
+    previous.fill(0);
+    generation = 0;
 }
 
-void MarkovChain::reset()
+void LifeAutomaton::setCell(int row, int column, bool alive)
 {
-    transitionTable.clear();
-}
+    if (!juce::isPositiveAndBelow(row, numRows) || !juce::isPositiveAndBelow(column, numColumns))
+        return;
 
-void MarkovChain::setOrder(int newOrder)
-{
-    order = juce::jlimit(1, 5, newOrder);
-    reset();
+    const auto bit = juce::uint64 { 1 } << column;
+    auto& word = cells[static_cast<size_t>(row)];
+    word = alive ? (word | bit) : (word & ~bit);
 }
 
-// ============================================================================
-// L-System Implementation
-// ============================================================================
-LSystemEngine::LSystemEngine() : axiom("A")
+bool LifeAutomaton::getCell(int row, int column) const
 {
+    if (!juce::isPositiveAndBelow(row, numRows) || !juce::isPositiveAndBelow(column, numColumns))
+        return false;
+
+    return (cells[static_cast<size_t>(row)] >> column) & 1;
 }
 
-void LSystemEngine::setAxiom(const juce::String& ax)
+juce::uint64 LifeAutomaton::getRow(int row) const
 {
-    axiom = ax;
+    return juce::isPositiveAndBelow(row, numRows) ? cells[static_cast<size_t>(row)] : 0;
 }
 
-void LSystemEngine::addRule(char symbol, const juce::String& replacement, float probability)
+juce::uint64 LifeAutomaton::getBirths(int row) const
 {
-    LSystemRule rule;
-    rule.symbol = symbol;
-    rule.replacement = replacement;
-    rule.probability = juce::jlimit(0.0f, 1.0f, probability);
-    rules[symbol].push_back(rule);
+    if (!juce::isPositiveAndBelow(row, numRows))
+        return 0;
+
+    return cells[static_cast<size_t>(row)] & ~previous[static_cast<size_t>(row)];
 }
 
-void LSystemEngine::clearRules()
+bool LifeAutomaton::isEmpty() const
 {
-    rules.clear();
+    juce::uint64 any = 0;
+    for (auto row : cells)
+        any |= row;
+    return any == 0;
 }
 
-juce::String LSystemEngine::iterate(int generations)
+void LifeAutomaton::step()
 {
-    juce::String current = axiom;
+    previous = cells;
 
-    for (int gen = 0; gen < generations; ++gen)
+    // Each pass is a straight loop over independent rows, so the compiler can
+    // process several rows per vector instruction
+
+    // Horizontal sum of each row's (left, centre, right) as two bit planes (0-3)
+    for (size_t r = 0; r < numRows; ++r)
     {
-        juce::String next;
+        const auto centre = previous[r];
+        const auto left = columnLeft(centre);
+        const auto right = columnRight(centre);
+        const auto halfSum = left ^ centre;
 
-        for (auto c : current)
-        {
-            auto it = rules.find(c);
-            if (it != rules.end() && !it->second.empty())
-            {
-                // Stochastic rule selection
-                float r = random.nextFloat();
-                float cumulative = 0.0f;
-                bool replaced = false;
+        rowSumLow[r + 1] = halfSum ^ right;
+        rowSumHigh[r + 1] = (left & centre) | (right & halfSum);
+    }
 
-                for (const auto& rule : it->second)
-                {
-                    cumulative += rule.probability;
-                    if (r <= cumulative)
-                    {
-                        next += rule.replacement;
-                        replaced = true;
-                        break;
-                    }
-                }
+    rowSumLow[0] = rowSumLow[numRows];
+    rowSumHigh[0] = rowSumHigh[numRows];
+    rowSumLow[numRows + 1] = rowSumLow[1];
+    rowSumHigh[numRows + 1] = rowSumHigh[1];
 
-                if (!replaced)
-                    next += c;
-            }
-            else
-            {
-                next += c;
-            }
-        }
+    // Add three 2-bit numbers: the rows above and below (0-3) and the centre
+    // row's two side neighbours (0-2), giving a count of 0-8
+    for (size_t r = 0; r < numRows; ++r)
+    {
+        const auto centre = previous[r];
+        const auto left = columnLeft(centre);
+        const auto right = columnRight(centre);
 
-        current = next;
-    }
+        const auto a0 = rowSumLow[r],     a1 = rowSumHigh[r];
+        const auto b0 = left ^ right,     b1 = left & right;
+        const auto c0 = rowSumLow[r + 2], c1 = rowSumHigh[r + 2];
 
-    return current;
-}
+        const auto ab0 = a0 ^ b0;
+        const auto carry2 = (a0 & b0) | (c0 & ab0);
 
-std::vector<int> LSystemEngine::toMidiNotes(const juce::String& sequence, int baseNote)
-{
-    std::vector<int> notes;
-    int currentNote = baseNote;
+        const auto p = a1 ^ b1, q = a1 & b1;
+        const auto t = c1 ^ carry2, u = c1 & carry2;
+        const auto v = p & t;
 
-    for (auto c : sequence)
+        count1[r] = ab0 ^ c0;
+        count2[r] = p ^ t;
+        count4[r] = q ^ u ^ v;
+        count8[r] = (q & u) | (v & (q | u));
+    }
+
+    cells.fill(0);
+
+    for (int i = 0; i < numTerms; ++i)
     {
-        switch (c)
+        const auto& term = terms[static_cast<size_t>(i)];
+
+        for (size_t r = 0; r < numRows; ++r)
         {
-            case 'A': notes.push_back(currentNote); break;
-            case 'B': notes.push_back(currentNote + 2); break;
-            case 'C': notes.push_back(currentNote + 4); break;
-            case 'D': notes.push_back(currentNote + 5); break;
-            case 'E': notes.push_back(currentNote + 7); break;
-            case 'F': notes.push_back(currentNote + 9); break;
-            case 'G': notes.push_back(currentNote + 11); break;
-            case '+': currentNote = juce::jlimit(0, 127, currentNote + 12); break; // Octave up
-            case '-': currentNote = juce::jlimit(0, 127, currentNote - 12); break; // Octave down
-            case '[': currentNote = juce::jlimit(0, 127, currentNote + 1); break;  // Semitone up
-            case ']': currentNote = juce::jlimit(0, 127, currentNote - 1); break;  // Semitone down
-            default: break;
+            // A column matches when no bit of its count differs from the term's count
+            const auto equals = ~((count1[r] ^ term.countBits[0]) | (count2[r] ^ term.countBits[1])
+                                | (count4[r] ^ term.countBits[2]) | (count8[r] ^ term.countBits[3]));
+
+            cells[r] |= equals & ((previous[r] & term.whenAlive) | (~previous[r] & term.whenDead));
         }
     }
 
-    return notes;
+    ++generation;
 }
 
 // ============================================================================
-// Cellular Automaton Implementation
+// Probabilistic Generator Implementation
 // ============================================================================
-CellularAutomaton::CellularAutomaton(int size) : cells(size, false)
+namespace
 {
-    initialState = cells;
-}
+    /**
+     * Tables for the Marsaglia-Tsang ziggurat normal sampler (128 layers).
+     * Only samples falling in a layer's wedge or in the tail (about 1.2%)
+     * need exp/log; the rest cost one integer compare and one multiply.
+     */
+    struct ZigguratTables
+    {
+        static constexpr double tailStart = 3.442619855899;
 
-void CellularAutomaton::setRule(int ruleNumber)
-{
-    rule = juce::jlimit(0, 255, ruleNumber);
-}
+        std::array<juce::uint32, 128> kn;
+        std::array<float, 128> wn;
+        std::array<float, 128> fn;
 
-void CellularAutomaton::setState(const std::vector<bool>& state)
-{
-    cells = state;
-    initialState = state;
+        ZigguratTables()
+        {
+            const double m1 = 2147483648.0;
+            const double area = 9.91256303526217e-3;
+            double dn = tailStart, tn = dn;
+            const double q = area / std::exp(-0.5 * dn * dn);
+
+            kn[0] = static_cast<juce::uint32>((dn / q) * m1);
+            kn[1] = 0;
+            wn[0] = static_cast<float>(q / m1);
+            wn[127] = static_cast<float>(dn / m1);
+            fn[0] = 1.0f;
+            fn[127] = static_cast<float>(std::exp(-0.5 * dn * dn));
+
+            for (int i = 126; i >= 1; --i)
+            {
+                dn = std::sqrt(-2.0 * std::log(area / dn + std::exp(-0.5 * dn * dn)));
+                kn[static_cast<size_t>(i + 1)] = static_cast<juce::uint32>((dn / tn) * m1);
+                tn = dn;
+                fn[static_cast<size_t>(i)] = static_cast<float>(std::exp(-0.5 * dn * dn));
+                wn[static_cast<size_t>(i)] = static_cast<float>(dn / m1);
+            }
+        }
+    };
+
+    const ZigguratTables& getZigguratTables()
+    {
+        static const ZigguratTables tables;
+        return tables;
+    }
 }
 
-void CellularAutomaton::randomizeState(float density)
+ProbabilisticGenerator::ProbabilisticGenerator()
 {
-    for (size_t i = 0; i < cells.size(); ++i)
-        cells[i] = random.nextFloat() < density;
-    initialState = cells;
+    // Build the shared tables here rather than on the first audio-thread sample
+    getZigguratTables();
 }
 
-std::vector<bool> CellularAutomaton::step()
+int ProbabilisticGenerator::generateNote(int center, int range, const std::vector<float>& weights)
 {
-    std::vector<bool> nextCells(cells.size());
-
-    for (size_t i = 0; i < cells.size(); ++i)
-    {
-        bool left = cells[(i - 1 + cells.size()) % cells.size()];
-        bool center = cells[i];
-        bool right = cells[(i + 1) % cells.size()];
+    if (weights.empty())
+        return center + random.nextInt(range * 2 + 1) - range;
 
-        nextCells[i] = applyRule(left, center, right);
-    }
+    if (weights != noteWeights)
+        setNoteWeights(weights);
 
-    cells = nextCells;
-    return cells;
+    return generateNote(center, range);
 }
 
-void CellularAutomaton::reset()
+void ProbabilisticGenerator::setNoteWeights(const std::vector<float>& weights)
 {
-    cells = initialState;
+    noteWeights = weights;
+    MarkovChain::buildAliasTable(noteWeights, aliasProbabilities, aliasIndices);
 }
 
-bool CellularAutomaton::applyRule(bool left, bool center, bool right)
+int ProbabilisticGenerator::generateNote(int center, int range)
 {
-    int index = (left ? 4 : 0) + (center ? 2 : 0) + (right ? 1 : 0);
-    return (rule >> index) & 1;
+    const int numWeights = static_cast<int>(aliasProbabilities.size());
+    if (numWeights == 0)
+        return center + random.nextInt(range * 2 + 1) - range;
+
+    // One uniform picks both the column and the alias coin
+    const float u = random.nextFloat() * numWeights;
+    const int column = juce::jmin(static_cast<int>(u), numWeights - 1);
+    const int index = (u - column < aliasProbabilities[static_cast<size_t>(column)])
+                        ? column : aliasIndices[static_cast<size_t>(column)];
+
+    return center - range + index;
 }
 
-// ============================================================================
-// Probabilistic Generator Implementation
-// ============================================================================
-ProbabilisticGenerator::ProbabilisticGenerator()
+void ProbabilisticGenerator::generateNotes(int* destination, int numNotes, int center, int range)
 {
+    for (int i = 0; i < numNotes; ++i)
+        destination[i] = generateNote(center, range);
 }
 
-int ProbabilisticGenerator::generateNote(int center, int range, const std::vector<float>& weights)
+void ProbabilisticGenerator::generateVelocities(float* destination, int numValues, float mean, float variance)
 {
-    if (weights.empty())
-        return center + random.nextInt(range * 2 + 1) - range;
-
-    float r = random.nextFloat();
-    float cumulative = 0.0f;
-    float totalWeight = 0.0f;
-
-    for (float w : weights)
-        totalWeight += w;
-
-    for (size_t i = 0; i < weights.size(); ++i)
-    {
-        cumulative += weights[i] / totalWeight;
-        if (r <= cumulative)
-            return center - range + static_cast<int>(i);
-    }
+    for (int i = 0; i < numValues; ++i)
+        destination[i] = generateVelocity(mean, variance);
+}
 
-    return center;
+void ProbabilisticGenerator::generateGaussian(float* destination, int numValues, float mean, float stddev)
+{
+    for (int i = 0; i < numValues; ++i)
+        destination[i] = mean + standardNormal() * stddev;
 }
 
 float ProbabilisticGenerator::generateVelocity(float mean, float variance)
@@ -294,46 +1408,65 @@ std::vector<int> ProbabilisticGenerator::generateScale(int root, const std::vect
 
 std::vector<int> ProbabilisticGenerator::generateMelody(int length, int minNote, int maxNote, float stepProbability)
 {
-    std::vector<int> melody;
-    int currentNote = minNote + random.nextInt(maxNote - minNote + 1);
+    std::vector<int> melody(static_cast<size_t>(juce::jmax(0, length)));
+    generateMelody(melody.data(), length, minNote, maxNote, stepProbability);
+    return melody;
+}
+
+void ProbabilisticGenerator::generateMelody(int* destination, int length, int minNote, int maxNote, float stepProbability)
+{
+    int currentNote = nextMelodyNote(-1, minNote, maxNote, stepProbability);
 
     for (int i = 0; i < length; ++i)
     {
-        melody.push_back(currentNote);
+        destination[i] = currentNote;
+        currentNote = nextMelodyNote(currentNote, minNote, maxNote, stepProbability);
+    }
+}
 
-        if (random.nextFloat() < stepProbability)
-        {
-            // Step motion (1-2 semitones)
-            int step = random.nextBool() ? random.nextInt(3) : -random.nextInt(3);
-            currentNote = juce::jlimit(minNote, maxNote, currentNote + step);
-        }
-        else
-        {
-            // Leap motion (3-7 semitones)
-            int leap = random.nextInt(5) + 3;
-            if (random.nextBool())
-                leap = -leap;
-            currentNote = juce::jlimit(minNote, maxNote, currentNote + leap);
-        }
+int ProbabilisticGenerator::nextMelodyNote(int currentNote, int minNote, int maxNote, float stepProbability)
+{
+    if (currentNote < 0)
+        return minNote + random.nextInt(maxNote - minNote + 1);
+
+    if (random.nextFloat() < stepProbability)
+    {
+        // Step motion (1-2 semitones)
+        int step = random.nextBool() ? random.nextInt(3) : -random.nextInt(3);
+        return juce::jlimit(minNote, maxNote, currentNote + step);
     }
 
-    return melody;
+    // Leap motion (3-7 semitones)
+    int leap = random.nextInt(5) + 3;
+    if (random.nextBool())
+        leap = -leap;
+    return juce::jlimit(minNote, maxNote, currentNote + leap);
 }
 
 std::vector<bool> ProbabilisticGenerator::generateRhythm(int length, float density, float grouping)
 {
-    std::vector<bool> rhythm(length, false);
+    std::vector<bool> rhythm(static_cast<size_t>(juce::jmax(0, length)), false);
 
     for (int i = 0; i < length; ++i)
     {
         // Apply grouping bias
         float bias = std::fmod(i, grouping) < 1.0f ? 1.5f : 1.0f;
-        rhythm[i] = random.nextFloat() < (density * bias);
+        rhythm[static_cast<size_t>(i)] = random.nextFloat() < (density * bias);
     }
 
     return rhythm;
 }
 
+void ProbabilisticGenerator::generateRhythm(bool* destination, int length, float density, float grouping)
+{
+    for (int i = 0; i < length; ++i)
+    {
+        // Apply grouping bias
+        float bias = std::fmod(i, grouping) < 1.0f ? 1.5f : 1.0f;
+        destination[i] = random.nextFloat() < (density * bias);
+    }
+}
+
 int ProbabilisticGenerator::randomWalk(int current, int step, int minValue, int maxValue)
 {
     int direction = random.nextBool() ? 1 : -1;
@@ -350,11 +1483,47 @@ float ProbabilisticGenerator::randomWalkFloat(float current, float step, float m
 
 float ProbabilisticGenerator::gaussianRandom(float mean, float stddev)
 {
-    // Box-Muller transform
-    float u1 = random.nextFloat();
-    float u2 = random.nextFloat();
-    float z0 = std::sqrt(-2.0f * std::log(u1)) * std::cos(2.0f * juce::MathConstants<float>::pi * u2);
-    return mean + z0 * stddev;
+    return mean + standardNormal() * stddev;
+}
+
+float ProbabilisticGenerator::standardNormal()
+{
+    // Ziggurat (Marsaglia & Tsang, 2000)
+    const auto& tables = getZigguratTables();
+
+    const auto uniform = [this] { return (static_cast<float>(random.nextInt(0x7fffffff)) + 1.0f) / 2147483648.0f; };
+
+    for (;;)
+    {
+        const auto bits = static_cast<juce::int32>(random.nextInt());
+        const auto layer = static_cast<size_t>(bits & 127);
+        const auto magnitude = bits < 0 ? 0u - static_cast<juce::uint32>(bits) : static_cast<juce::uint32>(bits);
+
+        const float x = static_cast<float>(bits) * tables.wn[layer];
+
+        // Inside the layer's rectangle
+        if (magnitude < tables.kn[layer])
+            return x;
+
+        if (layer == 0)
+        {
+            // Tail beyond the base layer
+            float tailX, tailY;
+            do
+            {
+                tailX = -std::log(uniform()) / static_cast<float>(ZigguratTables::tailStart);
+                tailY = -std::log(uniform());
+            }
+            while (tailY + tailY < tailX * tailX);
+
+            const float tail = static_cast<float>(ZigguratTables::tailStart) + tailX;
+            return bits > 0 ? tail : -tail;
+        }
+
+        // Wedge between the rectangle and the density curve
+        if (tables.fn[layer] + uniform() * (tables.fn[layer - 1] - tables.fn[layer]) < std::exp(-0.5f * x * x))
+            return x;
+    }
 }
 
 // ============================================================================
@@ -366,7 +1535,99 @@ AlgorithmicEngine::AlgorithmicEngine()
 
 void AlgorithmicEngine::setGeneratorType(GeneratorType type)
 {
+    if (type == currentType)
+        return;
+
     currentType = type;
+    resetCursors();
+}
+
+void AlgorithmicEngine::resetCursors()
+{
+    stepsUntilNextEvent = 0;
+    cellularColumn = 0;
+    melodyNote = -1;
+    lSystem.resetStream();
+}
+
+AlgorithmicEvent AlgorithmicEngine::nextEvent()
+{
+    AlgorithmicEvent event;
+
+    switch (currentType)
+    {
+        case Markov:
+        {
+            // Rest until the previous event's inter-onset interval has elapsed
+            if (stepsUntilNextEvent > 0)
+            {
+                --stepsUntilNextEvent;
+                break;
+            }
+
+            const auto markovEvent = generateMarkovEvent();
+            event.pitch = markovEvent.pitch;
+            event.velocity = markovEvent.velocity;
+            event.durationSteps = static_cast<float>(juce::jmax(1, markovEvent.interOnsetSteps));
+            stepsUntilNextEvent = juce::jmax(1, markovEvent.interOnsetSteps) - 1;
+            break;
+        }
+
+        case LSystem:
+        {
+            if (stepsUntilNextEvent > 0)
+            {
+                --stepsUntilNextEvent;
+                break;
+            }
+
+            // Parametric durations also set the distance to the next note
+            const auto note = lSystem.nextEvent();
+            event.pitch = note.pitch;
+            event.velocity = note.velocity;
+            event.durationSteps = note.durationSteps;
+            stepsUntilNextEvent = juce::jmax(1, juce::roundToInt(note.durationSteps)) - 1;
+            break;
+        }
+
+        case CellularAutomatonType:
+        {
+            // Read one cell per tick; a new generation starts when the column wraps
+            if (cellularColumn == 0)
+                cellularAutomaton.step();
+
+            if (cellularAutomaton.getCell(cellularColumn))
+            {
+                event.pitch = 60 + (cellularColumn % 24);
+                event.velocity = probabilistic.generateVelocity(velocityMean, velocityVariance);
+            }
+
+            cellularColumn = (cellularColumn + 1) % cellularAutomaton.getSize();
+            break;
+        }
+
+        case Life:
+        {
+            std::array<int, LifeAutomaton::numRows> voices;
+            if (generateLifeVoices(voices.data(), 1) > 0)
+            {
+                event.pitch = voices[0];
+                event.velocity = probabilistic.generateVelocity(velocityMean, velocityVariance);
+            }
+            break;
+        }
+
+        case Probabilistic:
+        default:
+        {
+            melodyNote = probabilistic.nextMelodyNote(melodyNote, pitchMin, pitchMax);
+            event.pitch = melodyNote;
+            event.velocity = probabilistic.generateVelocity(velocityMean, velocityVariance);
+            break;
+        }
+    }
+
+    return event;
 }
 
 void AlgorithmicEngine::setPitchRange(int minPitch, int maxPitch)
@@ -383,6 +1644,53 @@ void AlgorithmicEngine::setVelocityRange(float minVel, float maxVel)
     velocityVariance = (maxVel - minVel) / 4.0f; // Keep most values within range
 }
 
+MarkovEvent AlgorithmicEngine::generateMarkovEvent()
+{
+    if (variableMarkov.isTrained())
+    {
+        int token = variableMarkov.generateToken(tokenHistory);
+        if (token >= 0)
+        {
+            tokenHistory.push(token);
+            return JointToken::decode(token);
+        }
+    }
+
+    // Fixed-order pitch chain
+    int order = markovChain.getOrder();
+
+    // Initialize history
+    for (int i = noteHistory.size(); i < order; ++i)
+        noteHistory.push(60 + (i % 12));
+
+    MarkovEvent event;
+    event.pitch = markovChain.generate(noteHistory);
+    event.velocity = probabilistic.generateVelocity(velocityMean, velocityVariance);
+    noteHistory.push(event.pitch);
+    return event;
+}
+
+int AlgorithmicEngine::generateLifeVoices(int* pitches, int maxVoices)
+{
+    lifeAutomaton.step();
+
+    if (lifeAutomaton.isEmpty())
+        lifeAutomaton.randomize();
+
+    const int column = lifeColumn;
+    lifeColumn = (lifeColumn + 1) % LifeAutomaton::numColumns;
+
+    int numVoices = 0;
+    const int lowest = juce::jlimit(0, LifeAutomaton::numRows - 1, pitchMin);
+    const int highest = juce::jlimit(0, LifeAutomaton::numRows - 1, pitchMax);
+
+    for (int row = lowest; row <= highest && numVoices < maxVoices; ++row)
+        if ((lifeAutomaton.getBirths(row) >> column) & 1)
+            pitches[numVoices++] = row;
+
+    return numVoices;
+}
+
 std::vector<int> AlgorithmicEngine::generateNoteSequence(int length)
 {
     std::vector<int> sequence;
@@ -391,51 +1699,25 @@ std::vector<int> AlgorithmicEngine::generateNoteSequence(int length)
     {
         case Markov:
         {
-            int order = markovChain.getOrder();
-
-            if (noteHistory.size() < order)
-            {
-                // Initialize history
-                for (int i = 0; i < length && noteHistory.size() < order; ++i)
-                {
-                    int note = 60 + (i % 12);
-                    noteHistory.push_back(note);
-                }
-            }
-
             for (int i = 0; i < length; ++i)
-            {
-                std::vector<int> state;
-                if (noteHistory.size() >= order)
-                    state = std::vector<int>(noteHistory.end() - order, noteHistory.end());
-                else
-                    state = std::vector<int>(noteHistory.begin(), noteHistory.end());
-
-                int note = markovChain.generate(state);
-                sequence.push_back(note);
-                noteHistory.push_back(note);
-
-                if (noteHistory.size() > 100)
-                    noteHistory.pop_front();
-            }
+                sequence.push_back(generateMarkovEvent().pitch);
             break;
         }
 
         case LSystem:
         {
-            auto lstring = lSystem.iterate(3);
-            sequence = lSystem.toMidiNotes(lstring, 60);
-            if (sequence.size() > length)
-                sequence.resize(length);
+            for (int i = 0; i < length; ++i)
+                sequence.push_back(lSystem.nextNote());
             break;
         }
 
         case CellularAutomatonType:
         {
-            auto state = cellularAutomaton.step();
-            for (size_t i = 0; i < std::min(state.size(), static_cast<size_t>(length)); ++i)
+            cellularAutomaton.step();
+            const int numCells = std::min(cellularAutomaton.getSize(), length);
+            for (int i = 0; i < numCells; ++i)
             {
-                if (state[i])
+                if (cellularAutomaton.getCell(i))
                     sequence.push_back(60 + (i % 24));
                 else
                     sequence.push_back(-1); // Rest
@@ -443,6 +1725,18 @@ std::vector<int> AlgorithmicEngine::generateNoteSequence(int length)
             break;
         }
 
+        case Life:
+        {
+            // One generation; births in the play column, or a rest
+            std::array<int, LifeAutomaton::numRows> voices;
+            const int numVoices = generateLifeVoices(voices.data(), juce::jmax(1, length));
+            for (int i = 0; i < numVoices; ++i)
+                sequence.push_back(voices[static_cast<size_t>(i)]);
+            if (sequence.empty())
+                sequence.push_back(-1);
+            break;
+        }
+
         case Probabilistic:
         default:
         {
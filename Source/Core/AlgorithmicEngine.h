@@ -11,28 +11,282 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "../DSP/SnapshotPublisher.h"
+#include "MarkovModelFile.h"
+#include "LSystemCompiler.h"
 #include <vector>
 #include <map>
-#include <deque>
+#include <array>
+#include <atomic>
+#include <string>
+
+// ============================================================================
+// Note History Ring
+// ============================================================================
+/**
+ * Fixed-size history of the most recent values (no allocation on push)
+ */
+class NoteHistoryRing
+{
+public:
+    static constexpr int capacity = 8;
+
+    void push(int value)
+    {
+        values[static_cast<size_t>(head)] = value;
+        head = (head + 1) & (capacity - 1);
+        count = juce::jmin(count + 1, capacity);
+    }
+
+    // ago = 0 is the most recent value
+    int getRecent(int ago) const
+    {
+        return values[static_cast<size_t>((head - 1 - ago) & (capacity - 1))];
+    }
+
+    int size() const { return count; }
+    void clear() { head = 0; count = 0; }
+
+private:
+    std::array<int, capacity> values {};
+    int head = 0;
+    int count = 0;
+};
 
 // ============================================================================
 // Markov Chain Generator
 // ============================================================================
+/**
+ * Compiled Markov model (immutable once published).
+ * States are packed into a 64-bit key (7 bits per note plus the order) and
+ * stored in an open-addressing hash table; each state owns an alias table.
+ */
+struct MarkovModel
+{
+    struct AliasEntry
+    {
+        int value = 60;
+        float probability = 1.0f;   // Chance of keeping this column's value
+        int alias = 0;              // Column index used otherwise
+    };
+
+    struct StateSlot
+    {
+        juce::uint64 key = 0;       // 0 = empty (packed keys always carry the order)
+        int firstEntry = 0;
+        int numEntries = 0;
+    };
+
+    std::vector<StateSlot> stateTable;      // Power-of-two size, load factor <= 0.5
+    std::vector<AliasEntry> aliasEntries;   // All states' alias tables, back to back
+    int order = 1;
+    int numStates = 0;
+
+    // Memory-mapped model file; sampled for states the hash table does not hold,
+    // so learned or edited transitions layer over a trained model
+    std::shared_ptr<juce::MemoryMappedFile> mappedFile;
+    const MarkovModelFile::Header* mappedHeader = nullptr;
+
+    const StateSlot* findState(juce::uint64 key) const;
+    const MarkovModelFile::StateRecord* findMappedState(juce::uint64 key) const;
+};
+
+/**
+ * N-gram Markov model over MIDI note numbers (0-127), orders 1-8.
+ * Edits go to a weight table and are compiled into a MarkovModel that is
+ * published to the audio thread, so generate() is one hash probe plus one
+ * O(1) draw, never allocates and never waits on an edit or on training.
+ */
 class MarkovChain
 {
 public:
+    static constexpr int maxOrder = NoteHistoryRing::capacity;
+    static constexpr int defaultNote = 60;
+
+    using WeightTable = std::map<juce::uint64, std::map<int, float>>;
+
     MarkovChain(int order = 1);
 
+    // Editing (any non-audio thread); learn() compiles, addTransition() needs compile()
     void addTransition(const std::vector<int>& state, int nextValue, float probability = 1.0f);
     void learn(const std::vector<int>& sequence);
-    int generate(const std::vector<int>& currentState);
+    void compile();
+
+    /**
+     * Replace the live-learned transitions (MarkovLearner) and compile. They are
+     * kept apart from the edited ones: a state present in both samples an equal
+     * blend of the two normalized distributions, so learning refines edits
+     * rather than discarding them.
+     */
+    void replaceLearnedTransitions(WeightTable weights);
+
+    /**
+     * Memory-map a trained model file (see MarkovCorpusTrainer) and sample from it
+     * directly. Also sets the order and clears the edited transitions (and the
+     * learned ones if the order changes). Later edits are layered over it: a
+     * state present in both uses the edited transitions. reset() and
+     * setOrder() unload it.
+     */
+    bool loadModelFile(const juce::File& modelFile);
+    bool hasModelFile() const;
     void reset();
     void setOrder(int newOrder);
-    int getOrder() const { return order; }
+    int getOrder() const { return order.load(std::memory_order_relaxed); }
+    int getNumStates() const;
+
+    // Generation (audio thread)
+    int generate(const std::vector<int>& currentState);
+    int generate(const int* stateValues, int stateLength);
+    int generate(const NoteHistoryRing& history);
+
+    // Audio thread: acknowledge the newest model so superseded ones can be freed
+    // even while nothing generates from this chain
+    void acknowledge() noexcept { publisher.acquire(); }
+
+    // Key packing: the oldest value occupies the highest bits
+    static juce::uint64 packState(const int* stateValues, int stateLength);
+
+    // Vose's alias method: fills one probability and alias column per weight
+    static void buildAliasTable(const std::vector<float>& weights,
+                                std::vector<float>& probabilities,
+                                std::vector<int>& aliases);
+
+private:
+    static juce::uint64 hashKey(juce::uint64 key);
+    void compileLocked();
+    int sampleState(const MarkovModel& model, juce::uint64 key);
+
+    std::atomic<int> order;
+
+    // Edit side, guarded by writeLock (the audio thread never takes it)
+    juce::CriticalSection writeLock;
+    WeightTable transitionWeights;
+    WeightTable learnedWeights;
+    std::shared_ptr<juce::MemoryMappedFile> mappedModelFile;
+    const MarkovModelFile::Header* modelFileHeader = nullptr;
+    SnapshotPublisher<MarkovModel> publisher;
+
+    juce::Random random;
+
+    friend struct MarkovModel;
+};
+
+// ============================================================================
+// Variable-Order Markov (PPM back-off)
+// ============================================================================
+/**
+ * A generated or learned note event: pitch, inter-onset interval and velocity
+ */
+struct MarkovEvent
+{
+    int pitch = 60;
+    int interOnsetSteps = 1;        // 16th-note steps until the next event (1-16)
+    float velocity = 0.7f;
+};
+
+/**
+ * Joint (pitch, IOI, velocity bucket) tokens packed into 14 bits
+ */
+namespace JointToken
+{
+    static constexpr int numVelocityBuckets = 8;
+    static constexpr int maxInterOnsetSteps = 16;
+
+    inline int encode(const MarkovEvent& event)
+    {
+        int pitch = juce::jlimit(0, 127, event.pitch);
+        int ioi = juce::jlimit(1, maxInterOnsetSteps, event.interOnsetSteps) - 1;
+        int velocity = juce::jlimit(0, numVelocityBuckets - 1,
+                                    static_cast<int>(event.velocity * numVelocityBuckets));
+        return pitch | (ioi << 7) | (velocity << 11);
+    }
+
+    inline MarkovEvent decode(int token)
+    {
+        MarkovEvent event;
+        event.pitch = token & 0x7f;
+        event.interOnsetSteps = ((token >> 7) & 0x0f) + 1;
+        event.velocity = ((token >> 11) + 0.5f) / numVelocityBuckets;
+        return event;
+    }
+}
+
+/**
+ * Context trie for the variable-order model (immutable once published).
+ * Node 0 is the empty context; a child extends its parent's context one
+ * token further into the past, so contexts share their recent suffix.
+ */
+struct ContextTrie
+{
+    struct Node
+    {
+        std::vector<std::pair<juce::uint16, juce::uint32>> children;   // (older token, node), sorted
+        std::vector<std::pair<juce::uint16, juce::uint32>> counts;     // (next token, count), sorted
+        juce::uint32 total = 0;
+    };
+
+    std::vector<Node> nodes { Node{} };
+
+    int findChild(int nodeIndex, int token) const;
+};
+
+/**
+ * PPM-style variable-order Markov model over joint note tokens.
+ * Generation walks the current context down the trie (at most maxOrder
+ * steps) and backs off to shorter contexts using the PPM-C escape estimate,
+ * ending at the order-0 distribution instead of a fixed fallback note.
+ */
+class VariableOrderMarkov
+{
+public:
+    static constexpr int maxOrder = NoteHistoryRing::capacity;
+    static constexpr int defaultMaxNodes = 1 << 16;
+
+    VariableOrderMarkov();
+
+    // Training (any non-audio thread); each call publishes a new trie.
+    // The first numContextEvents events only provide context for the rest,
+    // so a stream can be learned in chunks without losing its transitions.
+    // The trie is double-buffered: once the audio thread has moved on, the
+    // previously published trie is reused and only the last chunk is
+    // replayed into it, so a chunk costs its own size rather than a copy of
+    // the whole trie.
+    void learn(const std::vector<MarkovEvent>& events, int numContextEvents = 0);
+    void learn(const std::vector<std::vector<MarkovEvent>>& sequences);
+    void reset();
+    void setMaxOrder(int newOrder);
+    int getMaxOrder() const { return order.load(std::memory_order_relaxed); }
+    void setMaxNodes(int nodes) { maxNodes = juce::jmax(1, nodes); }
+    int getNumNodes() const;
+
+    // Generation (audio thread, allocation-free)
+    bool isTrained() const { return trained.load(std::memory_order_relaxed); }
+    int generateToken(const NoteHistoryRing& tokenHistory);
+
+    // Audio thread: acknowledge the newest trie (see MarkovChain::acknowledge)
+    void acknowledge() noexcept { publisher.acquire(); }
 
 private:
-    int order;
-    std::map<std::vector<int>, std::map<int, float>> transitionTable;
+    struct Chunk
+    {
+        std::vector<MarkovEvent> events;
+        int numContextEvents = 0;
+    };
+
+    void learnLocked(ContextTrie& trie, const std::vector<MarkovEvent>& events, int numContextEvents) const;
+    void publishChunksLocked(std::vector<Chunk> chunks);
+
+    std::atomic<int> order { 4 };
+    std::atomic<bool> trained { false };
+    int maxNodes = defaultMaxNodes;
+
+    juce::CriticalSection writeLock;
+    SnapshotPublisher<ContextTrie> publisher;
+
+    // What the latest trie holds beyond the one published before it
+    std::vector<Chunk> lastPublishedChunks;
+    bool resetSincePrevious = false;
+
     juce::Random random;
 };
 
@@ -46,9 +300,32 @@ struct LSystemRule
     float probability = 1.0f;
 };
 
+/**
+ * A note produced by interpreting an L-System module
+ */
+struct LSystemNote
+{
+    int pitch = -1;                 // -1 = no note
+    float durationSteps = 1.0f;     // First module parameter, in 16th-note steps
+    float velocity = 0.8f;          // Second module parameter (0.0-1.0)
+};
+
 class LSystemEngine
 {
 public:
+    static constexpr int maxGenerations = 32;
+    static constexpr int maxSymbolsPerNote = 256;   // Bound on non-note symbols skipped per note
+
+    enum class SymbolAction : juce::uint8
+    {
+        None,
+        Note,           // Emit currentNote + interval
+        OctaveUp,
+        OctaveDown,
+        SemitoneUp,
+        SemitoneDown
+    };
+
     LSystemEngine();
 
     void setAxiom(const juce::String& axiom);
@@ -57,10 +334,89 @@ public:
     juce::String iterate(int generations);
     std::vector<int> toMidiNotes(const juce::String& sequence, int baseNote = 60);
 
+    //==============================================================================
+    // Parametric and context-sensitive rules, compiled when added.
+    // Example: addParametricRule("A(d, v)", "A(d / 2, v) B(d, v * 0.9)", 1.0f, "B", "", "d > 0.25")
+
+    bool setParametricAxiom(const juce::String& axiom);
+    bool addParametricRule(const juce::String& predecessor, const juce::String& successor,
+                           float probability = 1.0f,
+                           const juce::String& leftContext = {}, const juce::String& rightContext = {},
+                           const juce::String& condition = {});
+    const juce::String& getLastError() const { return lastError; }
+
+    // Symbol interpretation (jump table indexed by symbol)
+    void setSymbolAction(char symbol, SymbolAction action, int interval = 0);
+
+    //==============================================================================
+    // Streaming expansion: walks the rewrite tree depth-first with an explicit
+    // stack of at most generations + 1 frames, so memory and per-note cost do
+    // not grow with the (exponential) length of the expanded string.
+
+    void setGenerations(int generations);
+    int getGenerations() const { return streamGenerations; }
+    void setBaseNote(int note);
+
+    /** Restart the stream at the beginning of the axiom. */
+    void resetStream();
+
+    /** Next module of the expansion (loops back to the axiom when finished); false if empty. */
+    bool nextModule(LSystemModule& module);
+
+    /** Next symbol of the expansion; 0 if empty. */
+    char nextSymbol();
+
+    /** Next note event, applying octave/semitone symbols; pitch is -1 if none was found. */
+    LSystemNote nextEvent();
+
+    /** Pitch of the next note event; -1 if none was found. */
+    int nextNote() { return nextEvent().pitch; }
+
 private:
+    struct StreamFrame
+    {
+        const CompiledLSystemRule* rule = nullptr;
+        int position = 0;
+        int generation = 0;
+        std::array<float, LSystemBytecode::maxParams> params {};   // Bound predecessor parameters
+    };
+
+    struct ActionEntry
+    {
+        SymbolAction action = SymbolAction::None;
+        int interval = 0;
+    };
+
+    const CompiledLSystemRule* chooseRule(const LSystemModule& module, int level, int index);
+
+    /**
+     * Symbol beside the module at stack[level] successor [index], in the same
+     * generation. At the edge of a replacement the neighbour is found in an
+     * enclosing replacement and rewritten down to that generation, following
+     * its edge facing the module. Exact while those rewrites are deterministic;
+     * a stochastic, conditional-on-context or deleting rewrite stops the
+     * descent and its older form is used instead (an approximation).
+     */
+    char neighbourSymbol(int level, int index, int direction) const;
+    char expandedEdgeSymbol(LSystemModule module, int generations, int direction) const;
+    const CompiledLSystemRule* deterministicRule(const LSystemModule& module, bool& ambiguous) const;
+
     juce::String axiom;
     std::map<char, std::vector<LSystemRule>> rules;
     juce::Random random;
+    juce::String lastError;
+
+    // Compiled productions, indexed by predecessor symbol
+    CompiledLSystemRule compiledAxiom;
+    std::array<std::vector<CompiledLSystemRule>, 128> compiledRules;
+    std::array<ActionEntry, 128> actions;
+
+    // Stream state
+    std::array<StreamFrame, maxGenerations + 1> stack;
+    int stackSize = 0;
+    int streamGenerations = 3;
+    int baseNote = 60;
+    int currentNote = 60;
 };
 
 // ============================================================================
@@ -69,22 +425,114 @@ private:
 class CellularAutomaton
 {
 public:
+    static constexpr int maxCells = 4096;
+    static constexpr int historyDepth = 128;    // Past generations kept for visualization
+
     CellularAutomaton(int size = 32);
 
+    void setSize(int numCells);                 // 1-4096 cells; resets the history
+    int getSize() const { return numCells; }
+
     void setRule(int ruleNumber); // Wolfram rule (0-255)
     void setState(const std::vector<bool>& initialState);
     void randomizeState(float density = 0.5f);
-    std::vector<bool> step();
-    std::vector<bool> getState() const { return cells; }
+    void step();
     void reset();
 
+    bool getCell(int index) const;
+    std::vector<bool> getState() const;         // Allocates; for editors and presets
+
+    //==============================================================================
+    // History: 0 = current generation. Rows are packed 64 cells per word,
+    // cell i at bit (i % 64) of word (i / 64).
+
+    int getHistorySize() const { return historyCount; }
+    int getNumWords() const { return numWords; }
+    const juce::uint64* getHistoryRow(int generationsAgo) const;
+    bool getHistoryCell(int generationsAgo, int index) const;
+
 private:
-    std::vector<bool> cells;
+    juce::uint64* row(int slot) { return history.data() + static_cast<size_t>(slot) * static_cast<size_t>(numWords); }
+    const juce::uint64* currentRow() const { return history.data() + static_cast<size_t>(head) * static_cast<size_t>(numWords); }
+    juce::uint64 lastWordMask() const;
+    void restart(const std::vector<juce::uint64>& words);
+
+    int numCells = 32;
+    int numWords = 1;
     int rule = 30; // Default to Rule 30
-    std::vector<bool> initialState;
+
+    // Rule bit k as an all-ones or all-zero word, k = left * 4 + center * 2 + right
+    std::array<juce::uint64, 8> ruleMasks {};
+
+    std::vector<juce::uint64> history;          // historyDepth rows of numWords
+    int head = 0;
+    int historyCount = 1;
+
+    std::vector<juce::uint64> initialState;
     juce::Random random;
+};
+
+// ============================================================================
+// Life-like 2D Cellular Automaton
+// ============================================================================
+/**
+ * Toroidal grid of 128 rows (MIDI pitches) by 64 columns (steps), one 64-bit
+ * word per row with column c at bit c. A generation is computed a whole row
+ * at a time: neighbour counts are summed with bit-sliced adders and compared
+ * against the B/S rule, so stepping costs a few hundred word operations.
+ */
+class LifeAutomaton
+{
+public:
+    static constexpr int numRows = 128;
+    static constexpr int numColumns = 64;
+
+    LifeAutomaton();
+
+    // Rule in B/S notation, e.g. "B3/S23" (Conway) or "B36/S23" (HighLife)
+    bool setRule(const juce::String& ruleString);
+    void setRule(juce::uint16 birthCounts, juce::uint16 survivalCounts);   // Bit n = n neighbours
+    juce::String getRuleString() const;
+
+    void clear();
+    void randomize(float density = 0.25f);
+    void setCell(int row, int column, bool alive);
+    bool getCell(int row, int column) const;
+
+    void step();
+
+    juce::uint64 getRow(int row) const;
+    juce::uint64 getBirths(int row) const;      // Cells that became alive in the last step
+    bool isEmpty() const;
+    juce::int64 getGeneration() const { return generation; }
+
+private:
+    std::array<juce::uint64, numRows> cells {};
+    std::array<juce::uint64, numRows> previous {};
+
+    // Per-row horizontal sums of (left, centre, right), bit-sliced, with one
+    // wrapped row of padding at each end so the row loops have no edge cases
+    std::array<juce::uint64, numRows + 2> rowSumLow {};
+    std::array<juce::uint64, numRows + 2> rowSumHigh {};
+
+    // Neighbour count (0-8) of every cell as four bit planes
+    std::array<juce::uint64, numRows> count1 {}, count2 {}, count4 {}, count8 {};
+
+    // Compiled rule: only neighbour counts that can produce a live cell
+    struct CountTerm
+    {
+        std::array<juce::uint64, 4> countBits {};   // Bits of the count as all-ones/all-zero words
+        juce::uint64 whenDead = 0;              // All ones if the count gives birth
+        juce::uint64 whenAlive = 0;             // All ones if the count survives
+    };
+
+    std::array<CountTerm, 9> terms {};
+    int numTerms = 0;
+    juce::uint16 birthMask = 0;
+    juce::uint16 survivalMask = 0;
 
-    bool applyRule(bool left, bool center, bool right);
+    juce::int64 generation = 0;
+    juce::Random random;
 };
 
 // ============================================================================
@@ -99,11 +547,28 @@ public:
     int generateNote(int center, int range, const std::vector<float>& weights);
     float generateVelocity(float mean = 0.7f, float variance = 0.2f);
 
+    // Note weights (offsets -range..range from the centre) compiled to an alias
+    // table; generateNote(weights) rebuilds it only when the weights change
+    void setNoteWeights(const std::vector<float>& weights);
+    int generateNote(int center, int range);
+
     // Pattern generation
     std::vector<int> generateScale(int root, const std::vector<int>& intervals);
     std::vector<int> generateMelody(int length, int minNote, int maxNote, float stepProbability = 0.6f);
+
+    // One step of the melody walk; pass -1 to start on a random note
+    int nextMelodyNote(int currentNote, int minNote, int maxNote, float stepProbability = 0.6f);
     std::vector<bool> generateRhythm(int length, float density, float grouping = 1.0f);
 
+    //==============================================================================
+    // Batch generation into caller-provided buffers (no allocation)
+
+    void generateNotes(int* destination, int numNotes, int center, int range);
+    void generateVelocities(float* destination, int numValues, float mean = 0.7f, float variance = 0.2f);
+    void generateMelody(int* destination, int length, int minNote, int maxNote, float stepProbability = 0.6f);
+    void generateRhythm(bool* destination, int length, float density, float grouping = 1.0f);
+    void generateGaussian(float* destination, int numValues, float mean, float stddev);
+
     // Brownian motion / random walk
     int randomWalk(int current, int step, int minValue, int maxValue);
     float randomWalkFloat(float current, float step, float minValue, float maxValue);
@@ -111,12 +576,28 @@ public:
 private:
     juce::Random random;
 
+    // Cached alias table for the note weights
+    std::vector<float> noteWeights;
+    std::vector<float> aliasProbabilities;
+    std::vector<int> aliasIndices;
+
     float gaussianRandom(float mean, float stddev);
+    float standardNormal();
 };
 
 // ============================================================================
 // Main Algorithmic Engine
 // ============================================================================
+/**
+ * One 16th-note step from the selected generator
+ */
+struct AlgorithmicEvent
+{
+    int pitch = -1;                 // -1 = rest
+    float velocity = 0.7f;          // 0.0-1.0
+    float durationSteps = 1.0f;     // Note length in 16th-note steps
+};
+
 class AlgorithmicEngine
 {
 public:
@@ -125,7 +606,8 @@ public:
         Markov,
         LSystem,
         CellularAutomatonType,
-        Probabilistic
+        Probabilistic,
+        Life
     };
 
     AlgorithmicEngine();
@@ -139,8 +621,43 @@ public:
     MarkovChain& getMarkovChain() { return markovChain; }
     LSystemEngine& getLSystem() { return lSystem; }
     CellularAutomaton& getCellularAutomaton() { return cellularAutomaton; }
+    LifeAutomaton& getLifeAutomaton() { return lifeAutomaton; }
     ProbabilisticGenerator& getProbabilistic() { return probabilistic; }
 
+    VariableOrderMarkov& getVariableOrderMarkov() { return variableMarkov; }
+
+    // Next Markov event: variable-order joint model once trained, otherwise the fixed-order pitch chain
+    MarkovEvent generateMarkovEvent();
+
+    /**
+     * Audio thread, once per block: acknowledge the newest Markov models.
+     * Learning publishes new models whether or not Markov ticks read them,
+     * and superseded models are only freed once a newer one is acknowledged.
+     */
+    void acknowledgeModels() noexcept
+    {
+        markovChain.acknowledge();
+        variableMarkov.acknowledge();
+    }
+
+    /**
+     * Advance the selected generator by one 16th-note step and return its event.
+     * Each generator keeps a cursor so a tick costs O(1): Markov history and
+     * inter-onset wait, L-System traversal position, CA generation and column,
+     * and the probabilistic melody walk.
+     */
+    AlgorithmicEvent nextEvent();
+
+    // Restart every cursor (also done when the generator type changes)
+    void resetCursors();
+
+    /**
+     * Advance the Life grid one generation and move the play column one step.
+     * Writes the pitches (rows within the pitch range) born in the play column,
+     * lowest first; returns how many were written. Reseeds the grid if it dies out.
+     */
+    int generateLifeVoices(int* pitches, int maxVoices);
+
     // Generate sequence
     std::vector<int> generateNoteSequence(int length);
     std::vector<bool> generateRhythmSequence(int length);
@@ -154,11 +671,20 @@ private:
     GeneratorType currentType = Probabilistic;
 
     MarkovChain markovChain;
+    VariableOrderMarkov variableMarkov;
     LSystemEngine lSystem;
     CellularAutomaton cellularAutomaton;
+    LifeAutomaton lifeAutomaton;
+    int lifeColumn = 0;
+
+    // Per-tick cursors
+    int stepsUntilNextEvent = 0;    // Markov / L-System wait for the current event's length
+    int cellularColumn = 0;
+    int melodyNote = -1;
     ProbabilisticGenerator probabilistic;
 
-    std::deque<int> noteHistory;
+    NoteHistoryRing noteHistory;
+    NoteHistoryRing tokenHistory;
 
     // Parameter ranges
     int pitchMin = 48;
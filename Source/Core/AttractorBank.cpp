@@ -0,0 +1,340 @@
+#include "AttractorBank.h"
+
+namespace
+{
+    // Polynomial sine (|error| < 4e-6) that vectorises, unlike std::sin
+    inline float fastSin(float x)
+    {
+        constexpr float pi = 3.14159265358979f;
+        constexpr float twoPi = 2.0f * pi;
+
+        // Reduce to [-pi, pi], then fold into [-pi/2, pi/2] using sin(x) = sin(pi - x)
+        const float turns = static_cast<float>(static_cast<int>(x * (1.0f / twoPi) + std::copysign(0.5f, x)));
+        x -= turns * twoPi;
+        x = std::copysign(0.5f * pi - std::abs(std::abs(x) - 0.5f * pi), x);
+
+        const float x2 = x * x;
+        return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f)))));
+    }
+
+    struct SystemInfo
+    {
+        std::array<float, AttractorBank::maxParameters> defaults;
+        std::array<float, 3> initial;
+        std::array<float, 3> lower;     // Typical bounds used for normalisation
+        std::array<float, 3> upper;
+    };
+
+    const SystemInfo& getSystemInfo(AttractorBank::System system)
+    {
+        static const std::array<SystemInfo, AttractorBank::numSystems> info = {{
+            // Lorenz: sigma, rho, beta
+            { { 10.0f, 28.0f, 8.0f / 3.0f, 0.0f }, { 0.1f, 0.0f, 0.0f },
+              { -20.0f, -27.0f, 0.0f }, { 20.0f, 27.0f, 50.0f } },
+            // Rossler: a, b, c
+            { { 0.2f, 0.2f, 5.7f, 0.0f }, { 0.1f, 0.0f, 0.0f },
+              { -10.0f, -11.0f, 0.0f }, { 12.0f, 8.0f, 23.0f } },
+            // Thomas: b (dissipation)
+            { { 0.19f, 0.0f, 0.0f, 0.0f }, { 0.1f, 0.0f, -0.1f },
+              { -4.5f, -4.5f, -4.5f }, { 4.5f, 4.5f, 4.5f } },
+            // Henon: a, b
+            { { 1.4f, 0.3f, 0.0f, 0.0f }, { 0.1f, 0.0f, 0.0f },
+              { -1.3f, -0.4f, 0.0f }, { 1.3f, 0.4f, 1.0f } },
+            // Chua: alpha, beta, m0, m1
+            { { 15.6f, 28.0f, -1.143f, -0.714f }, { 0.7f, 0.0f, 0.0f },
+              { -2.5f, -0.5f, -4.0f }, { 2.5f, 0.5f, 4.0f } }
+        }};
+
+        return info[static_cast<size_t>(system)];
+    }
+}
+
+AttractorBank::AttractorBank()
+{
+    clearVoices();
+}
+
+// ============================================================================
+// Voice Management
+// ============================================================================
+
+int AttractorBank::addVoice(System system)
+{
+    if (numVoices >= maxVoices)
+        return -1;
+
+    const int s = static_cast<int>(system);
+    const int insertAt = groupStart[static_cast<size_t>(s + 1)];
+
+    // Shift later groups up one lane to keep voices grouped by system
+    for (int p = numVoices; p > insertAt; --p)
+    {
+        const auto to = static_cast<size_t>(p), from = static_cast<size_t>(p - 1);
+        x[to] = x[from];
+        y[to] = y[from];
+        z[to] = z[from];
+        systems[to] = systems[from];
+        for (auto& lane : params)
+            lane[to] = lane[from];
+
+        positionVoice[to] = positionVoice[from];
+        voicePosition[static_cast<size_t>(positionVoice[to])] = p;
+    }
+
+    for (int g = s + 1; g <= numSystems; ++g)
+        ++groupStart[static_cast<size_t>(g)];
+
+    const int voiceId = numVoices++;
+    voicePosition[static_cast<size_t>(voiceId)] = insertAt;
+    positionVoice[static_cast<size_t>(insertAt)] = voiceId;
+    setDefaults(insertAt, system);
+
+    return voiceId;
+}
+
+void AttractorBank::clearVoices()
+{
+    numVoices = 0;
+    groupStart.fill(0);
+    pendingTime = 0.0;
+    substepCount = 0;
+}
+
+void AttractorBank::setDefaults(int position, System system)
+{
+    const auto p = static_cast<size_t>(position);
+    const auto& info = getSystemInfo(system);
+
+    systems[p] = system;
+    for (size_t i = 0; i < params.size(); ++i)
+        params[i][p] = info.defaults[i];
+
+    x[p] = info.initial[0];
+    y[p] = info.initial[1];
+    z[p] = info.initial[2];
+}
+
+int AttractorBank::positionOf(int voiceId) const
+{
+    if (voiceId < 0 || voiceId >= numVoices)
+        return -1;
+    return voicePosition[static_cast<size_t>(voiceId)];
+}
+
+void AttractorBank::setParameter(int voiceId, int parameterIndex, float value)
+{
+    const int position = positionOf(voiceId);
+    if (position < 0 || parameterIndex < 0 || parameterIndex >= maxParameters)
+        return;
+
+    params[static_cast<size_t>(parameterIndex)][static_cast<size_t>(position)] = value;
+}
+
+float AttractorBank::getParameter(int voiceId, int parameterIndex) const
+{
+    const int position = positionOf(voiceId);
+    if (position < 0 || parameterIndex < 0 || parameterIndex >= maxParameters)
+        return 0.0f;
+
+    return params[static_cast<size_t>(parameterIndex)][static_cast<size_t>(position)];
+}
+
+void AttractorBank::reset()
+{
+    for (int p = 0; p < numVoices; ++p)
+    {
+        const auto& info = getSystemInfo(systems[static_cast<size_t>(p)]);
+        x[static_cast<size_t>(p)] = info.initial[0];
+        y[static_cast<size_t>(p)] = info.initial[1];
+        z[static_cast<size_t>(p)] = info.initial[2];
+    }
+
+    pendingTime = 0.0;
+    substepCount = 0;
+}
+
+// ============================================================================
+// Integration
+// ============================================================================
+
+void AttractorBank::advance(double seconds)
+{
+    if (numVoices == 0 || seconds <= 0.0)
+        return;
+
+    pendingTime += seconds * speed;
+
+    // The small bias absorbs rounding in the accumulated time, so the same elapsed
+    // time gives the same substep count however it was split into calls
+    const auto wanted = static_cast<int64_t>(pendingTime / substep + 1.0e-6);
+    const int substeps = static_cast<int>(std::min<int64_t>(wanted, maxSubstepsPerAdvance));
+
+    // Carry the fractional remainder; drop time beyond the per-call bound
+    pendingTime = (wanted > maxSubstepsPerAdvance) ? 0.0 : pendingTime - wanted * substep;
+
+    for (int i = 0; i < substeps; ++i)
+    {
+        rk4Step();
+
+        if (++substepCount % henonSubstepsPerIteration == 0)
+            iterateHenon();
+    }
+}
+
+void AttractorBank::evaluate(const Lane& px, const Lane& py, const Lane& pz, Derivative& out) const
+{
+    // Lorenz
+    for (int i = groupStart[0]; i < groupStart[1]; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        const float sigma = params[0][v], rho = params[1][v], beta = params[2][v];
+        out.dx[v] = sigma * (py[v] - px[v]);
+        out.dy[v] = px[v] * (rho - pz[v]) - py[v];
+        out.dz[v] = px[v] * py[v] - beta * pz[v];
+    }
+
+    // Rossler
+    for (int i = groupStart[1]; i < groupStart[2]; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        const float a = params[0][v], b = params[1][v], c = params[2][v];
+        out.dx[v] = -py[v] - pz[v];
+        out.dy[v] = px[v] + a * py[v];
+        out.dz[v] = b + pz[v] * (px[v] - c);
+    }
+
+    // Thomas
+    for (int i = groupStart[2]; i < groupStart[3]; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        const float b = params[0][v];
+        out.dx[v] = fastSin(py[v]) - b * px[v];
+        out.dy[v] = fastSin(pz[v]) - b * py[v];
+        out.dz[v] = fastSin(px[v]) - b * pz[v];
+    }
+
+    // Henon is a map; it does not flow between iterations
+    for (int i = groupStart[3]; i < groupStart[4]; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        out.dx[v] = out.dy[v] = out.dz[v] = 0.0f;
+    }
+
+    // Chua (piecewise-linear diode)
+    for (int i = groupStart[4]; i < groupStart[5]; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        const float alpha = params[0][v], beta = params[1][v], m0 = params[2][v], m1 = params[3][v];
+        const float diode = m1 * px[v] + 0.5f * (m0 - m1) * (std::abs(px[v] + 1.0f) - std::abs(px[v] - 1.0f));
+        out.dx[v] = alpha * (py[v] - px[v] - diode);
+        out.dy[v] = px[v] - py[v] + pz[v];
+        out.dz[v] = -beta * py[v];
+    }
+}
+
+void AttractorBank::rk4Step()
+{
+    const float h = static_cast<float>(substep);
+    const float half = 0.5f * h;
+    const float sixth = h / 6.0f;
+
+    evaluate(x, y, z, k1);
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        stageX[v] = x[v] + half * k1.dx[v];
+        stageY[v] = y[v] + half * k1.dy[v];
+        stageZ[v] = z[v] + half * k1.dz[v];
+    }
+    evaluate(stageX, stageY, stageZ, k2);
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        stageX[v] = x[v] + half * k2.dx[v];
+        stageY[v] = y[v] + half * k2.dy[v];
+        stageZ[v] = z[v] + half * k2.dz[v];
+    }
+    evaluate(stageX, stageY, stageZ, k3);
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        stageX[v] = x[v] + h * k3.dx[v];
+        stageY[v] = y[v] + h * k3.dy[v];
+        stageZ[v] = z[v] + h * k3.dz[v];
+    }
+    evaluate(stageX, stageY, stageZ, k4);
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        x[v] += sixth * (k1.dx[v] + 2.0f * (k2.dx[v] + k3.dx[v]) + k4.dx[v]);
+        y[v] += sixth * (k1.dy[v] + 2.0f * (k2.dy[v] + k3.dy[v]) + k4.dy[v]);
+        z[v] += sixth * (k1.dz[v] + 2.0f * (k2.dz[v] + k3.dz[v]) + k4.dz[v]);
+    }
+}
+
+void AttractorBank::iterateHenon()
+{
+    for (int i = groupStart[3]; i < groupStart[4]; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        const float a = params[0][v], b = params[1][v];
+        const float nextX = 1.0f - a * x[v] * x[v] + y[v];
+        y[v] = b * x[v];
+        x[v] = nextX;
+
+        // Restart a voice that escaped to infinity (parameters outside the attractor basin)
+        if (!std::isfinite(x[v]) || std::abs(x[v]) > 1.0e3f)
+        {
+            x[v] = 0.1f;
+            y[v] = 0.0f;
+        }
+    }
+}
+
+// ============================================================================
+// Output
+// ============================================================================
+
+float AttractorBank::getState(int voiceId, int axis) const
+{
+    const int position = positionOf(voiceId);
+    if (position < 0)
+        return 0.0f;
+
+    const auto p = static_cast<size_t>(position);
+    switch (axis)
+    {
+        case 0:  return x[p];
+        case 1:  return y[p];
+        case 2:  return z[p];
+        default: return 0.0f;
+    }
+}
+
+void AttractorBank::setState(int voiceId, float newX, float newY, float newZ)
+{
+    const int position = positionOf(voiceId);
+    if (position < 0)
+        return;
+
+    const auto p = static_cast<size_t>(position);
+    x[p] = newX;
+    y[p] = newY;
+    z[p] = newZ;
+}
+
+float AttractorBank::getNormalised(int voiceId, int axis) const
+{
+    const int position = positionOf(voiceId);
+    if (position < 0 || axis < 0 || axis > 2)
+        return 0.5f;
+
+    const auto& info = getSystemInfo(systems[static_cast<size_t>(position)]);
+    const auto a = static_cast<size_t>(axis);
+    const float normalised = (getState(voiceId, axis) - info.lower[a]) / (info.upper[a] - info.lower[a]);
+    return std::clamp(normalised, 0.0f, 1.0f);
+}
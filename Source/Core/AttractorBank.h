@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * @class AttractorBank
+ * @brief Several chaotic systems integrated together with a fixed-substep RK4 integrator
+ *
+ * Supported systems:
+ * - Lorenz (sigma, rho, beta)
+ * - Rossler (a, b, c)
+ * - Thomas (b)
+ * - Henon map (a, b) - discrete, iterated at a fixed substep interval
+ * - Chua circuit (alpha, beta, m0, m1)
+ *
+ * Time is measured in attractor units: advance() converts elapsed seconds with
+ * the speed setting and runs a whole number of fixed substeps, carrying the
+ * remainder to the next call. The trajectory therefore depends only on elapsed
+ * time, not on how often advance() is called (tempo, block size).
+ *
+ * Voices are stored structure-of-arrays and kept grouped by system, so every RK4
+ * stage is one tight loop per system over its voices.
+ */
+class AttractorBank
+{
+public:
+    enum class System
+    {
+        Lorenz,
+        Rossler,
+        Thomas,
+        Henon,
+        Chua
+    };
+
+    static constexpr int numSystems = 5;
+    static constexpr int maxVoices = 16;
+    static constexpr int maxParameters = 4;
+
+    static constexpr double substep = 0.005;              // Attractor time per RK4 step
+    static constexpr int henonSubstepsPerIteration = 20;  // Henon map rate: 10 iterations per attractor second
+    static constexpr int maxSubstepsPerAdvance = 8192;    // Bounds one call; excess time is dropped
+
+    AttractorBank();
+
+    /**
+     * Add a voice running the given system with its default parameters.
+     * Voices are regrouped by system, so use the returned id (not an index).
+     * @return Voice id, or -1 if the bank is full
+     */
+    int addVoice(System system);
+    void clearVoices();
+    int getNumVoices() const { return numVoices; }
+
+    void setParameter(int voiceId, int parameterIndex, float value);
+    float getParameter(int voiceId, int parameterIndex) const;
+
+    // Attractor time units per second of elapsed time
+    void setSpeed(float unitsPerSecond) { speed = std::clamp(unitsPerSecond, 0.0f, 100.0f); }
+
+    // Restart every voice from its initial condition
+    void reset();
+
+    // Advance by elapsed seconds
+    void advance(double seconds);
+
+    // Raw state (attractor coordinates); axis 0-2 = x, y, z
+    float getState(int voiceId, int axis) const;
+    void setState(int voiceId, float newX, float newY, float newZ);
+
+    // State mapped to 0.0-1.0 using the system's typical bounds
+    float getNormalised(int voiceId, int axis) const;
+
+    // Substeps run so far (deterministic for a given sequence of elapsed times)
+    int64_t getSubstepCount() const { return substepCount; }
+
+private:
+    using Lane = std::array<float, maxVoices>;
+
+    struct Derivative
+    {
+        Lane dx {}, dy {}, dz {};
+    };
+
+    void evaluate(const Lane& x, const Lane& y, const Lane& z, Derivative& out) const;
+    void rk4Step();
+    void iterateHenon();
+
+    int positionOf(int voiceId) const;
+    void setDefaults(int position, System system);
+
+    // SoA state, grouped by system: voices of system s occupy [groupStart[s], groupStart[s + 1])
+    Lane x {}, y {}, z {};
+    std::array<Lane, maxParameters> params {};
+    std::array<System, maxVoices> systems {};
+    std::array<int, numSystems + 1> groupStart {};
+
+    // RK4 scratch
+    Lane stageX {}, stageY {}, stageZ {};
+    Derivative k1, k2, k3, k4;
+
+    // Voice id -> position in the lanes
+    std::array<int, maxVoices> voicePosition {};
+    std::array<int, maxVoices> positionVoice {};
+    int numVoices = 0;
+
+    float speed = 1.0f;
+    double pendingTime = 0.0;
+    int64_t substepCount = 0;
+};
@@ -10,13 +10,16 @@
 #include "EuclideanEngine.h"
 
 EuclideanEngine::EuclideanEngine()
+    : stepLanes(std::make_unique<EuclideanStepLanes>())
 {
+    pattern.reserve(maxSteps);
+    velocities.reserve(maxSteps);
     regeneratePattern();
 }
 
 void EuclideanEngine::setSteps(int numSteps)
 {
-    steps = juce::jlimit(1, 64, numSteps);
+    steps = juce::jlimit(1, maxSteps, numSteps);
     regeneratePattern();
 }
 
@@ -38,6 +41,22 @@ void EuclideanEngine::setAccentPattern(const std::vector<float>& accents)
     regeneratePattern();
 }
 
+void EuclideanEngine::applyPreparedPattern(int numSteps, int numPulses, int rot,
+                                           const std::vector<bool>& preparedPattern,
+                                           const std::vector<float>& preparedVelocities)
+{
+    steps = juce::jlimit(1, maxSteps, numSteps);
+    pulses = juce::jlimit(0, steps, numPulses);
+    rotation = rot % steps;
+
+    // Stays within the reserved capacity
+    jassert(preparedPattern.size() <= static_cast<size_t>(maxSteps));
+    const auto patternSize = std::min(preparedPattern.size(), static_cast<size_t>(maxSteps));
+    const auto velocitySize = std::min(preparedVelocities.size(), static_cast<size_t>(maxSteps));
+    pattern.assign(preparedPattern.begin(), preparedPattern.begin() + static_cast<std::ptrdiff_t>(patternSize));
+    velocities.assign(preparedVelocities.begin(), preparedVelocities.begin() + static_cast<std::ptrdiff_t>(velocitySize));
+}
+
 bool EuclideanEngine::getStep(int stepIndex) const
 {
     if (stepIndex < 0 || stepIndex >= pattern.size())
@@ -65,6 +84,85 @@ void EuclideanEngine::randomize(float density)
     regeneratePattern();
 }
 
+void EuclideanEngine::editStepLanes(const std::function<void(EuclideanStepLanes&)>& edit)
+{
+    auto next = stepLanes.copyLatest();
+    edit(*next);
+    stepLanes.publish(std::move(next));
+}
+
+void EuclideanEngine::setStepCondition(int stepIndex, juce::uint32 conditionFlags, int ratioA, int ratioB)
+{
+    editStepLanes([=](EuclideanStepLanes& lanes) {
+        lanes.conditions.setCondition(stepIndex, conditionFlags, ratioA, ratioB);
+    });
+}
+
+void EuclideanEngine::setStepProbability(int stepIndex, float probability)
+{
+    editStepLanes([=](EuclideanStepLanes& lanes) {
+        lanes.conditions.setProbability(stepIndex, probability);
+    });
+}
+
+void EuclideanEngine::setStepParameterLocks(int stepIndex, const StepParameterLocks& locks)
+{
+    editStepLanes([&](EuclideanStepLanes& lanes) {
+        lanes.conditions.setParameterLocks(stepIndex, locks);
+    });
+}
+
+void EuclideanEngine::clearStep(int stepIndex)
+{
+    editStepLanes([=](EuclideanStepLanes& lanes) {
+        lanes.conditions.clearStep(stepIndex);
+    });
+}
+
+void EuclideanEngine::clearStepConditions()
+{
+    editStepLanes([](EuclideanStepLanes& lanes) {
+        lanes.conditions.clear();
+    });
+}
+
+void EuclideanEngine::setStepNudge(int stepIndex, float fractionOfStep)
+{
+    editStepLanes([=](EuclideanStepLanes& lanes) {
+        lanes.microtiming.setNudge(stepIndex, fractionOfStep);
+    });
+}
+
+void EuclideanEngine::setStepNudgeTicks(int stepIndex, int ticks)
+{
+    editStepLanes([=](EuclideanStepLanes& lanes) {
+        lanes.microtiming.setNudgeTicks(stepIndex, ticks);
+    });
+}
+
+std::unique_ptr<juce::XmlElement> EuclideanEngine::stepLanesToXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>("EuclideanStepLanes");
+    xml->addChildElement(stepLanes.getLatest().conditions.toXml().release());
+    xml->addChildElement(stepLanes.getLatest().microtiming.toXml().release());
+    return xml;
+}
+
+void EuclideanEngine::stepLanesFromXml(const juce::XmlElement& xml)
+{
+    editStepLanes([&xml](EuclideanStepLanes& lanes) {
+        if (auto* conditionsXml = xml.getChildByName("StepConditions"))
+            lanes.conditions.fromXml(*conditionsXml);
+        else
+            lanes.conditions.clear();
+
+        if (auto* microtimingXml = xml.getChildByName("Microtiming"))
+            lanes.microtiming.fromXml(*microtimingXml);
+        else
+            lanes.microtiming.clear();
+    });
+}
+
 void EuclideanEngine::regeneratePattern()
 {
     generateEuclideanPattern();
@@ -73,17 +171,14 @@ void EuclideanEngine::regeneratePattern()
 void EuclideanEngine::generateEuclideanPattern()
 {
     // Generate base Euclidean pattern using Björklund's algorithm
-    pattern = bjorklund(pulses, steps);
+    // (copied in, so the reserved capacity is kept for applyPreparedPattern)
+    const auto generated = bjorklund(pulses, steps);
 
     // Apply rotation
-    if (rotation != 0)
+    pattern.resize(steps);
+    for (int i = 0; i < steps; ++i)
     {
-        std::vector<bool> rotated(steps);
-        for (int i = 0; i < steps; ++i)
-        {
-            rotated[i] = pattern[(i + rotation) % steps];
-        }
-        pattern = rotated;
+        pattern[i] = generated[(i + rotation) % steps];
     }
 
     // Generate velocities with accent pattern
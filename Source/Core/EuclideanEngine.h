@@ -5,14 +5,28 @@
     Euclidean rhythm generator using Björklund's algorithm
     Generates evenly-distributed rhythmic patterns
 
+    Threading: the per-step lanes (conditions, probabilities, locks, nudges) are
+    edited on the message thread and published to the audio thread as
+    immutable snapshots; condition playback state is owned by the audio thread.
+
   ==============================================================================
 */
 
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "StepConditions.h"
+#include "MicrotimingLane.h"
+#include "../DSP/SnapshotPublisher.h"
 #include <vector>
 
+// Immutable per-step lanes shared with the audio thread
+struct EuclideanStepLanes
+{
+    StepConditionLane conditions;
+    MicrotimingLane microtiming;
+};
+
 class EuclideanEngine
 {
 public:
@@ -25,16 +39,58 @@ public:
     void setRotation(int rotation);
     void setAccentPattern(const std::vector<float>& accents);
 
+    // Install a pattern computed ahead of time (pattern chain switch points)
+    // without running Björklund's algorithm. Audio thread safe: copies into
+    // storage reserved for maxSteps, so it never allocates.
+    void applyPreparedPattern(int numSteps, int numPulses, int rot,
+                              const std::vector<bool>& preparedPattern,
+                              const std::vector<float>& preparedVelocities);
+
     // Pattern retrieval
     bool getStep(int stepIndex) const;
     float getVelocity(int stepIndex) const;
     int getSteps() const { return steps; }
     int getPulses() const { return pulses; }
+    int getRotation() const { return rotation; }
 
     // Pattern modification
     void rotate(int amount);
     void randomize(float density);
 
+    // Per-step probability, conditional trigs and parameter locks (message thread;
+    // every edit copies the latest lanes and publishes them)
+    void setStepCondition(int stepIndex, juce::uint32 conditionFlags, int ratioA = 1, int ratioB = 1);
+    void setStepProbability(int stepIndex, float probability);
+    void setStepParameterLocks(int stepIndex, const StepParameterLocks& locks);
+    void clearStep(int stepIndex);
+    void clearStepConditions();
+    const StepConditionLane& getConditionLane() const { return stepLanes.getLatest().conditions; }
+
+    // Edits several steps and publishes them as a single snapshot
+    void editStepLanes(const std::function<void(EuclideanStepLanes&)>& edit);
+
+    // Saved with the plugin state
+    std::unique_ptr<juce::XmlElement> stepLanesToXml() const;
+    void stepLanesFromXml(const juce::XmlElement& xml);
+
+    // Reclaims superseded lane snapshots (call periodically from the message thread)
+    void collectGarbage() { stepLanes.collectGarbage(); }
+
+    // Newest lanes (audio thread); valid until the next call
+    const EuclideanStepLanes& acquireStepLanes() noexcept { return stepLanes.acquire(); }
+
+    // Condition playback state (audio thread)
+    StepConditionState& getConditionState() { return conditionState; }
+    void resetConditionState() { conditionState.reset(); }
+
+    // Per-step microtiming (fraction of a step, -0.5 to +0.5; message thread)
+    void setStepNudge(int stepIndex, float fractionOfStep);
+    void setStepNudgeTicks(int stepIndex, int ticks);
+    const MicrotimingLane& getMicrotimingLane() const { return stepLanes.getLatest().microtiming; }
+
+    // Swing + nudge offset table (audio thread)
+    MicrotimingTable& getMicrotimingTable() { return microtimingTable; }
+
     // Reset
     void regeneratePattern();
 
@@ -46,10 +102,17 @@ private:
     int pulses = 4;
     int rotation = 0;
 
-    std::vector<bool> pattern;
-    std::vector<float> velocities;
+    static constexpr int maxSteps = 64;
+
+    std::vector<bool> pattern;          // Capacity reserved for maxSteps
+    std::vector<float> velocities;      // Capacity reserved for maxSteps
     std::vector<float> accentPattern;
 
+    SnapshotPublisher<EuclideanStepLanes> stepLanes;
+    StepConditionState conditionState;
+
+    MicrotimingTable microtimingTable;
+
     juce::Random random;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EuclideanEngine)
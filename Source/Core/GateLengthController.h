@@ -52,7 +52,18 @@ public:
      */
     int calculateGateLengthSamples(int samplesPerStep)
     {
-        float baseGate = legatoMode ? 1.0f : gateLength;
+        return calculateGateLengthSamples(samplesPerStep, gateLength);
+    }
+
+    /**
+     * Calculate gate length in samples using an explicit gate percentage
+     * (legato mode and randomization still apply)
+     * @param samplesPerStep Duration of one step in samples
+     * @param gatePercentage Gate length as a fraction of the step
+     */
+    int calculateGateLengthSamples(int samplesPerStep, float gatePercentage)
+    {
+        float baseGate = legatoMode ? 1.0f : gatePercentage;
 
         // Apply randomization
         float variation = 0.0f;
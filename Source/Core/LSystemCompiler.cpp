@@ -0,0 +1,359 @@
+/*
+  ==============================================================================
+    LSystemCompiler.cpp
+
+    Rule text parsing and bytecode generation
+
+  ==============================================================================
+*/
+
+#include "LSystemCompiler.h"
+#include <cctype>
+#include <cstdlib>
+
+namespace
+{
+    using LSystemBytecode::Op;
+
+    // Recursive-descent parser emitting postfix bytecode
+    class RuleParser
+    {
+    public:
+        RuleParser(const std::string& source, const std::vector<std::string>& formalNames, std::vector<Op>& output)
+            : text(source), formals(formalNames), code(output)
+        {
+        }
+
+        bool parseModules(std::vector<LSystemModuleTemplate>& modules)
+        {
+            for (;;)
+            {
+                skipSpace();
+                if (atEnd())
+                    return true;
+
+                const char symbol = text[pos++];
+                if (symbol == '(' || symbol == ')' || symbol == ',')
+                    return fail("Unexpected '" + std::string(1, symbol) + "'");
+
+                LSystemModuleTemplate module;
+                module.symbol = symbol;
+
+                skipSpace();
+                if (!atEnd() && text[pos] == '(')
+                {
+                    ++pos;
+                    for (;;)
+                    {
+                        if (module.numParams >= LSystemBytecode::maxParams)
+                            return fail("Too many parameters");
+
+                        const auto p = static_cast<size_t>(module.numParams);
+                        module.codeStart[p] = static_cast<int>(code.size());
+                        if (!parseExpression())
+                            return false;
+                        module.codeLength[p] = static_cast<int>(code.size()) - module.codeStart[p];
+                        ++module.numParams;
+
+                        skipSpace();
+                        if (!atEnd() && text[pos] == ',') { ++pos; continue; }
+                        if (!atEnd() && text[pos] == ')') { ++pos; break; }
+                        return fail("Expected ',' or ')'");
+                    }
+                }
+
+                modules.push_back(module);
+            }
+        }
+
+        bool parseWholeExpression(int& start, int& length)
+        {
+            start = static_cast<int>(code.size());
+            if (!parseExpression())
+                return false;
+
+            skipSpace();
+            if (!atEnd())
+                return fail("Unexpected text after expression");
+
+            length = static_cast<int>(code.size()) - start;
+            return true;
+        }
+
+        std::string error;
+
+    private:
+        bool parseExpression()
+        {
+            depth = 0;
+            return parseComparison();
+        }
+
+        bool parseComparison()
+        {
+            if (!parseSum())
+                return false;
+
+            skipSpace();
+            if (!atEnd() && (text[pos] == '<' || text[pos] == '>'))
+            {
+                const auto type = text[pos++] == '<' ? Op::Less : Op::Greater;
+                if (!parseSum())
+                    return false;
+                return emit(type);
+            }
+
+            return true;
+        }
+
+        bool parseSum()
+        {
+            if (!parseProduct())
+                return false;
+
+            for (;;)
+            {
+                skipSpace();
+                if (atEnd() || (text[pos] != '+' && text[pos] != '-'))
+                    return true;
+
+                const auto type = text[pos++] == '+' ? Op::Add : Op::Subtract;
+                if (!parseProduct() || !emit(type))
+                    return false;
+            }
+        }
+
+        bool parseProduct()
+        {
+            if (!parseUnary())
+                return false;
+
+            for (;;)
+            {
+                skipSpace();
+                if (atEnd() || (text[pos] != '*' && text[pos] != '/'))
+                    return true;
+
+                const auto type = text[pos++] == '*' ? Op::Multiply : Op::Divide;
+                if (!parseUnary() || !emit(type))
+                    return false;
+            }
+        }
+
+        bool parseUnary()
+        {
+            skipSpace();
+            if (!atEnd() && text[pos] == '-')
+            {
+                ++pos;
+                return parseUnary() && emit(Op::Negate);
+            }
+            return parsePrimary();
+        }
+
+        bool parsePrimary()
+        {
+            skipSpace();
+            if (atEnd())
+                return fail("Expected a value");
+
+            const char c = text[pos];
+
+            if (c == '(')
+            {
+                ++pos;
+                if (!parseComparison())
+                    return false;
+                skipSpace();
+                if (atEnd() || text[pos] != ')')
+                    return fail("Expected ')'");
+                ++pos;
+                return true;
+            }
+
+            if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+            {
+                char* end = nullptr;
+                const float value = std::strtof(text.c_str() + pos, &end);
+                pos = static_cast<size_t>(end - text.c_str());
+                return emit(Op::Constant, 0, value);
+            }
+
+            if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+            {
+                const auto name = readIdentifier();
+                for (size_t i = 0; i < formals.size(); ++i)
+                    if (formals[i] == name)
+                        return emit(Op::Parameter, static_cast<juce::uint8>(i));
+                return fail("Unknown parameter '" + name + "'");
+            }
+
+            return fail("Unexpected '" + std::string(1, c) + "'");
+        }
+
+        std::string readIdentifier()
+        {
+            const auto start = pos;
+            while (!atEnd() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_'))
+                ++pos;
+            return text.substr(start, pos - start);
+        }
+
+        bool emit(Op::Type type, juce::uint8 index = 0, float value = 0.0f)
+        {
+            if (type == Op::Constant || type == Op::Parameter)
+                ++depth;
+            else if (type != Op::Negate)
+                --depth;
+
+            if (depth > LSystemBytecode::maxStackDepth)
+                return fail("Expression too deep");
+
+            Op op;
+            op.type = type;
+            op.index = index;
+            op.value = value;
+            code.push_back(op);
+            return true;
+        }
+
+        void skipSpace()
+        {
+            while (!atEnd() && std::isspace(static_cast<unsigned char>(text[pos])))
+                ++pos;
+        }
+
+        bool atEnd() const { return pos >= text.size(); }
+
+        bool fail(const std::string& message)
+        {
+            error = message + " at position " + std::to_string(pos);
+            return false;
+        }
+
+        const std::string& text;
+        const std::vector<std::string>& formals;
+        std::vector<Op>& code;
+        size_t pos = 0;
+        int depth = 0;
+    };
+
+    bool parsePredecessor(const std::string& text, char& symbol, std::vector<std::string>& formals, std::string& error)
+    {
+        size_t pos = 0;
+        auto skipSpace = [&] { while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos; };
+
+        skipSpace();
+        if (pos >= text.size())
+        {
+            error = "Missing predecessor symbol";
+            return false;
+        }
+
+        symbol = text[pos++];
+        skipSpace();
+
+        if (pos < text.size() && text[pos] == '(')
+        {
+            ++pos;
+            for (;;)
+            {
+                skipSpace();
+                const auto start = pos;
+                while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_'))
+                    ++pos;
+
+                if (pos == start || formals.size() >= LSystemBytecode::maxParams)
+                {
+                    error = "Invalid formal parameter list";
+                    return false;
+                }
+
+                formals.push_back(text.substr(start, pos - start));
+                skipSpace();
+
+                if (pos < text.size() && text[pos] == ',') { ++pos; continue; }
+                if (pos < text.size() && text[pos] == ')') { ++pos; break; }
+
+                error = "Expected ',' or ')' in predecessor";
+                return false;
+            }
+        }
+
+        skipSpace();
+        if (pos != text.size())
+        {
+            error = "Predecessor must be a single module";
+            return false;
+        }
+
+        return true;
+    }
+
+    char contextSymbol(const juce::String& context)
+    {
+        auto text = context.trim().toStdString();
+        return text.empty() ? 0 : text[0];
+    }
+}
+
+//==============================================================================
+bool LSystemCompiler::compileRule(const juce::String& predecessor, const juce::String& successor,
+                                  float probability, const juce::String& leftContext,
+                                  const juce::String& rightContext, const juce::String& condition,
+                                  CompiledLSystemRule& result, juce::String& errorMessage)
+{
+    CompiledLSystemRule rule;
+    std::vector<std::string> formals;
+    std::string error;
+
+    if (!parsePredecessor(predecessor.toStdString(), rule.symbol, formals, error))
+    {
+        errorMessage = error;
+        return false;
+    }
+
+    rule.numFormals = static_cast<int>(formals.size());
+    rule.leftContext = contextSymbol(leftContext);
+    rule.rightContext = contextSymbol(rightContext);
+    rule.probability = juce::jlimit(0.0f, 1.0f, probability);
+
+    const auto successorText = successor.toStdString();
+    RuleParser successorParser(successorText, formals, rule.code);
+    if (!successorParser.parseModules(rule.successor))
+    {
+        errorMessage = successorParser.error;
+        return false;
+    }
+
+    const auto conditionText = condition.trim().toStdString();
+    if (!conditionText.empty())
+    {
+        RuleParser conditionParser(conditionText, formals, rule.code);
+        if (!conditionParser.parseWholeExpression(rule.conditionStart, rule.conditionLength))
+        {
+            errorMessage = conditionParser.error;
+            return false;
+        }
+    }
+
+    result = std::move(rule);
+    return true;
+}
+
+bool LSystemCompiler::compileAxiom(const juce::String& axiom, CompiledLSystemRule& result, juce::String& errorMessage)
+{
+    CompiledLSystemRule rule;
+    const std::vector<std::string> noFormals;
+
+    const auto axiomText = axiom.toStdString();
+    RuleParser parser(axiomText, noFormals, rule.code);
+    if (!parser.parseModules(rule.successor))
+    {
+        errorMessage = parser.error;
+        return false;
+    }
+
+    result = std::move(rule);
+    return true;
+}
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+    LSystemCompiler.h
+
+    Compiled parametric and context-sensitive L-System rules
+    Rule text such as  B < A(d, v) > C : d > 0.25  ->  A(d / 2, v) B(d, v * 0.9)
+    is parsed once, when the rule is added, into module templates whose
+    parameter expressions are stack bytecode. Expansion only evaluates the
+    bytecode; strings are never parsed again.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace LSystemBytecode
+{
+    static constexpr int maxParams = 4;
+    static constexpr int maxStackDepth = 16;
+
+    struct Op
+    {
+        enum Type : juce::uint8
+        {
+            Constant,       // push value
+            Parameter,      // push bound parameter [index]
+            Add, Subtract, Multiply, Divide, Negate,
+            Less, Greater   // push 1.0 or 0.0
+        };
+
+        Type type = Constant;
+        juce::uint8 index = 0;
+        float value = 0.0f;
+    };
+
+    /** Evaluates a compiled expression against the bound parameters. */
+    inline float evaluate(const Op* code, int length, const float* params)
+    {
+        std::array<float, maxStackDepth> stack;
+        int top = 0;
+
+        for (int i = 0; i < length; ++i)
+        {
+            const auto& op = code[i];
+            switch (op.type)
+            {
+                case Op::Constant:  stack[static_cast<size_t>(top++)] = op.value; break;
+                case Op::Parameter: stack[static_cast<size_t>(top++)] = params[op.index]; break;
+                case Op::Negate:    stack[static_cast<size_t>(top - 1)] = -stack[static_cast<size_t>(top - 1)]; break;
+                default:
+                {
+                    const float b = stack[static_cast<size_t>(--top)];
+                    float& a = stack[static_cast<size_t>(top - 1)];
+                    switch (op.type)
+                    {
+                        case Op::Add:      a = a + b; break;
+                        case Op::Subtract: a = a - b; break;
+                        case Op::Multiply: a = a * b; break;
+                        case Op::Divide:   a = (b != 0.0f) ? a / b : 0.0f; break;
+                        case Op::Less:     a = (a < b) ? 1.0f : 0.0f; break;
+                        case Op::Greater:  a = (a > b) ? 1.0f : 0.0f; break;
+                        default: break;
+                    }
+                    break;
+                }
+            }
+        }
+
+        return top > 0 ? stack[static_cast<size_t>(top - 1)] : 0.0f;
+    }
+}
+
+/**
+ * A module in an expanded string: symbol plus actual parameter values
+ */
+struct LSystemModule
+{
+    char symbol = 0;
+    int numParams = 0;
+    std::array<float, LSystemBytecode::maxParams> params {};
+};
+
+/**
+ * A successor module whose parameters are bytecode ranges in the rule's code
+ */
+struct LSystemModuleTemplate
+{
+    char symbol = 0;
+    int numParams = 0;
+    std::array<int, LSystemBytecode::maxParams> codeStart {};
+    std::array<int, LSystemBytecode::maxParams> codeLength {};
+};
+
+/**
+ * A compiled production (the axiom compiles to one with no predecessor)
+ */
+struct CompiledLSystemRule
+{
+    char symbol = 0;                // Predecessor symbol
+    int numFormals = 0;             // Formal parameters bound from the predecessor
+    char leftContext = 0;           // 0 = any
+    char rightContext = 0;          // 0 = any
+    float probability = 1.0f;
+
+    int conditionStart = 0;         // Condition bytecode; length 0 = always
+    int conditionLength = 0;
+
+    std::vector<LSystemModuleTemplate> successor;
+    std::vector<LSystemBytecode::Op> code;
+
+    /** Instantiates successor module [index] with the predecessor's parameters. */
+    LSystemModule instantiate(int index, const float* boundParams) const
+    {
+        const auto& moduleTemplate = successor[static_cast<size_t>(index)];
+
+        LSystemModule module;
+        module.symbol = moduleTemplate.symbol;
+        module.numParams = moduleTemplate.numParams;
+
+        for (int p = 0; p < moduleTemplate.numParams; ++p)
+            module.params[static_cast<size_t>(p)] = LSystemBytecode::evaluate(
+                code.data() + moduleTemplate.codeStart[static_cast<size_t>(p)],
+                moduleTemplate.codeLength[static_cast<size_t>(p)], boundParams);
+
+        return module;
+    }
+
+    bool conditionHolds(const float* boundParams) const
+    {
+        return conditionLength == 0
+            || LSystemBytecode::evaluate(code.data() + conditionStart, conditionLength, boundParams) != 0.0f;
+    }
+};
+
+/**
+ * Parses rule text into CompiledLSystemRule (edit time only)
+ */
+class LSystemCompiler
+{
+public:
+    /**
+     * Compile a production.
+     * @param predecessor  Symbol with optional formal names, e.g. "A" or "A(d, v)"
+     * @param successor    Modules with optional expressions, e.g. "A(d / 2, v) + B(d, v * 0.9)"
+     * @param leftContext  Required left neighbour symbol, or empty
+     * @param rightContext Required right neighbour symbol, or empty
+     * @param condition    Expression over the formals that must be non-zero, or empty
+     * @return false (with errorMessage set) if the text does not parse
+     */
+    static bool compileRule(const juce::String& predecessor, const juce::String& successor,
+                            float probability, const juce::String& leftContext,
+                            const juce::String& rightContext, const juce::String& condition,
+                            CompiledLSystemRule& result, juce::String& errorMessage);
+
+    /** Compile an axiom; its parameter expressions may only use constants. */
+    static bool compileAxiom(const juce::String& axiom, CompiledLSystemRule& result, juce::String& errorMessage);
+};
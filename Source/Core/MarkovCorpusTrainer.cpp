@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+    MarkovCorpusTrainer.cpp
+
+    Parallel corpus training and model file writing
+
+  ==============================================================================
+*/
+
+#include "MarkovCorpusTrainer.h"
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+MarkovCorpusTrainer::MarkovCorpusTrainer(int initialOrder)
+{
+    setOrder(initialOrder);
+}
+
+void MarkovCorpusTrainer::addFile(const juce::File& midiFile)
+{
+    if (midiFile.existsAsFile())
+        files.push_back(midiFile);
+}
+
+int MarkovCorpusTrainer::addFolder(const juce::File& folder, bool recursive)
+{
+    int added = 0;
+
+    for (const auto& file : folder.findChildFiles(juce::File::findFiles, recursive, "*.mid;*.midi"))
+    {
+        files.push_back(file);
+        ++added;
+    }
+
+    return added;
+}
+
+//==============================================================================
+MarkovCorpusTrainer::Report MarkovCorpusTrainer::train(const juce::File& outputFile, const std::atomic<bool>* shouldCancel)
+{
+    Report report;
+
+    const int workers = juce::jlimit(1, juce::jmax(1, static_cast<int>(files.size())),
+                                     numThreads > 0 ? numThreads : juce::SystemStats::getNumCpus());
+
+    // Each worker claims files from a shared index and counts into its own table
+    std::vector<CountTable> tables(workers);
+    std::vector<EventSequences> sequences(jointModel != nullptr ? workers : 0);
+    std::vector<int> parsed(workers, 0), failed(workers, 0);
+    std::atomic<int> nextFile { 0 };
+
+    auto work = [&](int worker) {
+        for (;;)
+        {
+            if (shouldCancel != nullptr && shouldCancel->load(std::memory_order_relaxed))
+                return;
+
+            int index = nextFile.fetch_add(1, std::memory_order_relaxed);
+            if (index >= files.size())
+                return;
+
+            if (countFile(files[index], tables[worker], jointModel != nullptr ? &sequences[worker] : nullptr))
+                ++parsed[worker];
+            else
+                ++failed[worker];
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < workers; ++worker)
+        threads.emplace_back(work, worker);
+
+    work(0);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    if (shouldCancel != nullptr && shouldCancel->load())
+        return report;
+
+    // Merge per-thread tables into the first
+    for (int worker = 0; worker < workers; ++worker)
+    {
+        report.filesParsed += parsed[worker];
+        report.filesFailed += failed[worker];
+
+        if (worker > 0)
+        {
+            mergeInto(tables[0], tables[worker]);
+            CountTable().swap(tables[worker]);
+        }
+    }
+
+    report.written = writeModel(tables[0], outputFile, report);
+
+    // One publish for the whole corpus
+    if (jointModel != nullptr)
+    {
+        for (int worker = 1; worker < workers; ++worker)
+            std::move(sequences[worker].begin(), sequences[worker].end(), std::back_inserter(sequences[0]));
+
+        jointModel->learn(sequences[0]);
+    }
+
+    return report;
+}
+
+bool MarkovCorpusTrainer::countFile(const juce::File& midiFile, CountTable& counts, EventSequences* sequences) const
+{
+    juce::FileInputStream stream(midiFile);
+    if (!stream.openedOk())
+        return false;
+
+    juce::MidiFile midi;
+    if (!midi.readFrom(stream))
+        return false;
+
+    // Joint events need musical time; SMPTE-timed files only train the pitch model
+    const double ticksPerStep = midi.getTimeFormat() > 0 ? midi.getTimeFormat() / 4.0 : 0.0;
+    if (ticksPerStep <= 0.0)
+        sequences = nullptr;
+
+    // Each track is its own voice; note history does not carry across tracks
+    for (int track = 0; track < midi.getNumTracks(); ++track)
+    {
+        const auto* sequence = midi.getTrack(track);
+        if (sequence == nullptr)
+            continue;
+
+        NoteHistoryRing history;
+        std::array<int, MarkovChain::maxOrder> stateValues;
+        std::vector<MarkovEvent> events;
+        double lastNoteTime = 0.0;
+
+        for (int i = 0; i < sequence->getNumEvents(); ++i)
+        {
+            const auto& message = sequence->getEventPointer(i)->message;
+            if (!message.isNoteOn() || (skipDrumChannel && message.getChannel() == 10))
+                continue;
+
+            const int note = message.getNoteNumber();
+
+            if (sequences != nullptr)
+            {
+                const double time = message.getTimeStamp() / ticksPerStep;
+                if (!events.empty())
+                    events.back().interOnsetSteps = juce::jlimit(1, JointToken::maxInterOnsetSteps,
+                                                                 juce::roundToInt(time - lastNoteTime));
+
+                MarkovEvent event;
+                event.pitch = note;
+                event.velocity = message.getFloatVelocity();
+                events.push_back(event);
+                lastNoteTime = time;
+            }
+
+            if (history.size() >= order)
+            {
+                for (int k = 0; k < order; ++k)
+                    stateValues[static_cast<size_t>(k)] = history.getRecent(order - 1 - k);
+
+                ++counts[MarkovChain::packState(stateValues.data(), order)][note];
+            }
+
+            history.push(note);
+        }
+
+        // The last note's interval is unknown, so it is not learned
+        if (sequences != nullptr && events.size() > 1)
+        {
+            events.pop_back();
+            sequences->push_back(std::move(events));
+        }
+    }
+
+    return true;
+}
+
+void MarkovCorpusTrainer::mergeInto(CountTable& target, const CountTable& source)
+{
+    for (const auto& [key, nextCounts] : source)
+    {
+        auto& targetCounts = target[key];
+        for (const auto& [next, count] : nextCounts)
+            targetCounts[next] += count;
+    }
+}
+
+bool MarkovCorpusTrainer::writeModel(const CountTable& counts, const juce::File& outputFile, Report& report) const
+{
+    // Sorted key index so the loader can binary search the mapped file
+    std::vector<juce::uint64> keys;
+    keys.reserve(counts.size());
+    for (const auto& [key, nextCounts] : counts)
+        if (!nextCounts.empty())
+            keys.push_back(key);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<MarkovModelFile::StateRecord> states;
+    std::vector<MarkovModelFile::TransitionRecord> transitions;
+    states.reserve(keys.size());
+
+    std::vector<float> weights, probabilities;
+    std::vector<int> aliases;
+
+    for (auto key : keys)
+    {
+        const auto& nextCounts = counts.at(key);
+
+        weights.clear();
+        for (const auto& [next, count] : nextCounts)
+            weights.push_back(static_cast<float>(count));
+
+        MarkovChain::buildAliasTable(weights, probabilities, aliases);
+
+        MarkovModelFile::StateRecord state;
+        state.key = key;
+        state.firstTransition = static_cast<juce::uint32>(transitions.size());
+        state.numTransitions = static_cast<juce::uint32>(nextCounts.size());
+        states.push_back(state);
+
+        int column = 0;
+        for (const auto& [next, count] : nextCounts)
+        {
+            MarkovModelFile::TransitionRecord transition;
+            transition.value = static_cast<juce::uint16>(next);
+            transition.alias = static_cast<juce::uint16>(aliases[column]);
+            transition.probability = probabilities[column];
+            transitions.push_back(transition);
+            ++column;
+        }
+    }
+
+    MarkovModelFile::Header header {};
+    header.magic = MarkovModelFile::magic;
+    header.version = MarkovModelFile::formatVersion;
+    header.order = static_cast<juce::uint32>(order);
+    header.numStates = static_cast<juce::uint32>(states.size());
+    header.numTransitions = static_cast<juce::uint32>(transitions.size());
+
+    report.numStates = static_cast<int>(states.size());
+    report.numTransitions = static_cast<int>(transitions.size());
+
+    // Records are written in native byte order (see MarkovModelFile.h).
+    // Write beside the target and swap it in, never rewriting a file another instance has mapped
+    juce::TemporaryFile temp(outputFile);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return false;
+
+        bool ok = out.write(&header, sizeof(header))
+               && out.write(states.data(), states.size() * sizeof(MarkovModelFile::StateRecord))
+               && out.write(transitions.data(), transitions.size() * sizeof(MarkovModelFile::TransitionRecord));
+        out.flush();
+
+        if (!ok)
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+    MarkovCorpusTrainer.h
+
+    Parallel Markov model trainer for folders of MIDI files
+    Files are parsed with juce::MidiFile on all cores, each worker counting
+    transitions into its own table. The tables are merged and written as a
+    compact binary model (MarkovModelFile.h) that MarkovChain memory-maps.
+    Optionally the same notes, with inter-onset intervals and velocities,
+    train a joint VariableOrderMarkov model in memory (it is not written).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "AlgorithmicEngine.h"
+#include <atomic>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+class MarkovCorpusTrainer
+{
+public:
+    struct Report
+    {
+        int filesParsed = 0;
+        int filesFailed = 0;
+        int numStates = 0;
+        int numTransitions = 0;
+        bool written = false;
+    };
+
+    explicit MarkovCorpusTrainer(int order = 2);
+    ~MarkovCorpusTrainer() = default;
+
+    // Configuration
+    void setOrder(int newOrder) { order = juce::jlimit(1, MarkovChain::maxOrder, newOrder); }
+    int getOrder() const { return order; }
+    void setNumThreads(int threads) { numThreads = juce::jmax(0, threads); }  // 0 = one per core
+    void setSkipDrumChannel(bool shouldSkip) { skipDrumChannel = shouldSkip; }
+    void setJointModel(VariableOrderMarkov* modelToTrain) { jointModel = modelToTrain; }  // nullptr = none
+
+    // Corpus
+    void addFile(const juce::File& midiFile);
+    int addFolder(const juce::File& folder, bool recursive = true);
+    void clearFiles() { files.clear(); }
+    int getNumFiles() const { return static_cast<int>(files.size()); }
+
+    /**
+     * Parse the corpus in parallel, merge the counts and write the model file.
+     * Blocks until done; call from a background thread for large corpora.
+     * The output is replaced atomically, so instances mapping the old file keep working.
+     */
+    Report train(const juce::File& outputFile, const std::atomic<bool>* shouldCancel = nullptr);
+
+private:
+    using CountTable = std::unordered_map<juce::uint64, std::map<int, juce::uint32>>;
+    using EventSequences = std::vector<std::vector<MarkovEvent>>;
+
+    bool countFile(const juce::File& midiFile, CountTable& counts, EventSequences* sequences) const;
+    static void mergeInto(CountTable& target, const CountTable& source);
+    bool writeModel(const CountTable& counts, const juce::File& outputFile, Report& report) const;
+
+    std::vector<juce::File> files;
+    int order = 2;
+    int numThreads = 0;
+    bool skipDrumChannel = true;
+    VariableOrderMarkov* jointModel = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MarkovCorpusTrainer)
+};
@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+    MarkovLearner.cpp
+
+    Streaming Markov learner implementation
+
+  ==============================================================================
+*/
+
+#include "MarkovLearner.h"
+#include <algorithm>
+
+MarkovLearner::MarkovLearner(MarkovChain& chainToTrain, VariableOrderMarkov& jointModelToTrain)
+    : juce::Thread("Markov Learner"),
+      chain(chainToTrain),
+      jointModel(jointModelToTrain),
+      learnedOrder(chainToTrain.getOrder())
+{
+}
+
+MarkovLearner::~MarkovLearner()
+{
+    stop();
+}
+
+void MarkovLearner::start()
+{
+    if (!isThreadRunning())
+        startThread();
+}
+
+void MarkovLearner::stop()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+void MarkovLearner::pushNote(int noteNumber, float velocity, double timeInSteps) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    const InputNote note { noteNumber, velocity, timeInSteps };
+    if (size1 > 0)
+        noteBuffer[static_cast<size_t>(start1)] = note;
+    else if (size2 > 0)
+        noteBuffer[static_cast<size_t>(start2)] = note;
+
+    fifo.finishedWrite(size1 + size2);
+}
+
+void MarkovLearner::setMaxStates(int newMaxStates)
+{
+    maxStates.store(juce::jlimit(16, 65536, newMaxStates), std::memory_order_relaxed);
+}
+
+void MarkovLearner::setDecay(float decayFactor)
+{
+    decay.store(juce::jlimit(0.5f, 1.0f, decayFactor), std::memory_order_relaxed);
+}
+
+//==============================================================================
+void MarkovLearner::run()
+{
+    while (!threadShouldExit())
+    {
+        if (clearRequested.exchange(false, std::memory_order_acq_rel))
+        {
+            resetLearnedState();
+            chain.replaceLearnedTransitions({});   // Keeps edits and a loaded model file
+            jointModel.reset();
+        }
+
+        // Order changed on the chain: counts for the old order are meaningless
+        if (chain.getOrder() != learnedOrder)
+        {
+            resetLearnedState();
+            learnedOrder = chain.getOrder();
+        }
+
+        // Drain the FIFO
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            learnNote(noteBuffer[static_cast<size_t>(start1 + i)]);
+        for (int i = 0; i < size2; ++i)
+            learnNote(noteBuffer[static_cast<size_t>(start2 + i)]);
+
+        fifo.finishedRead(size1 + size2);
+
+        // Publish at a bounded rate so bursts of input do not recompile per note
+        auto now = juce::Time::getMillisecondCounter();
+        if (modelChanged && now - lastPublishTime >= publishIntervalMs)
+        {
+            publishModel();
+            lastPublishTime = now;
+        }
+
+        wait(20);
+    }
+}
+
+void MarkovLearner::learnNote(const InputNote& note)
+{
+    learnJointEvent(note);
+
+    const int noteNumber = juce::jlimit(0, 127, note.noteNumber);
+
+    if (history.size() >= learnedOrder)
+    {
+        std::array<int, MarkovChain::maxOrder> stateValues;
+        for (int i = 0; i < learnedOrder; ++i)
+            stateValues[static_cast<size_t>(i)] = history.getRecent(learnedOrder - 1 - i);
+
+        auto& state = states[MarkovChain::packState(stateValues.data(), learnedOrder)];
+        state.lastTouched = ++touchCounter;
+
+        // Exponential decay keeps the model following recent playing
+        const float decayFactor = decay.load(std::memory_order_relaxed);
+        for (auto it = state.weights.begin(); it != state.weights.end();)
+        {
+            it->second *= decayFactor;
+            if (it->second < 0.01f)
+                it = state.weights.erase(it);
+            else
+                ++it;
+        }
+
+        state.weights[noteNumber] += 1.0f;
+        modelChanged = true;
+
+        if (states.size() > maxStates.load(std::memory_order_relaxed))
+            evictLeastRecentlyUsed();
+
+        numLearnedStates.store(static_cast<int>(states.size()), std::memory_order_relaxed);
+    }
+
+    history.push(noteNumber);
+}
+
+void MarkovLearner::learnJointEvent(const InputNote& note)
+{
+    // The previous event's inter-onset interval is known now (gaps are clamped to the token range)
+    if (!jointEvents.empty())
+        jointEvents.back().interOnsetSteps = juce::jlimit(1, JointToken::maxInterOnsetSteps,
+                                                          juce::roundToInt(note.timeInSteps - lastNoteTime));
+
+    MarkovEvent event;
+    event.pitch = juce::jlimit(0, 127, note.noteNumber);
+    event.velocity = juce::jlimit(0.0f, 1.0f, note.velocity);
+    jointEvents.push_back(event);
+    lastNoteTime = note.timeInSteps;
+    modelChanged = true;
+}
+
+void MarkovLearner::publishJointEvents()
+{
+    // The newest event is still waiting for its inter-onset interval
+    const int completed = static_cast<int>(jointEvents.size()) - 1;
+    if (completed <= jointContextEvents)
+        return;
+
+    jointModel.learn(std::vector<MarkovEvent>(jointEvents.begin(), jointEvents.end() - 1), jointContextEvents);
+
+    // Keep the most recent events as context for the next chunk
+    const int keep = juce::jmin(completed, jointModel.getMaxOrder());
+    jointEvents.erase(jointEvents.begin(), jointEvents.begin() + (completed - keep));
+    jointContextEvents = keep;
+}
+
+void MarkovLearner::evictLeastRecentlyUsed()
+{
+    // Evict the oldest eighth in one pass so eviction cost is amortized
+    std::vector<juce::uint64> ages;
+    ages.reserve(states.size());
+    for (const auto& [key, state] : states)
+        ages.push_back(state.lastTouched);
+
+    const size_t evictCount = juce::jmax<size_t>(1, states.size() / 8);
+    std::nth_element(ages.begin(), ages.begin() + (evictCount - 1), ages.end());
+    const auto threshold = ages[evictCount - 1];
+
+    for (auto it = states.begin(); it != states.end();)
+    {
+        if (it->second.lastTouched <= threshold)
+            it = states.erase(it);
+        else
+            ++it;
+    }
+}
+
+void MarkovLearner::publishModel()
+{
+    MarkovChain::WeightTable weights;
+    for (const auto& [key, state] : states)
+        if (!state.weights.empty())
+            weights.emplace(key, state.weights);
+
+    chain.replaceLearnedTransitions(std::move(weights));
+    publishJointEvents();
+    modelChanged = false;
+}
+
+void MarkovLearner::resetLearnedState()
+{
+    states.clear();
+    history.clear();
+    jointEvents.clear();
+    jointContextEvents = 0;
+    modelChanged = false;
+    numLearnedStates.store(0, std::memory_order_relaxed);
+}
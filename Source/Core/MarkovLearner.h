@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+    MarkovLearner.h
+
+    Streaming Markov learner fed from live MIDI input
+    The audio thread pushes incoming notes into a lock-free FIFO. A
+    background thread drains it, updates decayed transition counts for a
+    bounded number of states (least recently used states are evicted) and
+    periodically publishes a freshly compiled model to the MarkovChain.
+    The same notes, with their inter-onset intervals and velocities, train
+    the joint VariableOrderMarkov model.
+    Learned states are kept apart from edited transitions and layered over
+    a loaded model file rather than replacing either. The thread only runs
+    while learning is enabled.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "AlgorithmicEngine.h"
+#include <array>
+#include <atomic>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+class MarkovLearner : private juce::Thread
+{
+public:
+    static constexpr int fifoSize = 1024;
+    static constexpr int defaultMaxStates = 2048;
+    static constexpr int publishIntervalMs = 100;
+
+    MarkovLearner(MarkovChain& chainToTrain, VariableOrderMarkov& jointModelToTrain);
+    ~MarkovLearner() override;
+
+    // Thread control (message thread)
+    void start();
+    void stop();
+
+    //==============================================================================
+    // Audio thread
+
+    /**
+     * Queue an incoming note-on; dropped if the FIFO is full. Wait-free.
+     * timeInSteps is the note's time in 16th-note steps on any steady clock.
+     */
+    void pushNote(int noteNumber, float velocity, double timeInSteps) noexcept;
+
+    //==============================================================================
+    // Configuration (message thread)
+
+    /** Maximum number of learned states before least recently used ones are evicted. */
+    void setMaxStates(int maxStates);
+
+    /** Weight kept by a state's existing counts each time it is updated (1.0 = no decay). */
+    void setDecay(float decayFactor);
+
+    /** Forget everything learned so far (applied on the learner thread). */
+    void clear() { clearRequested.store(true, std::memory_order_release); notify(); }
+
+    int getNumLearnedStates() const { return numLearnedStates.load(std::memory_order_relaxed); }
+
+private:
+    struct InputNote
+    {
+        int noteNumber = 60;
+        float velocity = 0.7f;
+        double timeInSteps = 0.0;
+    };
+
+    struct LearnedState
+    {
+        std::map<int, float> weights;
+        juce::uint64 lastTouched = 0;
+    };
+
+    void run() override;
+    void learnNote(const InputNote& note);
+    void learnJointEvent(const InputNote& note);
+    void publishJointEvents();
+    void evictLeastRecentlyUsed();
+    void publishModel();
+    void resetLearnedState();
+
+    MarkovChain& chain;
+    VariableOrderMarkov& jointModel;
+
+    // Audio -> learner FIFO
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<InputNote, fifoSize> noteBuffer {};
+
+    // Learner-thread state
+    std::unordered_map<juce::uint64, LearnedState> states;
+    NoteHistoryRing history;
+    int learnedOrder = 1;
+
+    // Joint events not yet published; the last one waits for its inter-onset
+    // interval and the first jointContextEvents were published already
+    std::vector<MarkovEvent> jointEvents;
+    int jointContextEvents = 0;
+    double lastNoteTime = 0.0;
+
+    juce::uint64 touchCounter = 0;
+    bool modelChanged = false;
+    juce::uint32 lastPublishTime = 0;
+
+    std::atomic<int> maxStates { defaultMaxStates };
+    std::atomic<float> decay { 0.98f };
+    std::atomic<bool> clearRequested { false };
+    std::atomic<int> numLearnedStates { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MarkovLearner)
+};
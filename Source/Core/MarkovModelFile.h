@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+    MarkovModelFile.h
+
+    Binary Markov model file format
+    Written by MarkovCorpusTrainer and memory-mapped by MarkovChain, so a
+    large model loads without parsing and is shared between plugin instances
+    through the page cache. Records are written in the writer's native byte
+    order (little-endian on every platform the plugin ships for); the magic
+    doubles as a byte-order mark, so a model written with the other byte
+    order is rejected on load rather than misread.
+
+    Layout:
+        Header
+        StateRecord[numStates]            sorted by key (binary searchable)
+        TransitionRecord[numTransitions]  per-state alias tables, back to back
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace MarkovModelFile
+{
+    static constexpr juce::uint32 magic = 0x4b4d4d47;   // "GMMK" when stored little-endian
+    static constexpr juce::uint32 swappedMagic = 0x474d4d4b;
+    static constexpr juce::uint32 formatVersion = 1;
+    static constexpr const char* fileExtension = ".gmmk";
+
+    struct Header
+    {
+        juce::uint32 magic;
+        juce::uint32 version;
+        juce::uint32 order;
+        juce::uint32 numStates;
+        juce::uint32 numTransitions;
+        juce::uint32 reserved[3];
+    };
+
+    struct StateRecord
+    {
+        juce::uint64 key;                   // MarkovChain::packState() key
+        juce::uint32 firstTransition;
+        juce::uint32 numTransitions;
+    };
+
+    struct TransitionRecord
+    {
+        juce::uint16 value;                 // MIDI note
+        juce::uint16 alias;                 // Column index within the state's table
+        float probability;                  // Chance of keeping this column's value
+    };
+
+    static_assert(sizeof(Header) == 32, "Model header layout must stay fixed");
+    static_assert(sizeof(StateRecord) == 16, "State record layout must stay fixed");
+    static_assert(sizeof(TransitionRecord) == 8, "Transition record layout must stay fixed");
+
+    /**
+     * Checks the header of a mapped model and that the record arrays fit.
+     * Returns nullptr if the data is not a valid model.
+     */
+    inline const Header* validate(const void* data, size_t size)
+    {
+        if (data == nullptr || size < sizeof(Header))
+            return nullptr;
+
+        const auto* header = static_cast<const Header*>(data);
+
+        // Written on a machine of the other byte order: every field would be swapped
+        if (header->magic == swappedMagic)
+            return nullptr;
+
+        if (header->magic != magic || header->version != formatVersion
+            || header->order < 1 || header->order > 8)
+            return nullptr;
+
+        const auto required = sizeof(Header)
+                            + static_cast<size_t>(header->numStates) * sizeof(StateRecord)
+                            + static_cast<size_t>(header->numTransitions) * sizeof(TransitionRecord);
+
+        return required <= size ? header : nullptr;
+    }
+
+    inline const StateRecord* getStates(const Header* header)
+    {
+        return reinterpret_cast<const StateRecord*>(header + 1);
+    }
+
+    inline const TransitionRecord* getTransitions(const Header* header)
+    {
+        return reinterpret_cast<const TransitionRecord*>(getStates(header) + header->numStates);
+    }
+}
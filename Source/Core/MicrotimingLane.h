@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+    MicrotimingLane.h
+
+    Per-step microtiming (nudge) lane and precomputed timing offset table
+    Nudges are converted into a per-step sample offset table, rebuilt only
+    when the lane or the step duration changes. Swing depends only on a
+    step's parity, so it is kept as two offsets beside the table and
+    refreshed every tick at no cost when swing is modulated. Emitting a
+    note then costs a table lookup and one add.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "SwingEngine.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Per-step timing nudges, stored as fractions of a step
+ */
+class MicrotimingLane
+{
+public:
+    static constexpr int maxSteps = 128;
+    static constexpr int ticksPerStep = 24;     // 96 PPQN at 16th-note steps
+    static constexpr float maxNudge = 0.5f;     // +/- half a step
+
+    MicrotimingLane() : revision(nextRevision()) {}
+
+    /**
+     * @brief Set the nudge for a step
+     * @param fractionOfStep Offset as a fraction of one step (-0.5 to +0.5)
+     */
+    void setNudge(int step, float fractionOfStep)
+    {
+        if (!juce::isPositiveAndBelow(step, maxSteps))
+            return;
+
+        nudges[step] = juce::jlimit(-maxNudge, maxNudge, fractionOfStep);
+        revision = nextRevision();
+    }
+
+    /**
+     * @brief Set the nudge for a step in MIDI ticks (24 ticks per step)
+     */
+    void setNudgeTicks(int step, int ticks)
+    {
+        setNudge(step, static_cast<float>(ticks) / ticksPerStep);
+    }
+
+    float getNudge(int step) const { return nudges[juce::jlimit(0, maxSteps - 1, step)]; }
+    int getNudgeTicks(int step) const { return juce::roundToInt(getNudge(step) * ticksPerStep); }
+
+    void clear()
+    {
+        nudges.fill(0.0f);
+        revision = nextRevision();
+    }
+
+    /**
+     * @brief Serialize the nudged steps (steps without a nudge are omitted)
+     */
+    std::unique_ptr<juce::XmlElement> toXml() const
+    {
+        auto xml = std::make_unique<juce::XmlElement>("Microtiming");
+
+        for (int step = 0; step < maxSteps; ++step)
+        {
+            if (nudges[step] == 0.0f)
+                continue;
+
+            auto* stepXml = xml->createNewChildElement("Step");
+            stepXml->setAttribute("index", step);
+            stepXml->setAttribute("nudge", nudges[step]);
+        }
+
+        return xml;
+    }
+
+    void fromXml(const juce::XmlElement& xml)
+    {
+        nudges.fill(0.0f);
+
+        for (auto* stepXml : xml.getChildWithTagNameIterator("Step"))
+        {
+            const int step = stepXml->getIntAttribute("index", -1);
+            if (juce::isPositiveAndBelow(step, maxSteps))
+                nudges[step] = juce::jlimit(-maxNudge, maxNudge, static_cast<float>(stepXml->getDoubleAttribute("nudge", 0.0)));
+        }
+
+        revision = nextRevision();
+    }
+
+    /**
+     * @brief Unique id of the current lane contents (changes on every edit)
+     */
+    juce::uint32 getRevision() const { return revision; }
+
+private:
+    static juce::uint32 nextRevision()
+    {
+        // Process-wide id source so copies from different layers never share a revision
+        static std::atomic<juce::uint32> counter { 0 };
+        return ++counter;
+    }
+
+    std::array<float, maxSteps> nudges {};
+    juce::uint32 revision = 0;
+};
+
+/**
+ * @brief Swing + nudge offsets in samples for every step (audio-owned)
+ */
+class MicrotimingTable
+{
+public:
+    /**
+     * @brief Refresh the swing offsets, and rebuild the nudge table if the lane or step duration changed
+     * @param samplesPerStep Duration of one step in samples
+     */
+    void update(const MicrotimingLane& lane, const SwingEngine& swing, int samplesPerStep)
+    {
+        // Swing is per parity (on-beat / off-beat), so a modulated amount costs two evaluations
+        swingOffsets[0] = swing.calculateSwingOffset(0, samplesPerStep);
+        swingOffsets[1] = swing.calculateSwingOffset(1, samplesPerStep);
+
+        if (lane.getRevision() == laneRevision && samplesPerStep == cachedSamplesPerStep)
+            return;
+
+        laneRevision = lane.getRevision();
+        cachedSamplesPerStep = samplesPerStep;
+
+        for (int step = 0; step < MicrotimingLane::maxSteps; ++step)
+            nudgeOffsets[step] = static_cast<int>(lane.getNudge(step) * samplesPerStep);
+    }
+
+    /**
+     * @brief Combined swing and nudge offset for a step, in samples
+     */
+    int getOffset(int step) const
+    {
+        return nudgeOffsets[static_cast<size_t>(step)] + swingOffsets[static_cast<size_t>(step & 1)];
+    }
+
+private:
+    std::array<int, MicrotimingLane::maxSteps> nudgeOffsets {};
+    std::array<int, 2> swingOffsets {};
+    juce::uint32 laneRevision = 0;
+    int cachedSamplesPerStep = -1;
+};
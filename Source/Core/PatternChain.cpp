@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+    PatternChain.cpp
+
+    Pattern chain compilation and tick-accurate playback
+
+  ==============================================================================
+*/
+
+#include "PatternChain.h"
+#include "EuclideanEngine.h"
+
+PatternChain::PatternChain()
+    : publisher(std::make_unique<PatternChainTimeline>())
+{
+}
+
+//==============================================================================
+void PatternChain::setEntries(const std::vector<PatternChainEntry>& newEntries)
+{
+    entries.clear();
+    for (const auto& entry : newEntries)
+    {
+        if (entries.size() >= maxEntries)
+            break;
+        entries.push_back(entry);
+    }
+
+    compileAndPublish();
+}
+
+int PatternChain::addEntry(const PatternChainEntry& entry)
+{
+    if (entries.size() >= maxEntries)
+        return -1;
+
+    entries.push_back(entry);
+    compileAndPublish();
+    return static_cast<int>(entries.size()) - 1;
+}
+
+void PatternChain::removeEntry(int entryIndex)
+{
+    if (entryIndex >= 0 && entryIndex < entries.size())
+    {
+        entries.erase(entries.begin() + entryIndex);
+        compileAndPublish();
+    }
+}
+
+void PatternChain::clear()
+{
+    entries.clear();
+    compileAndPublish();
+}
+
+void PatternChain::setTimeSignature(int numerator, int denominator)
+{
+    numerator = juce::jlimit(1, 32, numerator);
+    denominator = juce::jlimit(1, 32, denominator);
+
+    if (numerator == timeSignatureNum && denominator == timeSignatureDenom)
+        return;
+
+    timeSignatureNum = numerator;
+    timeSignatureDenom = denominator;
+    compileAndPublish();
+}
+
+void PatternChain::compileAndPublish()
+{
+    auto timeline = std::make_unique<PatternChainTimeline>();
+    timeline->ticksPerBar = juce::jmax(1, (timeSignatureNum * 16) / timeSignatureDenom);
+    timeline->states.reserve(entries.size());
+
+    juce::int64 tick = 0;
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        auto entry = entries[i];
+        entry.generatorType = juce::jlimit(0, 14, entry.generatorType);
+        entry.euclideanSteps = juce::jlimit(1, 64, entry.euclideanSteps);
+        entry.euclideanPulses = juce::jlimit(0, entry.euclideanSteps, entry.euclideanPulses);
+        entry.euclideanRotation = juce::jlimit(0, 64, entry.euclideanRotation);
+        entry.noteDensity = juce::jlimit(0.0f, 1.0f, entry.noteDensity);
+        entry.lengthInBars = juce::jlimit(1, 256, entry.lengthInBars);
+        entry.repeats = juce::jlimit(1, 256, entry.repeats);
+
+        // Prepare the engine state now so the switch bar only copies it
+        PreparedChainState state;
+        state.entry = entry;
+
+        EuclideanEngine scratch;
+        scratch.setSteps(entry.euclideanSteps);
+        scratch.setPulses(entry.euclideanPulses);
+        scratch.setRotation(entry.euclideanRotation);
+
+        state.euclideanPattern.resize(entry.euclideanSteps);
+        state.euclideanVelocities.resize(entry.euclideanSteps);
+        for (int step = 0; step < entry.euclideanSteps; ++step)
+        {
+            state.euclideanPattern[step] = scratch.getStep(step);
+            state.euclideanVelocities[step] = scratch.getVelocity(step);
+        }
+
+        timeline->states.push_back(std::move(state));
+
+        // One switch point per repeat so each repeat restarts the pattern on its bar line
+        for (int repeat = 0; repeat < entry.repeats; ++repeat)
+        {
+            PatternChainSwitchPoint point;
+            point.tick = tick;
+            point.stateIndex = i;
+            point.repeatIndex = repeat;
+            timeline->switchPoints.push_back(point);
+
+            tick += static_cast<juce::int64>(entry.lengthInBars) * timeline->ticksPerBar;
+        }
+    }
+
+    timeline->lengthInTicks = tick;
+    publisher.publish(std::move(timeline));
+}
+
+//==============================================================================
+const PreparedChainState* PatternChain::processTick(juce::int64 clockTick)
+{
+    const auto& timeline = publisher.acquire();
+
+    if (timeline.switchPoints.empty() || timeline.lengthInTicks <= 0)
+    {
+        cursorTimeline = &timeline;
+        activeState = nullptr;
+        cursorValid = false;
+        return nullptr;
+    }
+
+    // New timeline or restart: begin the chain on the next bar line
+    if (!cursorValid || cursorTimeline != &timeline)
+    {
+        cursorTimeline = &timeline;
+        activeState = nullptr;
+        nextSwitchIndex = 0;
+
+        const juce::int64 ticksPerBar = timeline.ticksPerBar;
+        loopStartTick = ((clockTick + ticksPerBar - 1) / ticksPerBar) * ticksPerBar;
+        cursorValid = true;
+    }
+
+    const auto& point = timeline.switchPoints[nextSwitchIndex];
+    if (clockTick < loopStartTick + point.tick)
+        return nullptr;
+
+    activeState = &timeline.states[point.stateIndex];
+
+    // Advance the cursor, wrapping to the start of the chain
+    if (++nextSwitchIndex >= timeline.switchPoints.size())
+    {
+        nextSwitchIndex = 0;
+        loopStartTick += timeline.lengthInTicks;
+    }
+
+    return activeState;
+}
+
+const PreparedChainState* PatternChain::getUpcomingState() const
+{
+    if (!cursorValid || cursorTimeline == nullptr || cursorTimeline->switchPoints.empty())
+        return nullptr;
+
+    return &cursorTimeline->states[cursorTimeline->switchPoints[nextSwitchIndex].stateIndex];
+}
+
+void PatternChain::resetPlayback()
+{
+    cursorValid = false;
+    activeState = nullptr;
+}
+
+//==============================================================================
+std::unique_ptr<juce::XmlElement> PatternChain::toXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>("PatternChain");
+
+    for (const auto& entry : entries)
+    {
+        auto* entryXml = xml->createNewChildElement("Entry");
+        entryXml->setAttribute("generatorType", entry.generatorType);
+        entryXml->setAttribute("euclideanSteps", entry.euclideanSteps);
+        entryXml->setAttribute("euclideanPulses", entry.euclideanPulses);
+        entryXml->setAttribute("euclideanRotation", entry.euclideanRotation);
+        entryXml->setAttribute("noteDensity", entry.noteDensity);
+        entryXml->setAttribute("lengthInBars", entry.lengthInBars);
+        entryXml->setAttribute("repeats", entry.repeats);
+    }
+
+    return xml;
+}
+
+void PatternChain::fromXml(const juce::XmlElement& xml)
+{
+    std::vector<PatternChainEntry> loaded;
+
+    for (auto* entryXml : xml.getChildWithTagNameIterator("Entry"))
+    {
+        PatternChainEntry entry;
+        entry.generatorType = entryXml->getIntAttribute("generatorType", 0);
+        entry.euclideanSteps = entryXml->getIntAttribute("euclideanSteps", 16);
+        entry.euclideanPulses = entryXml->getIntAttribute("euclideanPulses", 4);
+        entry.euclideanRotation = entryXml->getIntAttribute("euclideanRotation", 0);
+        entry.noteDensity = static_cast<float>(entryXml->getDoubleAttribute("noteDensity", 0.5));
+        entry.lengthInBars = entryXml->getIntAttribute("lengthInBars", 1);
+        entry.repeats = entryXml->getIntAttribute("repeats", 1);
+        loaded.push_back(entry);
+    }
+
+    setEntries(loaded);
+}
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+    PatternChain.h
+
+    Pattern chain / song mode
+    An ordered list of pattern and engine states with repeat counts, compiled
+    into a flat timeline of switch points in 16th-note ticks. The audio thread
+    consumes the timeline with a cursor at exact tick positions; every engine
+    state is prepared when the chain is compiled, ahead of its switch bar.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../DSP/SnapshotPublisher.h"
+#include <vector>
+
+// ============================================================================
+// Chain Entry (edited on the message thread)
+// ============================================================================
+struct PatternChainEntry
+{
+    int generatorType = 0;          // Same indices as the generatorType parameter
+    int euclideanSteps = 16;
+    int euclideanPulses = 4;
+    int euclideanRotation = 0;
+    float noteDensity = 0.5f;
+
+    int lengthInBars = 1;           // Length of one repeat
+    int repeats = 1;                // Number of times the entry plays before advancing
+};
+
+// ============================================================================
+// Compiled Timeline (immutable, shared with the audio thread)
+// ============================================================================
+struct PreparedChainState
+{
+    PatternChainEntry entry;
+
+    // Euclidean pattern computed at compile time, applied without regeneration
+    std::vector<bool> euclideanPattern;
+    std::vector<float> euclideanVelocities;
+};
+
+struct PatternChainSwitchPoint
+{
+    juce::int64 tick = 0;           // 16th-note ticks from the start of the chain
+    int stateIndex = 0;             // Index into PatternChainTimeline::states
+    int repeatIndex = 0;            // Which repeat of the entry starts here
+};
+
+struct PatternChainTimeline
+{
+    std::vector<PreparedChainState> states;             // One per entry
+    std::vector<PatternChainSwitchPoint> switchPoints;  // Sorted by tick
+    juce::int64 lengthInTicks = 0;                      // Loop length of the whole chain
+    int ticksPerBar = 16;
+};
+
+// ============================================================================
+// Pattern Chain
+// ============================================================================
+class PatternChain
+{
+public:
+    static constexpr int maxEntries = 64;
+
+    PatternChain();
+    ~PatternChain() = default;
+
+    //==============================================================================
+    // Message thread: edits recompile and publish the timeline
+
+    void setEntries(const std::vector<PatternChainEntry>& newEntries);
+    int addEntry(const PatternChainEntry& entry);
+    void removeEntry(int entryIndex);
+    void clear();
+
+    const std::vector<PatternChainEntry>& getEntries() const { return entries; }
+    int getNumEntries() const { return static_cast<int>(entries.size()); }
+
+    void setTimeSignature(int numerator, int denominator);
+
+    // Reclaims superseded timelines (call periodically from the message thread)
+    void collectGarbage() { publisher.collectGarbage(); }
+
+    // Serialization
+    std::unique_ptr<juce::XmlElement> toXml() const;
+    void fromXml(const juce::XmlElement& xml);
+
+    //==============================================================================
+    // Audio thread
+
+    /**
+     * Advance the cursor to an absolute clock tick.
+     * Returns the state to switch to when the tick is a switch point, otherwise nullptr.
+     * The chain starts on the first bar line after it is enabled or recompiled.
+     */
+    const PreparedChainState* processTick(juce::int64 clockTick);
+
+    // State currently playing (nullptr before the first switch)
+    const PreparedChainState* getActiveState() const { return activeState; }
+
+    // State that takes over at the next switch point (nullptr if none)
+    const PreparedChainState* getUpcomingState() const;
+
+    // Forget the cursor so the chain restarts on the next bar line
+    void resetPlayback();
+
+private:
+    void compileAndPublish();
+
+    std::vector<PatternChainEntry> entries;
+    int timeSignatureNum = 4;
+    int timeSignatureDenom = 4;
+
+    SnapshotPublisher<PatternChainTimeline> publisher;
+
+    // Audio-owned cursor
+    const PatternChainTimeline* cursorTimeline = nullptr;
+    const PreparedChainState* activeState = nullptr;
+    juce::int64 loopStartTick = 0;
+    int nextSwitchIndex = 0;
+    bool cursorValid = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatternChain)
+};
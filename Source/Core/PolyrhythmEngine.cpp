@@ -10,136 +10,413 @@
 #include "PolyrhythmEngine.h"
 
 PolyrhythmEngine::PolyrhythmEngine()
+    : publisher(std::make_unique<PolyrhythmSnapshot>())
 {
+    for (auto& step : currentSteps)
+        step.store(0, std::memory_order_relaxed);
+
     // Create default layer
     addLayer();
 }
 
+template <typename EditFunction>
+void PolyrhythmEngine::publishEdit(EditFunction&& edit)
+{
+    auto next = publisher.copyLatest();
+    if (edit(*next))
+        publisher.publish(std::move(next));
+}
+
 int PolyrhythmEngine::addLayer()
 {
-    PolyrhythmLayer layer;
-    layer.resize(16);
-    layers.push_back(layer);
-    return layers.size() - 1;
+    int newIndex = -1;
+
+    publishEdit([&newIndex](PolyrhythmSnapshot& snapshot) {
+        if (snapshot.layers.size() >= maxLayers)
+            return false;
+
+        PolyrhythmLayer layer;
+        layer.id = snapshot.nextLayerID++;
+        layer.resize(16);
+        snapshot.layers.push_back(layer);
+        newIndex = static_cast<int>(snapshot.layers.size()) - 1;
+        return true;
+    });
+
+    return newIndex;
 }
 
 void PolyrhythmEngine::removeLayer(int layerIndex)
 {
-    if (layerIndex >= 0 && layerIndex < layers.size())
-        layers.erase(layers.begin() + layerIndex);
+    publishEdit([layerIndex](PolyrhythmSnapshot& snapshot) {
+        if (layerIndex < 0 || layerIndex >= snapshot.layers.size())
+            return false;
+
+        snapshot.layers.erase(snapshot.layers.begin() + layerIndex);
+        return true;
+    });
 }
 
-PolyrhythmLayer* PolyrhythmEngine::getLayer(int layerIndex)
+const PolyrhythmLayer* PolyrhythmEngine::getLayer(int layerIndex) const
 {
+    const auto& layers = publisher.getLatest().layers;
     if (layerIndex >= 0 && layerIndex < layers.size())
         return &layers[layerIndex];
     return nullptr;
 }
 
+void PolyrhythmEngine::editLayer(int layerIndex, const std::function<void(PolyrhythmLayer&)>& edit)
+{
+    publishEdit([layerIndex, &edit](PolyrhythmSnapshot& snapshot) {
+        if (layerIndex < 0 || layerIndex >= snapshot.layers.size())
+            return false;
+
+        edit(snapshot.layers[layerIndex]);
+        return true;
+    });
+}
+
 void PolyrhythmEngine::setLayerDivision(int layerIndex, int division)
 {
-    auto* layer = getLayer(layerIndex);
-    if (layer)
-        layer->division = juce::jlimit(1, 64, division);
+    editLayer(layerIndex, [division](PolyrhythmLayer& layer) {
+        layer.division = juce::jlimit(1, 64, division);
+    });
 }
 
 void PolyrhythmEngine::setLayerLength(int layerIndex, int length)
 {
-    auto* layer = getLayer(layerIndex);
-    if (layer)
-        layer->resize(juce::jlimit(1, 128, length));
+    editLayer(layerIndex, [length](PolyrhythmLayer& layer) {
+        layer.resize(juce::jlimit(1, 128, length));
+    });
 }
 
 void PolyrhythmEngine::setLayerPhase(int layerIndex, float phase)
 {
-    auto* layer = getLayer(layerIndex);
-    if (layer)
-        layer->phase = juce::jlimit(0.0f, 1.0f, phase);
+    editLayer(layerIndex, [phase](PolyrhythmLayer& layer) {
+        layer.phase = juce::jlimit(0.0f, 1.0f, phase);
+    });
 }
 
 void PolyrhythmEngine::setLayerEnabled(int layerIndex, bool enabled)
 {
-    auto* layer = getLayer(layerIndex);
-    if (layer)
-        layer->enabled = enabled;
+    editLayer(layerIndex, [enabled](PolyrhythmLayer& layer) {
+        layer.enabled = enabled;
+    });
+}
+
+void PolyrhythmEngine::setLayerRouting(int layerIndex, const PolyrhythmLayerRouting& routing)
+{
+    editLayer(layerIndex, [routing](PolyrhythmLayer& layer) {
+        layer.routing.midiChannel = juce::jlimit(0, 16, routing.midiChannel);
+        layer.routing.gateLength = routing.gateLength > 0.0f ? juce::jlimit(0.01f, 2.0f, routing.gateLength) : 0.0f;
+        layer.routing.useGlobalRatchet = routing.useGlobalRatchet;
+        layer.routing.ratchet.count = juce::jlimit(1, 16, routing.ratchet.count);
+        layer.routing.ratchet.probability = juce::jlimit(0.0f, 1.0f, routing.ratchet.probability);
+        layer.routing.ratchet.velocityDecay = juce::jlimit(0.0f, 1.0f, routing.ratchet.velocityDecay);
+        layer.routing.useGlobalVelocityRange = routing.useGlobalVelocityRange;
+        layer.routing.velocityMin = juce::jlimit(0.0f, 1.0f, juce::jmin(routing.velocityMin, routing.velocityMax));
+        layer.routing.velocityMax = juce::jlimit(0.0f, 1.0f, juce::jmax(routing.velocityMin, routing.velocityMax));
+    });
+}
+
+void PolyrhythmEngine::setLayerMidiChannel(int layerIndex, int channel)
+{
+    editLayer(layerIndex, [channel](PolyrhythmLayer& layer) {
+        layer.routing.midiChannel = juce::jlimit(0, 16, channel);
+    });
+}
+
+void PolyrhythmEngine::setLayerGateLength(int layerIndex, float gateLength)
+{
+    editLayer(layerIndex, [gateLength](PolyrhythmLayer& layer) {
+        layer.routing.gateLength = gateLength > 0.0f ? juce::jlimit(0.01f, 2.0f, gateLength) : 0.0f;
+    });
+}
+
+void PolyrhythmEngine::setLayerRatchet(int layerIndex, const RatchetProfile& profile)
+{
+    editLayer(layerIndex, [profile](PolyrhythmLayer& layer) {
+        layer.routing.useGlobalRatchet = false;
+        layer.routing.ratchet.count = juce::jlimit(1, 16, profile.count);
+        layer.routing.ratchet.probability = juce::jlimit(0.0f, 1.0f, profile.probability);
+        layer.routing.ratchet.velocityDecay = juce::jlimit(0.0f, 1.0f, profile.velocityDecay);
+    });
+}
+
+void PolyrhythmEngine::setLayerVelocityRange(int layerIndex, float minVelocity, float maxVelocity)
+{
+    editLayer(layerIndex, [minVelocity, maxVelocity](PolyrhythmLayer& layer) {
+        layer.routing.useGlobalVelocityRange = false;
+        layer.routing.velocityMin = juce::jlimit(0.0f, 1.0f, juce::jmin(minVelocity, maxVelocity));
+        layer.routing.velocityMax = juce::jlimit(0.0f, 1.0f, juce::jmax(minVelocity, maxVelocity));
+    });
 }
 
 void PolyrhythmEngine::setStep(int layerIndex, int stepIndex, bool active, float velocity, int pitch)
 {
-    auto* layer = getLayer(layerIndex);
-    if (layer && stepIndex >= 0 && stepIndex < layer->length)
-    {
-        layer->pattern[stepIndex] = active;
-        layer->velocities[stepIndex] = juce::jlimit(0.0f, 1.0f, velocity);
-        layer->pitches[stepIndex] = juce::jlimit(0, 127, pitch);
-    }
+    editLayer(layerIndex, [=](PolyrhythmLayer& layer) {
+        if (stepIndex >= 0 && stepIndex < layer.length)
+        {
+            layer.pattern[stepIndex] = active;
+            layer.velocities[stepIndex] = juce::jlimit(0.0f, 1.0f, velocity);
+            layer.pitches[stepIndex] = juce::jlimit(0, 127, pitch);
+        }
+    });
+}
+
+void PolyrhythmEngine::setStepCondition(int layerIndex, int stepIndex, juce::uint32 conditionFlags, int ratioA, int ratioB)
+{
+    editLayer(layerIndex, [=](PolyrhythmLayer& layer) {
+        layer.conditions.setCondition(stepIndex, conditionFlags, ratioA, ratioB);
+    });
+}
+
+void PolyrhythmEngine::setStepProbability(int layerIndex, int stepIndex, float probability)
+{
+    editLayer(layerIndex, [=](PolyrhythmLayer& layer) {
+        layer.conditions.setProbability(stepIndex, probability);
+    });
+}
+
+void PolyrhythmEngine::setStepParameterLocks(int layerIndex, int stepIndex, const StepParameterLocks& locks)
+{
+    editLayer(layerIndex, [=](PolyrhythmLayer& layer) {
+        layer.conditions.setParameterLocks(stepIndex, locks);
+    });
+}
+
+void PolyrhythmEngine::setStepNudge(int layerIndex, int stepIndex, float fractionOfStep)
+{
+    editLayer(layerIndex, [=](PolyrhythmLayer& layer) {
+        layer.microtiming.setNudge(stepIndex, fractionOfStep);
+    });
+}
+
+void PolyrhythmEngine::setStepNudgeTicks(int layerIndex, int stepIndex, int ticks)
+{
+    editLayer(layerIndex, [=](PolyrhythmLayer& layer) {
+        layer.microtiming.setNudgeTicks(stepIndex, ticks);
+    });
 }
 
 void PolyrhythmEngine::clearLayer(int layerIndex)
 {
-    auto* layer = getLayer(layerIndex);
-    if (layer)
+    editLayer(layerIndex, [](PolyrhythmLayer& layer) {
+        std::fill(layer.pattern.begin(), layer.pattern.end(), false);
+        std::fill(layer.velocities.begin(), layer.velocities.end(), 0.8f);
+        std::fill(layer.pitches.begin(), layer.pitches.end(), 60);
+        layer.conditions.clear();
+    });
+}
+
+void PolyrhythmEngine::randomizeLayer(int layerIndex, float density)
+{
+    density = juce::jlimit(0.0f, 1.0f, density);
+
+    editLayer(layerIndex, [this, density](PolyrhythmLayer& layer) {
+        for (int i = 0; i < layer.length; ++i)
+        {
+            layer.pattern[i] = random.nextFloat() < density;
+
+            if (layer.pattern[i])
+            {
+                layer.velocities[i] = 0.5f + random.nextFloat() * 0.5f; // 0.5 - 1.0
+                layer.pitches[i] = 36 + random.nextInt(49); // C2 - C6
+            }
+        }
+    });
+}
+
+std::unique_ptr<juce::XmlElement> PolyrhythmEngine::stepLanesToXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>("PolyrhythmStepLanes");
+    const auto& layers = publisher.getLatest().layers;
+
+    for (size_t i = 0; i < layers.size(); ++i)
     {
-        std::fill(layer->pattern.begin(), layer->pattern.end(), false);
-        std::fill(layer->velocities.begin(), layer->velocities.end(), 0.8f);
-        std::fill(layer->pitches.begin(), layer->pitches.end(), 60);
+        auto* layerXml = xml->createNewChildElement("Layer");
+        layerXml->setAttribute("index", static_cast<int>(i));
+        layerXml->addChildElement(layers[i].conditions.toXml().release());
+        layerXml->addChildElement(layers[i].microtiming.toXml().release());
     }
+
+    return xml;
 }
 
-void PolyrhythmEngine::randomizeLayer(int layerIndex, float density)
+void PolyrhythmEngine::stepLanesFromXml(const juce::XmlElement& xml)
+{
+    publishEdit([&xml](PolyrhythmSnapshot& snapshot) {
+        for (auto& layer : snapshot.layers)
+        {
+            layer.conditions.clear();
+            layer.microtiming.clear();
+        }
+
+        for (auto* layerXml : xml.getChildWithTagNameIterator("Layer"))
+        {
+            const int index = layerXml->getIntAttribute("index", -1);
+            if (!juce::isPositiveAndBelow(index, static_cast<int>(snapshot.layers.size())))
+                continue;
+
+            if (auto* conditionsXml = layerXml->getChildByName("StepConditions"))
+                snapshot.layers[index].conditions.fromXml(*conditionsXml);
+
+            if (auto* microtimingXml = layerXml->getChildByName("Microtiming"))
+                snapshot.layers[index].microtiming.fromXml(*microtimingXml);
+        }
+        return true;
+    });
+}
+
+void PolyrhythmEngine::setTimeSignature(int numerator, int denominator)
+{
+    publishEdit([numerator, denominator](PolyrhythmSnapshot& snapshot) {
+        snapshot.timeSignatureNum = juce::jlimit(1, 32, numerator);
+        snapshot.timeSignatureDenom = juce::jlimit(1, 32, denominator);
+        return true;
+    });
+}
+
+void PolyrhythmEngine::setTempo(double bpm)
 {
-    auto* layer = getLayer(layerIndex);
-    if (!layer)
+    publishEdit([bpm](PolyrhythmSnapshot& snapshot) {
+        snapshot.tempo = juce::jlimit(20.0, 400.0, bpm);
+        return true;
+    });
+}
+
+//==============================================================================
+const PolyrhythmSnapshot& PolyrhythmEngine::acquireSnapshot() noexcept
+{
+    const auto& snapshot = publisher.acquire();
+    remapPlaybackSlots(snapshot);
+    return snapshot;
+}
+
+void PolyrhythmEngine::remapPlaybackSlots(const PolyrhythmSnapshot& snapshot) noexcept
+{
+    const int numLayers = juce::jmin(static_cast<int>(snapshot.layers.size()), maxLayers);
+
+    bool unchanged = true;
+    for (int i = 0; i < numLayers && unchanged; ++i)
+        unchanged = slotLayerIDs[i] == snapshot.layers[i].id;
+
+    if (unchanged)
         return;
 
-    density = juce::jlimit(0.0f, 1.0f, density);
+    // A layer keeps its step and condition counters at its new index; new layers start fresh
+    const auto previousIDs = slotLayerIDs;
+    std::array<int, maxLayers> previousSteps {};
+    std::array<StepConditionState, maxLayers> previousStates {};
+    for (int j = 0; j < maxLayers; ++j)
+    {
+        previousSteps[j] = currentSteps[j].load(std::memory_order_relaxed);
+        previousStates[j] = conditionStates[j];
+    }
 
-    for (int i = 0; i < layer->length; ++i)
+    for (int i = 0; i < numLayers; ++i)
     {
-        layer->pattern[i] = random.nextFloat() < density;
+        const auto& layer = snapshot.layers[i];
+        if (previousIDs[i] == layer.id)
+            continue;
 
-        if (layer->pattern[i])
+        int previousSlot = -1;
+        for (int j = 0; j < maxLayers && previousSlot < 0; ++j)
+            if (previousIDs[j] == layer.id)
+                previousSlot = j;
+
+        if (previousSlot >= 0)
+        {
+            currentSteps[i].store(previousSteps[previousSlot], std::memory_order_relaxed);
+            conditionStates[i] = previousStates[previousSlot];
+        }
+        else
         {
-            layer->velocities[i] = 0.5f + random.nextFloat() * 0.5f; // 0.5 - 1.0
-            layer->pitches[i] = 36 + random.nextInt(49); // C2 - C6
+            currentSteps[i].store(static_cast<int>(layer.phase * layer.length), std::memory_order_relaxed);
+            conditionStates[i].reset();
         }
+
+        microtimingTables[i] = MicrotimingTable();   // Rebuilt from this layer's lane on next use
+        slotLayerIDs[i] = layer.id;
     }
+
+    for (int i = numLayers; i < maxLayers; ++i)
+        slotLayerIDs[i] = 0;
 }
 
 void PolyrhythmEngine::advance(int layerIndex, int subdivisions)
 {
-    auto* layer = getLayer(layerIndex);
-    if (!layer || !layer->enabled)
+    const auto& snapshot = acquireSnapshot();
+    if (layerIndex < 0 || layerIndex >= snapshot.layers.size())
+        return;
+
+    const auto& layer = snapshot.layers[layerIndex];
+    if (!layer.enabled)
         return;
 
     // Calculate effective subdivisions based on division
-    int effectiveSubdivisions = (subdivisions * layer->division) / (timeSignatureDenom / 4);
+    int effectiveSubdivisions = (subdivisions * layer.division) / juce::jmax(1, snapshot.timeSignatureDenom / 4);
+
+    int step = getCurrentStep(layerIndex, layer.length);
+    currentSteps[layerIndex].store((step + effectiveSubdivisions) % layer.length, std::memory_order_relaxed);
+}
+
+void PolyrhythmEngine::advanceStep(int layerIndex, const PolyrhythmLayer& layer) noexcept
+{
+    if (layerIndex < 0 || layerIndex >= maxLayers)
+        return;
 
-    layer->currentStep = (layer->currentStep + effectiveSubdivisions) % layer->length;
+    int step = getCurrentStep(layerIndex, layer.length);
+    currentSteps[layerIndex].store((step + 1) % layer.length, std::memory_order_relaxed);
 }
 
 void PolyrhythmEngine::reset()
 {
-    for (auto& layer : layers)
+    const auto& snapshot = acquireSnapshot();
+
+    for (int i = 0; i < maxLayers; ++i)
     {
-        layer.currentStep = static_cast<int>(layer.phase * layer.length);
+        int step = 0;
+        if (i < snapshot.layers.size())
+            step = static_cast<int>(snapshot.layers[i].phase * snapshot.layers[i].length);
+        currentSteps[i].store(step, std::memory_order_relaxed);
+        conditionStates[i].reset();
     }
 }
 
 void PolyrhythmEngine::resetLayer(int layerIndex)
 {
-    auto* layer = getLayer(layerIndex);
-    if (layer)
-        layer->currentStep = static_cast<int>(layer->phase * layer->length);
+    const auto& snapshot = acquireSnapshot();
+    if (layerIndex >= 0 && layerIndex < snapshot.layers.size())
+    {
+        const auto& layer = snapshot.layers[layerIndex];
+        currentSteps[layerIndex].store(static_cast<int>(layer.phase * layer.length), std::memory_order_relaxed);
+        conditionStates[layerIndex].reset();
+    }
 }
 
-void PolyrhythmEngine::setTimeSignature(int numerator, int denominator)
+StepConditionState& PolyrhythmEngine::getConditionState(int layerIndex) noexcept
 {
-    timeSignatureNum = juce::jlimit(1, 32, numerator);
-    timeSignatureDenom = juce::jlimit(1, 32, denominator);
+    return conditionStates[juce::jlimit(0, maxLayers - 1, layerIndex)];
 }
 
-void PolyrhythmEngine::setTempo(double bpm)
+MicrotimingTable& PolyrhythmEngine::getMicrotimingTable(int layerIndex) noexcept
+{
+    return microtimingTables[juce::jlimit(0, maxLayers - 1, layerIndex)];
+}
+
+int PolyrhythmEngine::getCurrentStep(int layerIndex, int layerLength) const noexcept
+{
+    if (layerIndex < 0 || layerIndex >= maxLayers || layerLength <= 0)
+        return 0;
+
+    // Layer length may have shrunk since the step was stored
+    return currentSteps[layerIndex].load(std::memory_order_relaxed) % layerLength;
+}
+
+int PolyrhythmEngine::getCurrentStep(int layerIndex) const noexcept
 {
-    tempo = juce::jlimit(20.0, 400.0, bpm);
+    if (layerIndex < 0 || layerIndex >= maxLayers)
+        return 0;
+    return currentSteps[layerIndex].load(std::memory_order_relaxed);
 }
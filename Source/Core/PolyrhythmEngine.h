@@ -5,16 +5,42 @@
     Polyrhythmic and polymeter sequencing engine
     Supports multiple simultaneous time divisions and phase relationships
 
+    Threading: layer configuration is edited on the message thread and
+    published to the audio thread as immutable snapshots. Playback state
+    (the current step of each layer) is owned by the audio thread and is
+    kept with its layer, by layer ID, when layers are added or removed.
+
   ==============================================================================
 */
 
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "RatchetEngine.h"
+#include "StepConditions.h"
+#include "MicrotimingLane.h"
+#include "../DSP/SnapshotPublisher.h"
+#include <array>
+#include <atomic>
 #include <vector>
 
+// Per-layer output routing, so each layer can drive a different synth
+struct PolyrhythmLayerRouting
+{
+    int midiChannel = 0;            // 1-16, 0 = follow the global MIDI channel
+    float gateLength = 0.0f;        // Fraction of a step, 0 = follow the global gate length
+
+    bool useGlobalRatchet = true;
+    RatchetProfile ratchet;
+
+    bool useGlobalVelocityRange = true;
+    float velocityMin = 0.0f;
+    float velocityMax = 1.0f;
+};
+
 struct PolyrhythmLayer
 {
+    juce::uint32 id = 0;        // Stable identity, assigned by addLayer()
     int division = 4;           // Time division (e.g., 4 = quarter notes)
     int length = 16;            // Pattern length in subdivisions
     float phase = 0.0f;         // Phase offset (0.0 - 1.0)
@@ -24,7 +50,9 @@ struct PolyrhythmLayer
     std::vector<float> velocities;
     std::vector<int> pitches;   // MIDI note numbers
 
-    int currentStep = 0;
+    PolyrhythmLayerRouting routing;
+    StepConditionLane conditions;   // Per-step probability, conditions and parameter locks
+    MicrotimingLane microtiming;    // Per-step timing nudges
 
     void resize(int newLength)
     {
@@ -35,17 +63,32 @@ struct PolyrhythmLayer
     }
 };
 
+// Immutable engine configuration shared with the audio thread
+struct PolyrhythmSnapshot
+{
+    std::vector<PolyrhythmLayer> layers;
+    int timeSignatureNum = 4;
+    int timeSignatureDenom = 4;
+    double tempo = 120.0;
+    juce::uint32 nextLayerID = 1;
+};
+
 class PolyrhythmEngine
 {
 public:
+    static constexpr int maxLayers = 16;
+
     PolyrhythmEngine();
     ~PolyrhythmEngine() = default;
 
+    //==============================================================================
+    // Message thread: every edit copies the latest snapshot and publishes it
+
     // Layer management
     int addLayer();
     void removeLayer(int layerIndex);
-    PolyrhythmLayer* getLayer(int layerIndex);
-    int getNumLayers() const { return layers.size(); }
+    const PolyrhythmLayer* getLayer(int layerIndex) const;
+    int getNumLayers() const { return static_cast<int>(publisher.getLatest().layers.size()); }
 
     // Layer configuration
     void setLayerDivision(int layerIndex, int division);
@@ -53,25 +96,78 @@ public:
     void setLayerPhase(int layerIndex, float phase);
     void setLayerEnabled(int layerIndex, bool enabled);
 
+    // Layer routing
+    void setLayerRouting(int layerIndex, const PolyrhythmLayerRouting& routing);
+    void setLayerMidiChannel(int layerIndex, int channel);
+    void setLayerGateLength(int layerIndex, float gateLength);
+    void setLayerRatchet(int layerIndex, const RatchetProfile& profile);
+    void setLayerVelocityRange(int layerIndex, float minVelocity, float maxVelocity);
+
     // Pattern editing
     void setStep(int layerIndex, int stepIndex, bool active, float velocity = 0.8f, int pitch = 60);
     void clearLayer(int layerIndex);
     void randomizeLayer(int layerIndex, float density);
 
+    // Per-step probability, conditional trigs and parameter locks
+    void setStepCondition(int layerIndex, int stepIndex, juce::uint32 conditionFlags, int ratioA = 1, int ratioB = 1);
+    void setStepProbability(int layerIndex, int stepIndex, float probability);
+    void setStepParameterLocks(int layerIndex, int stepIndex, const StepParameterLocks& locks);
+
+    // Per-step microtiming (fraction of a step, -0.5 to +0.5)
+    void setStepNudge(int layerIndex, int stepIndex, float fractionOfStep);
+    void setStepNudgeTicks(int layerIndex, int stepIndex, int ticks);
+
+    // Per-step lanes of every layer, by layer index (saved with the plugin state)
+    std::unique_ptr<juce::XmlElement> stepLanesToXml() const;
+    void stepLanesFromXml(const juce::XmlElement& xml);
+
+    // Edits several fields of one layer and publishes them as a single snapshot
+    void editLayer(int layerIndex, const std::function<void(PolyrhythmLayer&)>& edit);
+
+    // Time signature
+    void setTimeSignature(int numerator, int denominator);
+    void setTempo(double bpm);
+
+    // Reclaims superseded snapshots (call periodically from the message thread)
+    void collectGarbage() { publisher.collectGarbage(); }
+
+    //==============================================================================
+    // Audio thread
+
+    // Newest configuration; valid until the next call to acquireSnapshot().
+    // Moves playback state to follow layers that changed index.
+    const PolyrhythmSnapshot& acquireSnapshot() noexcept;
+
     // Playback
     void advance(int layerIndex, int subdivisions);
+    void advanceStep(int layerIndex, const PolyrhythmLayer& layer) noexcept;
     void reset();
     void resetLayer(int layerIndex);
 
-    // Time signature
-    void setTimeSignature(int numerator, int denominator);
-    void setTempo(double bpm);
+    // Condition playback state of a layer (cycle counter, previous-fired flag)
+    StepConditionState& getConditionState(int layerIndex) noexcept;
+
+    // Swing + nudge offset table of a layer
+    MicrotimingTable& getMicrotimingTable(int layerIndex) noexcept;
+
+    // Current step wrapped to the layer length (safe from any thread)
+    int getCurrentStep(int layerIndex, int layerLength) const noexcept;
+    int getCurrentStep(int layerIndex) const noexcept;
 
 private:
-    std::vector<PolyrhythmLayer> layers;
-    int timeSignatureNum = 4;
-    int timeSignatureDenom = 4;
-    double tempo = 120.0;
+    template <typename EditFunction>
+    void publishEdit(EditFunction&& edit);
+
+    // Audio thread: re-key playback slots after layers were added or removed
+    void remapPlaybackSlots(const PolyrhythmSnapshot& snapshot) noexcept;
+
+    SnapshotPublisher<PolyrhythmSnapshot> publisher;
+
+    // Audio-owned playback position, read by the UI for display only
+    std::array<std::atomic<int>, maxLayers> currentSteps {};
+    std::array<StepConditionState, maxLayers> conditionStates {};
+    std::array<MicrotimingTable, maxLayers> microtimingTables {};
+    std::array<juce::uint32, maxLayers> slotLayerIDs {};   // Layer each slot's state belongs to
 
     juce::Random random;
 
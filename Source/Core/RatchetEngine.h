@@ -14,6 +14,14 @@
 #include <random>
 #include <chrono>
 
+// Ratchet settings that can be applied per note source (e.g. per polyrhythm layer)
+struct RatchetProfile
+{
+    int count = 1;                  // Number of repeats (1 = no ratcheting)
+    float probability = 0.0f;       // Chance of ratcheting (0-1)
+    float velocityDecay = 0.5f;     // Velocity reduction per repeat
+};
+
 class RatchetEngine
 {
 public:
@@ -61,10 +69,18 @@ public:
      */
     bool shouldRatchet()
     {
-        if (ratchetCount <= 1 || ratchetProbability <= 0.0f)
+        return shouldRatchet(getProfile());
+    }
+
+    /**
+     * Check if ratcheting occurs for an explicit profile
+     */
+    bool shouldRatchet(const RatchetProfile& profile)
+    {
+        if (profile.count <= 1 || profile.probability <= 0.0f)
             return false;
 
-        return distribution(generator) < ratchetProbability;
+        return distribution(generator) < profile.probability;
     }
 
     /**
@@ -73,10 +89,18 @@ public:
      * @return Vector of sample offsets for each ratchet repeat
      */
     std::vector<int> calculateRatchetOffsets(int samplesPerStep) const
+    {
+        return calculateRatchetOffsets(samplesPerStep, ratchetCount);
+    }
+
+    /**
+     * Calculate ratchet timing offsets for an explicit repeat count
+     */
+    std::vector<int> calculateRatchetOffsets(int samplesPerStep, int count) const
     {
         std::vector<int> offsets;
 
-        if (ratchetCount <= 1)
+        if (count <= 1)
         {
             offsets.push_back(0); // No ratcheting, single trigger
             return offsets;
@@ -87,9 +111,9 @@ public:
         // 1 = 32nd notes (2x subdivision)
         // 2 = 64th notes (4x subdivision)
         int subdivisionMultiplier = 1 << ratchetDivision; // 1, 2, or 4
-        int samplesPerRatchet = samplesPerStep / (ratchetCount * subdivisionMultiplier);
+        int samplesPerRatchet = samplesPerStep / (count * subdivisionMultiplier);
 
-        for (int i = 0; i < ratchetCount; ++i)
+        for (int i = 0; i < count; ++i)
         {
             offsets.push_back(i * samplesPerRatchet * subdivisionMultiplier);
         }
@@ -105,11 +129,19 @@ public:
      */
     float calculateRatchetVelocity(float baseVelocity, int ratchetIndex) const
     {
-        if (ratchetIndex == 0 || velocityDecay <= 0.0f)
+        return calculateRatchetVelocity(baseVelocity, ratchetIndex, velocityDecay);
+    }
+
+    /**
+     * Calculate velocity for a ratchet repeat with an explicit decay amount
+     */
+    float calculateRatchetVelocity(float baseVelocity, int ratchetIndex, float decay) const
+    {
+        if (ratchetIndex == 0 || decay <= 0.0f)
             return baseVelocity;
 
         // Apply exponential decay: velocity = base * (1 - decay)^index
-        float decayFactor = std::pow(1.0f - velocityDecay, static_cast<float>(ratchetIndex));
+        float decayFactor = std::pow(1.0f - decay, static_cast<float>(ratchetIndex));
         float newVelocity = baseVelocity * decayFactor;
 
         return juce::jlimit(0.01f, 1.0f, newVelocity);
@@ -135,6 +167,11 @@ public:
      */
     float getVelocityDecay() const { return velocityDecay; }
 
+    /**
+     * Get the global settings as a profile
+     */
+    RatchetProfile getProfile() const { return { ratchetCount, ratchetProbability, velocityDecay }; }
+
 private:
     int ratchetCount = 1;              // Number of repeats (1 = no ratcheting)
     int ratchetDivision = 0;           // 0=16th, 1=32nd, 2=64th
@@ -0,0 +1,202 @@
+#include "SimplexNoise.h"
+
+namespace
+{
+    constexpr float skew2D = 0.36602540378f;      // (sqrt(3) - 1) / 2
+    constexpr float unskew2D = 0.21132486540f;    // (3 - sqrt(3)) / 6
+
+    // Output scales that map each kernel's extreme values to about +/-1
+    constexpr float scale1D = 3.2f;
+    constexpr float scale2D = 72.0f;
+
+    constexpr float secondaryOffset = 1000.0f;   // Channel offset along the time axis
+    constexpr float octaveRowSpacing = 100.0f;   // Octaves sample separate rows of the 2D field
+
+    // floor() for the int range, without a libm call
+    inline int32_t fastFloor(float x)
+    {
+        const auto truncated = static_cast<int32_t>(x);
+        return truncated - static_cast<int32_t>(x < static_cast<float>(truncated));
+    }
+
+    inline uint32_t hashLattice(int32_t i, int32_t j, uint32_t seed)
+    {
+        uint32_t h = static_cast<uint32_t>(i) * 0x27D4EB2Du ^ static_cast<uint32_t>(j) * 0x165667B1u ^ seed;
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    // Gradient component in [-1, 1] from 8 bits of a hash
+    inline float gradientComponent(uint32_t bits)
+    {
+        return static_cast<float>(bits & 0xffu) * (2.0f / 255.0f) - 1.0f;
+    }
+
+    // Corner falloff max(0, t)^4, with max() written as (t + |t|) / 2 to keep the loop branch-free
+    inline float falloff(float t)
+    {
+        t = 0.5f * (t + std::abs(t));
+        t *= t;
+        return t * t;
+    }
+
+    // fBm amplitudes and their normalisation per octave count
+    struct OctaveTable
+    {
+        std::array<float, SimplexNoise::maxOctaves> frequency {};
+        std::array<float, SimplexNoise::maxOctaves> amplitude {};
+        std::array<float, SimplexNoise::maxOctaves + 1> inverseTotal {};
+
+        OctaveTable()
+        {
+            float total = 0.0f;
+            for (int k = 0; k < SimplexNoise::maxOctaves; ++k)
+            {
+                frequency[static_cast<size_t>(k)] = std::ldexp(1.0f, k);
+                amplitude[static_cast<size_t>(k)] = std::ldexp(1.0f, -k);
+                total += amplitude[static_cast<size_t>(k)];
+                inverseTotal[static_cast<size_t>(k + 1)] = 1.0f / total;
+            }
+        }
+    };
+
+    const OctaveTable& getOctaveTable()
+    {
+        static const OctaveTable table;
+        return table;
+    }
+}
+
+// ============================================================================
+// Kernels
+// ============================================================================
+
+void SimplexNoise::noise1D(const float* x, float* out, int count) const
+{
+    for (int n = 0; n < count; ++n)
+    {
+        const int32_t i0 = fastFloor(x[n]);
+        const float x0 = x[n] - static_cast<float>(i0);
+        const float x1 = x0 - 1.0f;
+
+        const float g0 = gradientComponent(hashLattice(i0, 0, seed));
+        const float g1 = gradientComponent(hashLattice(i0 + 1, 0, seed));
+
+        const float n0 = falloff(1.0f - x0 * x0) * g0 * x0;
+        const float n1 = falloff(1.0f - x1 * x1) * g1 * x1;
+        out[n] = scale1D * (n0 + n1);
+    }
+}
+
+void SimplexNoise::noise2D(const float* x, const float* y, float* out, int count) const
+{
+    for (int n = 0; n < count; ++n)
+    {
+        // Skew to find the simplex cell
+        const float s = (x[n] + y[n]) * skew2D;
+        const int32_t i = fastFloor(x[n] + s);
+        const int32_t j = fastFloor(y[n] + s);
+        const float t = static_cast<float>(i + j) * unskew2D;
+        const float x0 = x[n] - (static_cast<float>(i) - t);
+        const float y0 = y[n] - (static_cast<float>(j) - t);
+
+        // Middle corner: lower or upper triangle of the cell
+        const int32_t i1 = static_cast<int32_t>(x0 > y0);
+        const int32_t j1 = 1 - i1;
+
+        const float x1 = x0 - static_cast<float>(i1) + unskew2D;
+        const float y1 = y0 - static_cast<float>(j1) + unskew2D;
+        const float x2 = x0 - 1.0f + 2.0f * unskew2D;
+        const float y2 = y0 - 1.0f + 2.0f * unskew2D;
+
+        const uint32_t h0 = hashLattice(i, j, seed);
+        const uint32_t h1 = hashLattice(i + i1, j + j1, seed);
+        const uint32_t h2 = hashLattice(i + 1, j + 1, seed);
+
+        const float n0 = falloff(0.5f - x0 * x0 - y0 * y0)
+                       * (gradientComponent(h0) * x0 + gradientComponent(h0 >> 8) * y0);
+        const float n1 = falloff(0.5f - x1 * x1 - y1 * y1)
+                       * (gradientComponent(h1) * x1 + gradientComponent(h1 >> 8) * y1);
+        const float n2 = falloff(0.5f - x2 * x2 - y2 * y2)
+                       * (gradientComponent(h2) * x2 + gradientComponent(h2 >> 8) * y2);
+
+        out[n] = scale2D * (n0 + n1 + n2);
+    }
+}
+
+// ============================================================================
+// Fractal Noise
+// ============================================================================
+
+void SimplexNoise::fractal(float t, int octaves, float& primary, float& secondary) const
+{
+    const auto& table = getOctaveTable();
+    octaves = std::clamp(octaves, 1, maxOctaves);
+
+    // Lanes [0, octaves) are the primary channel, [octaves, 2 * octaves) the secondary
+    std::array<float, maxBatch> x {}, y {}, value {};
+    for (int k = 0; k < octaves; ++k)
+    {
+        const auto lane = static_cast<size_t>(k);
+        x[lane] = t * table.frequency[lane];
+        x[lane + static_cast<size_t>(octaves)] = x[lane] + secondaryOffset;
+        y[lane] = y[lane + static_cast<size_t>(octaves)] = static_cast<float>(k) * octaveRowSpacing;
+    }
+
+    noise2D(x.data(), y.data(), value.data(), 2 * octaves);
+
+    float sumPrimary = 0.0f, sumSecondary = 0.0f;
+    for (int k = 0; k < octaves; ++k)
+    {
+        const auto lane = static_cast<size_t>(k);
+        sumPrimary += value[lane] * table.amplitude[lane];
+        sumSecondary += value[lane + static_cast<size_t>(octaves)] * table.amplitude[lane];
+    }
+
+    const float normalise = table.inverseTotal[static_cast<size_t>(octaves)];
+    primary = std::clamp(sumPrimary * normalise, -1.0f, 1.0f);
+    secondary = std::clamp(sumSecondary * normalise, -1.0f, 1.0f);
+}
+
+void SimplexNoise::fractalBlock(float startTime, float timeStep, int octaves, float* out, int count) const
+{
+    const auto& table = getOctaveTable();
+    octaves = std::clamp(octaves, 1, maxOctaves);
+
+    // Octave-major chunks: one kernel call covers chunkSize samples of every octave
+    constexpr int chunkSize = 32;
+    std::array<float, chunkSize * maxOctaves> x {}, y {}, value {};
+
+    for (int start = 0; start < count; start += chunkSize)
+    {
+        const int samples = std::min(chunkSize, count - start);
+
+        for (int k = 0; k < octaves; ++k)
+        {
+            const float frequency = table.frequency[static_cast<size_t>(k)];
+            const float row = static_cast<float>(k) * octaveRowSpacing;
+            float* lanesX = x.data() + k * samples;
+            float* lanesY = y.data() + k * samples;
+
+            for (int n = 0; n < samples; ++n)
+            {
+                lanesX[n] = (startTime + static_cast<float>(start + n) * timeStep) * frequency;
+                lanesY[n] = row;
+            }
+        }
+
+        noise2D(x.data(), y.data(), value.data(), samples * octaves);
+
+        const float normalise = table.inverseTotal[static_cast<size_t>(octaves)];
+        for (int n = 0; n < samples; ++n)
+        {
+            float sum = 0.0f;
+            for (int k = 0; k < octaves; ++k)
+                sum += value[static_cast<size_t>(k * samples + n)] * table.amplitude[static_cast<size_t>(k)];
+
+            out[start + n] = std::clamp(sum * normalise, -1.0f, 1.0f);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * @class SimplexNoise
+ * @brief Batched 1D/2D simplex noise and multi-octave (fBm) noise
+ *
+ * The kernels evaluate a whole array of points per call. Lattice gradients come
+ * from an integer hash of the lattice point and the seed rather than from a
+ * permutation table, and corner weights are computed without branches, so each
+ * kernel loop has no table lookups and is vectorised by the compiler.
+ *
+ * fractal() puts every octave of two decorrelated channels (primary and
+ * secondary) into one batch and evaluates them with a single kernel call.
+ */
+class SimplexNoise
+{
+public:
+    static constexpr int maxOctaves = 8;
+    static constexpr int maxBatch = 2 * maxOctaves;   // Octaves x channels evaluated per fractal() call
+
+    explicit SimplexNoise(uint32_t seedValue = 0x2545F491u) : seed(seedValue) {}
+
+    void setSeed(uint32_t seedValue) { seed = seedValue; }
+    uint32_t getSeed() const { return seed; }
+
+    // Batch kernels: out[i] = noise at x[i] (and y[i]), in about [-1, 1]
+    void noise1D(const float* x, float* out, int count) const;
+    void noise2D(const float* x, const float* y, float* out, int count) const;
+
+    /**
+     * Fractal noise at time t: octave k samples frequency 2^k with amplitude 0.5^k.
+     * Both channels are normalised to [-1, 1].
+     */
+    void fractal(float t, int octaves, float& primary, float& secondary) const;
+
+    // Primary channel of fractal() at t = startTime + i * timeStep for i < count
+    void fractalBlock(float startTime, float timeStep, int octaves, float* out, int count) const;
+
+private:
+    uint32_t seed;
+};
@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+    StepConditions.h
+
+    Per-step probability, conditional trigs and parameter locks
+    Conditions are compiled into step bitmasks when edited. The masks are
+    combined once per pattern cycle, so the per-tick check is a few bit tests
+    and one probability compare, however many conditions a step has.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <bitset>
+#include <memory>
+
+/**
+ * Condition flags for a step. A step fires only when all of its flags hold
+ * (and its probability check passes).
+ */
+namespace TrigCondition
+{
+    enum Flags : juce::uint32
+    {
+        None             = 0,
+        Ratio            = 1 << 0,  // A:B - fire on iteration A of every B cycles (1:2, 3:4, ...)
+        Fill             = 1 << 1,  // Only while fill mode is active
+        NotFill          = 1 << 2,  // Only while fill mode is inactive
+        First            = 1 << 3,  // Only on the first cycle after reset
+        NotFirst         = 1 << 4,  // Every cycle except the first
+        PreviousFired    = 1 << 5,  // Only if the previous conditional trig fired
+        NotPreviousFired = 1 << 6   // Only if the previous conditional trig did not fire
+    };
+}
+
+struct StepCondition
+{
+    juce::uint32 flags = TrigCondition::None;
+    int ratioA = 1;                 // Iteration (1-based) within the ratio cycle
+    int ratioB = 1;                 // Ratio cycle length
+};
+
+/**
+ * Per-step parameter locks; unlocked values follow the generator/global settings
+ */
+struct StepParameterLocks
+{
+    enum : juce::uint8
+    {
+        LockVelocity = 1 << 0,
+        LockPitch    = 1 << 1,
+        LockGate     = 1 << 2
+    };
+
+    juce::uint8 flags = 0;
+    float velocity = 0.8f;          // Raw velocity (0.0-1.0) before range mapping
+    int pitch = 60;                 // MIDI note before scale quantization
+    float gateLength = 0.8f;        // Fraction of a step
+
+    bool locksVelocity() const { return (flags & LockVelocity) != 0; }
+    bool locksPitch() const { return (flags & LockPitch) != 0; }
+    bool locksGate() const { return (flags & LockGate) != 0; }
+};
+
+/**
+ * Playback state for one condition lane (audio-owned)
+ */
+struct StepConditionState
+{
+    static constexpr int maxSteps = 128;
+
+    int cycleCount = 0;                     // Completed pattern cycles since reset
+    bool cycleStarted = false;              // beginCycle() has run since reset
+    bool previousFired = false;             // Result of the last conditional trig
+    bool nextStepDecided = false;           // The next step was evaluated one tick early (negative microtiming)
+    std::bitset<maxSteps> blockedSteps;     // Steps whose conditions fail this cycle
+
+    void reset()
+    {
+        cycleCount = 0;
+        cycleStarted = false;
+        previousFired = false;
+        nextStepDecided = false;
+        blockedSteps.reset();
+    }
+};
+
+/**
+ * Per-step probability, condition and parameter-lock lane for one pattern
+ */
+class StepConditionLane
+{
+public:
+    static constexpr int maxSteps = StepConditionState::maxSteps;
+    static constexpr int maxRatioCycles = 8;
+    using StepMask = std::bitset<maxSteps>;
+
+    StepConditionLane()
+    {
+        probabilities.fill(1.0f);
+    }
+
+    //==============================================================================
+    // Editing (rebuilds the masks for the edited step only)
+
+    void setCondition(int step, juce::uint32 flags, int ratioA = 1, int ratioB = 1)
+    {
+        if (!juce::isPositiveAndBelow(step, maxSteps))
+            return;
+
+        auto& condition = conditions[step];
+        condition.flags = flags;
+        condition.ratioB = juce::jlimit(1, maxRatioCycles, ratioB);
+        condition.ratioA = juce::jlimit(1, condition.ratioB, ratioA);
+        rebuildStepMasks(step);
+    }
+
+    void setProbability(int step, float probability)
+    {
+        if (!juce::isPositiveAndBelow(step, maxSteps))
+            return;
+
+        probabilities[step] = juce::jlimit(0.0f, 1.0f, probability);
+        rebuildStepMasks(step);
+    }
+
+    void setParameterLocks(int step, const StepParameterLocks& stepLocks)
+    {
+        if (!juce::isPositiveAndBelow(step, maxSteps))
+            return;
+
+        auto& target = locks[step];
+        target.flags = stepLocks.flags;
+        target.velocity = juce::jlimit(0.0f, 1.0f, stepLocks.velocity);
+        target.pitch = juce::jlimit(0, 127, stepLocks.pitch);
+        target.gateLength = juce::jlimit(0.01f, 2.0f, stepLocks.gateLength);
+    }
+
+    void clearStep(int step)
+    {
+        if (!juce::isPositiveAndBelow(step, maxSteps))
+            return;
+
+        conditions[step] = {};
+        probabilities[step] = 1.0f;
+        locks[step] = {};
+        rebuildStepMasks(step);
+    }
+
+    void clear()
+    {
+        for (int step = 0; step < maxSteps; ++step)
+            clearStep(step);
+    }
+
+    const StepCondition& getCondition(int step) const { return conditions[juce::jlimit(0, maxSteps - 1, step)]; }
+    float getProbability(int step) const { return probabilities[juce::jlimit(0, maxSteps - 1, step)]; }
+    const StepParameterLocks& getParameterLocks(int step) const { return locks[juce::jlimit(0, maxSteps - 1, step)]; }
+
+    bool isDefaultStep(int step) const
+    {
+        const auto& condition = getCondition(step);
+        return condition.flags == TrigCondition::None && getProbability(step) >= 1.0f
+            && getParameterLocks(step).flags == 0;
+    }
+
+    //==============================================================================
+    // Serialization (only steps that differ from the defaults are stored)
+
+    std::unique_ptr<juce::XmlElement> toXml() const
+    {
+        auto xml = std::make_unique<juce::XmlElement>("StepConditions");
+
+        for (int step = 0; step < maxSteps; ++step)
+        {
+            if (isDefaultStep(step))
+                continue;
+
+            const auto& condition = conditions[step];
+            const auto& stepLocks = locks[step];
+
+            auto* stepXml = xml->createNewChildElement("Step");
+            stepXml->setAttribute("index", step);
+            stepXml->setAttribute("flags", static_cast<int>(condition.flags));
+            stepXml->setAttribute("ratioA", condition.ratioA);
+            stepXml->setAttribute("ratioB", condition.ratioB);
+            stepXml->setAttribute("probability", probabilities[step]);
+            stepXml->setAttribute("lockFlags", static_cast<int>(stepLocks.flags));
+            stepXml->setAttribute("lockVelocity", stepLocks.velocity);
+            stepXml->setAttribute("lockPitch", stepLocks.pitch);
+            stepXml->setAttribute("lockGate", stepLocks.gateLength);
+        }
+
+        return xml;
+    }
+
+    void fromXml(const juce::XmlElement& xml)
+    {
+        clear();
+
+        for (auto* stepXml : xml.getChildWithTagNameIterator("Step"))
+        {
+            const int step = stepXml->getIntAttribute("index", -1);
+            if (!juce::isPositiveAndBelow(step, maxSteps))
+                continue;
+
+            StepParameterLocks stepLocks;
+            stepLocks.flags = static_cast<juce::uint8>(stepXml->getIntAttribute("lockFlags", 0));
+            stepLocks.velocity = static_cast<float>(stepXml->getDoubleAttribute("lockVelocity", 0.8));
+            stepLocks.pitch = stepXml->getIntAttribute("lockPitch", 60);
+            stepLocks.gateLength = static_cast<float>(stepXml->getDoubleAttribute("lockGate", 0.8));
+
+            probabilities[step] = juce::jlimit(0.0f, 1.0f, static_cast<float>(stepXml->getDoubleAttribute("probability", 1.0)));
+            setParameterLocks(step, stepLocks);
+            setCondition(step, static_cast<juce::uint32>(stepXml->getIntAttribute("flags", 0)),
+                         stepXml->getIntAttribute("ratioA", 1), stepXml->getIntAttribute("ratioB", 1));
+        }
+    }
+
+    //==============================================================================
+    // Evaluation (audio thread)
+
+    /**
+     * Combine the condition masks for the cycle that is starting.
+     * Call when the pattern wraps to step 0; cost is independent of pattern length.
+     */
+    void beginCycle(StepConditionState& state, bool fillActive) const
+    {
+        const int cycle = state.cycleCount++;
+
+        StepMask blocked = fillActive ? notFillSteps : fillSteps;
+        blocked |= (cycle == 0) ? notFirstSteps : firstSteps;
+
+        for (int b = 0; b < maxRatioCycles; ++b)
+            blocked |= ratioSteps[b] & ~ratioPass[b][cycle % (b + 1)];
+
+        state.blockedSteps = blocked;
+        state.cycleStarted = true;
+    }
+
+    /**
+     * Decide whether an active step fires on this tick.
+     * @param randomValue Uniform random value (0.0-1.0) for the probability check
+     * @param probabilityScale Global density multiplier applied to the step probability
+     */
+    bool evaluate(StepConditionState& state, int step, float randomValue, float probabilityScale = 1.0f) const
+    {
+        if (!juce::isPositiveAndBelow(step, maxSteps))
+            return randomValue < probabilityScale;
+
+        bool fires = !state.blockedSteps[step]
+                  && !(previousFiredSteps[step] && !state.previousFired)
+                  && !(notPreviousFiredSteps[step] && state.previousFired)
+                  && randomValue < probabilities[step] * probabilityScale;
+
+        if (conditionalSteps[step])
+            state.previousFired = fires;
+
+        return fires;
+    }
+
+private:
+    void rebuildStepMasks(int step)
+    {
+        const auto& condition = conditions[step];
+        const auto flags = condition.flags;
+
+        for (int b = 0; b < maxRatioCycles; ++b)
+        {
+            ratioSteps[b].reset(step);
+            for (int a = 0; a < maxRatioCycles; ++a)
+                ratioPass[b][a].reset(step);
+        }
+
+        if ((flags & TrigCondition::Ratio) != 0)
+        {
+            ratioSteps[condition.ratioB - 1].set(step);
+            ratioPass[condition.ratioB - 1][condition.ratioA - 1].set(step);
+        }
+
+        fillSteps.set(step, (flags & TrigCondition::Fill) != 0);
+        notFillSteps.set(step, (flags & TrigCondition::NotFill) != 0);
+        firstSteps.set(step, (flags & TrigCondition::First) != 0);
+        notFirstSteps.set(step, (flags & TrigCondition::NotFirst) != 0);
+        previousFiredSteps.set(step, (flags & TrigCondition::PreviousFired) != 0);
+        notPreviousFiredSteps.set(step, (flags & TrigCondition::NotPreviousFired) != 0);
+        conditionalSteps.set(step, flags != TrigCondition::None || probabilities[step] < 1.0f);
+    }
+
+    std::array<StepCondition, maxSteps> conditions {};
+    std::array<float, maxSteps> probabilities {};
+    std::array<StepParameterLocks, maxSteps> locks {};
+
+    // Compiled masks: ratioSteps[B-1] holds all A:B steps, ratioPass[B-1][A-1] those firing on iteration A
+    std::array<StepMask, maxRatioCycles> ratioSteps {};
+    std::array<std::array<StepMask, maxRatioCycles>, maxRatioCycles> ratioPass {};
+    StepMask fillSteps, notFillSteps, firstSteps, notFirstSteps;
+    StepMask previousFiredSteps, notPreviousFiredSteps, conditionalSteps;
+};
@@ -9,33 +9,21 @@ StochasticEngine::StochasticEngine()
       acceleration(0.0f),
       noiseTime(0.0f),
       drunkPosition(0.5f),
+      drunkTimer(0.0f),
       noteDensity(0.5f),
       stepSize(0.1f),
       momentum(0.9f),
       octaves(4),
       timeScale(1.0f),
-      sigma(10.0f),
-      rho(28.0f),
-      beta(8.0f / 3.0f),
-      dt(0.01f),
       rng(std::random_device{}()),
       uniform01(0.0f, 1.0f),
       normalDist(0.0f, 1.0f)
 {
-    // Initialize Perlin noise permutation table
-    for (int i = 0; i < 256; ++i)
-        permutation[i] = i;
+    noise.setSeed(static_cast<uint32_t>(rng()));
 
-    // Shuffle permutation table
-    for (int i = 255; i > 0; --i)
-    {
-        int j = rng() % (i + 1);
-        std::swap(permutation[i], permutation[j]);
-    }
-
-    // Duplicate permutation table for wrapping
-    for (int i = 0; i < 256; ++i)
-        permutation[256 + i] = permutation[i];
+    // One attractor voice per chaotic generator type
+    for (int i = 0; i < AttractorBank::numSystems; ++i)
+        attractorVoices[static_cast<size_t>(i)] = attractors.addVoice(static_cast<AttractorBank::System>(i));
 
     reset();
 }
@@ -49,11 +37,55 @@ void StochasticEngine::reset()
     acceleration = 0.0f;
     noiseTime = 0.0f;
     drunkPosition = 0.5f;
+    drunkTimer = 0.0f;
+
+    // Attractors restart from their initial conditions
+    attractors.reset();
+}
+
+void StochasticEngine::seed(uint32_t seedValue)
+{
+    rng.seed(seedValue);
+    normalDist.reset();
+    noise.setSeed(static_cast<uint32_t>(rng()));
+}
+
+// ============================================================================
+// State Save / Restore
+// ============================================================================
 
-    // Lorenz attractor: start near the origin with slight offset
-    currentValue = 0.1f;
-    secondaryValue = 0.0f;
-    tertiaryValue = 0.0f;
+StochasticEngine::State StochasticEngine::saveState() const
+{
+    State state;
+    state.currentValue = currentValue;
+    state.secondaryValue = secondaryValue;
+    state.tertiaryValue = tertiaryValue;
+    state.velocity = velocity;
+    state.acceleration = acceleration;
+    state.noiseTime = noiseTime;
+    state.drunkPosition = drunkPosition;
+    state.drunkTimer = drunkTimer;
+    state.noiseSeed = noise.getSeed();
+    state.rng = rng;
+    state.normalDist = normalDist;
+    state.attractors = attractors;
+    return state;
+}
+
+void StochasticEngine::restoreState(const State& state)
+{
+    currentValue = state.currentValue;
+    secondaryValue = state.secondaryValue;
+    tertiaryValue = state.tertiaryValue;
+    velocity = state.velocity;
+    acceleration = state.acceleration;
+    noiseTime = state.noiseTime;
+    drunkPosition = state.drunkPosition;
+    drunkTimer = state.drunkTimer;
+    rng = state.rng;
+    normalDist = state.normalDist;
+    attractors = state.attractors;
+    noise.setSeed(state.noiseSeed);
 }
 
 void StochasticEngine::advance(float deltaTime)
@@ -73,7 +105,11 @@ void StochasticEngine::advance(float deltaTime)
             break;
 
         case GeneratorType::LorenzAttractor:
-            updateLorenzAttractor(deltaTime);
+        case GeneratorType::RosslerAttractor:
+        case GeneratorType::ThomasAttractor:
+        case GeneratorType::HenonMap:
+        case GeneratorType::ChuaCircuit:
+            updateAttractor(deltaTime);
             break;
     }
 }
@@ -141,82 +177,14 @@ void StochasticEngine::updatePerlinNoise(float deltaTime)
 {
     noiseTime += deltaTime * timeScale;
 
-    // Multi-octave Perlin noise (fractal Brownian motion)
-    float amplitude = 1.0f;
-    float frequency = 1.0f;
-    float value = 0.0f;
-    float maxValue = 0.0f;
-
-    for (int i = 0; i < octaves; ++i)
-    {
-        value += perlinNoise(noiseTime * frequency, i * 100.0f) * amplitude;
-        maxValue += amplitude;
-
-        amplitude *= 0.5f;
-        frequency *= 2.0f;
-    }
+    // Multi-octave noise (fractal Brownian motion); the secondary channel is a
+    // different region of the same field, evaluated in the same batch
+    float primary = 0.0f, secondary = 0.0f;
+    noise.fractal(noiseTime, octaves, primary, secondary);
 
     // Normalize to 0.0-1.0
-    currentValue = (value / maxValue + 1.0f) * 0.5f;
-    currentValue = std::clamp(currentValue, 0.0f, 1.0f);
-
-    // Secondary value uses different phase
-    float secondaryAmplitude = 1.0f;
-    float secondaryFrequency = 1.0f;
-    float secondaryVal = 0.0f;
-    float secondaryMax = 0.0f;
-
-    for (int i = 0; i < octaves; ++i)
-    {
-        secondaryVal += perlinNoise(noiseTime * secondaryFrequency + 1000.0f, i * 100.0f) * secondaryAmplitude;
-        secondaryMax += secondaryAmplitude;
-
-        secondaryAmplitude *= 0.5f;
-        secondaryFrequency *= 2.0f;
-    }
-
-    secondaryValue = (secondaryVal / secondaryMax + 1.0f) * 0.5f;
-    secondaryValue = std::clamp(secondaryValue, 0.0f, 1.0f);
-}
-
-float StochasticEngine::perlinNoise(float x, float y) const
-{
-    // Find grid cell coordinates
-    int X = static_cast<int>(std::floor(x)) & 255;
-    int Y = static_cast<int>(std::floor(y)) & 255;
-
-    // Relative position within cell
-    x -= std::floor(x);
-    y -= std::floor(y);
-
-    // Fade curves
-    float u = fade(x);
-    float v = fade(y);
-
-    // Hash coordinates of 4 cell corners
-    int aa = permutation[permutation[X] + Y];
-    int ab = permutation[permutation[X] + Y + 1];
-    int ba = permutation[permutation[X + 1] + Y];
-    int bb = permutation[permutation[X + 1] + Y + 1];
-
-    // Blend results from 4 corners
-    float res = lerp(
-        lerp(grad(aa, x, y), grad(ba, x - 1, y), u),
-        lerp(grad(ab, x, y - 1), grad(bb, x - 1, y - 1), u),
-        v
-    );
-
-    return res;
-}
-
-float StochasticEngine::grad(int hash, float x, float y) const
-{
-    // Convert low 3 bits of hash into 8 gradient directions
-    int h = hash & 7;
-    float u = (h < 4) ? x : y;
-    float v = (h < 4) ? y : x;
-
-    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    currentValue = (primary + 1.0f) * 0.5f;
+    secondaryValue = (secondary + 1.0f) * 0.5f;
 }
 
 // ============================================================================
@@ -226,14 +194,13 @@ float StochasticEngine::grad(int hash, float x, float y) const
 void StochasticEngine::updateDrunkWalk(float deltaTime)
 {
     // Only take steps at discrete intervals
-    static float timeSinceLastStep = 0.0f;
-    timeSinceLastStep += deltaTime;
+    drunkTimer += deltaTime;
 
     float stepInterval = 1.0f / (timeScale * 10.0f);  // Steps per second based on time scale
 
-    if (timeSinceLastStep >= stepInterval)
+    if (drunkTimer >= stepInterval)
     {
-        timeSinceLastStep = 0.0f;
+        drunkTimer = 0.0f;
 
         // Random walk with variable step size
         float step = (uniform01(rng) - 0.5f) * 2.0f * stepSize;
@@ -263,42 +230,21 @@ void StochasticEngine::updateDrunkWalk(float deltaTime)
 }
 
 // ============================================================================
-// Lorenz Attractor Implementation
+// Chaotic Attractor Implementation
 // ============================================================================
 
-void StochasticEngine::updateLorenzAttractor(float deltaTime)
+void StochasticEngine::updateAttractor(float deltaTime)
 {
-    // Lorenz system differential equations:
-    // dx/dt = sigma * (y - x)
-    // dy/dt = x * (rho - z) - y
-    // dz/dt = x * y - beta * z
-
-    // Use multiple integration steps for accuracy
-    int steps = static_cast<int>(deltaTime / dt);
-    steps = std::max(1, std::min(steps, 100));
-
-    for (int i = 0; i < steps; ++i)
-    {
-        float x = (currentValue - 0.5f) * 60.0f;      // Scale to attractor space
-        float y = (secondaryValue - 0.5f) * 60.0f;
-        float z = (tertiaryValue * 60.0f);
-
-        float dx = sigma * (y - x);
-        float dy = x * (rho - z) - y;
-        float dz = x * y - beta * z;
-
-        x += dx * dt * timeScale;
-        y += dy * dt * timeScale;
-        z += dz * dt * timeScale;
-
-        // Scale back to 0.0-1.0 range
-        currentValue = x / 60.0f + 0.5f;
-        secondaryValue = y / 60.0f + 0.5f;
-        tertiaryValue = z / 60.0f;
-
-        // Keep values in reasonable range
-        currentValue = std::clamp(currentValue, 0.0f, 1.0f);
-        secondaryValue = std::clamp(secondaryValue, 0.0f, 1.0f);
-        tertiaryValue = std::clamp(tertiaryValue, 0.0f, 1.0f);
-    }
+    // Fixed RK4 substeps per elapsed time: the trajectory moves at the same
+    // speed whatever the tempo. Time Scale sets attractor units per second.
+    // All systems advance together so switching type keeps each trajectory.
+    attractors.setSpeed(timeScale);
+    attractors.advance(deltaTime);
+
+    const int system = static_cast<int>(generatorType) - static_cast<int>(GeneratorType::LorenzAttractor);
+    const int voice = attractorVoices[static_cast<size_t>(std::clamp(system, 0, AttractorBank::numSystems - 1))];
+
+    currentValue = attractors.getNormalised(voice, 0);
+    secondaryValue = attractors.getNormalised(voice, 1);
+    tertiaryValue = attractors.getNormalised(voice, 2);
 }
@@ -4,6 +4,9 @@
 #include <random>
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
+#include "AttractorBank.h"
+#include "SimplexNoise.h"
 
 /**
  * @class StochasticEngine
@@ -11,9 +14,17 @@
  *
  * Generates patterns using:
  * - Brownian Motion (random walk with momentum)
- * - Perlin Noise (smooth, natural randomness)
+ * - Perlin Noise (smooth, natural randomness; multi-octave simplex noise)
  * - Drunk Walk (discrete random walk)
  * - Lorenz Attractor (deterministic chaos)
+ * - Rossler, Thomas, Chua attractors and the Henon map
+ *
+ * The chaotic systems share one AttractorBank, integrated with fixed RK4
+ * substeps per elapsed time, so their speed does not depend on tempo.
+ *
+ * All generator state belongs to the instance. saveState() / restoreState()
+ * copy it, random number generator included, so a run can be recalled and
+ * continues exactly as it did from the saved point.
  */
 class StochasticEngine
 {
@@ -23,7 +34,11 @@ public:
         BrownianMotion,
         PerlinNoise,
         DrunkWalk,
-        LorenzAttractor
+        LorenzAttractor,
+        RosslerAttractor,
+        ThomasAttractor,
+        HenonMap,
+        ChuaCircuit
     };
 
     StochasticEngine();
@@ -38,9 +53,36 @@ public:
     void setTimeScale(float scale) { timeScale = std::clamp(scale, 0.01f, 10.0f); }
 
     // Lorenz attractor parameters
-    void setSigma(float sigma) { this->sigma = sigma; }
-    void setRho(float rho) { this->rho = rho; }
-    void setBeta(float beta) { this->beta = beta; }
+    void setSigma(float sigma) { attractors.setParameter(attractorVoices[0], 0, sigma); }
+    void setRho(float rho) { attractors.setParameter(attractorVoices[0], 1, rho); }
+    void setBeta(float beta) { attractors.setParameter(attractorVoices[0], 2, beta); }
+
+    // Shared chaotic systems (one voice per attractor generator type)
+    AttractorBank& getAttractorBank() { return attractors; }
+
+    // Full generator state: values, walk/noise state, random generator and attractors
+    struct State
+    {
+        float currentValue = 0.5f;
+        float secondaryValue = 0.5f;
+        float tertiaryValue = 0.5f;
+        float velocity = 0.0f;
+        float acceleration = 0.0f;
+        float noiseTime = 0.0f;
+        float drunkPosition = 0.5f;
+        float drunkTimer = 0.0f;
+        uint32_t noiseSeed = 0;
+
+        std::mt19937 rng;
+        std::normal_distribution<float> normalDist;
+        AttractorBank attractors;
+    };
+
+    State saveState() const;
+    void restoreState(const State& state);
+
+    // Reseed the random generator and noise field (instances are seeded randomly otherwise)
+    void seed(uint32_t seedValue);
 
     // Generation
     void reset();
@@ -59,19 +101,13 @@ private:
     void updateBrownianMotion(float deltaTime);
     void updatePerlinNoise(float deltaTime);
     void updateDrunkWalk(float deltaTime);
-    void updateLorenzAttractor(float deltaTime);
-
-    // Perlin noise helpers
-    float perlinNoise(float x, float y) const;
-    float fade(float t) const { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
-    float lerp(float a, float b, float t) const { return a + t * (b - a); }
-    float grad(int hash, float x, float y) const;
+    void updateAttractor(float deltaTime);
 
     // State
     GeneratorType generatorType;
     float currentValue;       // Main output value (0.0-1.0)
     float secondaryValue;     // Secondary value for 2D/3D systems
-    float tertiaryValue;      // Tertiary value for 3D systems (Lorenz)
+    float tertiaryValue;      // Tertiary value for 3D systems (attractors)
 
     // Brownian motion state
     float velocity;
@@ -79,10 +115,11 @@ private:
 
     // Perlin noise state
     float noiseTime;
-    int permutation[512];     // Permutation table for Perlin noise
+    SimplexNoise noise;       // All octaves of both channels evaluated in one batch
 
     // Drunk walk state
     float drunkPosition;
+    float drunkTimer;         // Time since the last discrete step
 
     // Parameters
     float noteDensity;
@@ -91,11 +128,9 @@ private:
     int octaves;              // For Perlin noise multi-octave
     float timeScale;          // Time scaling factor
 
-    // Lorenz attractor parameters
-    float sigma;              // Prandtl number (default: 10.0)
-    float rho;                // Rayleigh number (default: 28.0)
-    float beta;               // Geometric factor (default: 8.0/3.0)
-    float dt;                 // Integration step size
+    // Chaotic systems: Lorenz, Rossler, Thomas, Henon, Chua (voice ids in that order)
+    AttractorBank attractors;
+    std::array<int, AttractorBank::numSystems> attractorVoices {};
 
     // Random number generation
     mutable std::mt19937 rng;
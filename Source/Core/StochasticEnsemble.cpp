@@ -0,0 +1,266 @@
+#include "StochasticEnsemble.h"
+
+namespace
+{
+    constexpr int32_t brownianType = static_cast<int32_t>(StochasticEngine::GeneratorType::BrownianMotion);
+    constexpr int32_t perlinType = static_cast<int32_t>(StochasticEngine::GeneratorType::PerlinNoise);
+    constexpr int32_t drunkType = static_cast<int32_t>(StochasticEngine::GeneratorType::DrunkWalk);
+    constexpr int32_t firstAttractorType = static_cast<int32_t>(StochasticEngine::GeneratorType::LorenzAttractor);
+
+    constexpr float noisePeriod = 4096.0f;  // Noise time wraps here (the lattice is periodic)
+
+    // xorshift32 step, returning a uniform in [0, 1)
+    inline float nextUniform(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Gradient for an integer lattice point of a walker's noise stream, in [-1, 1]
+    inline float latticeGradient(int32_t cell, uint32_t seed)
+    {
+        uint32_t h = (static_cast<uint32_t>(cell) & 4095u) * 0x9E3779B1u ^ seed;
+        h ^= h >> 15;
+        h *= 0x85EBCA77u;
+        h ^= h >> 13;
+        return static_cast<float>(h & 0xffffu) * (2.0f / 65535.0f) - 1.0f;
+    }
+
+    // 1D gradient noise in roughly [-1, 1] (t >= 0)
+    inline float gradientNoise(float t, uint32_t seed)
+    {
+        const auto cell = static_cast<int32_t>(t);
+        const float f = t - static_cast<float>(cell);
+        const float fade = f * f * f * (f * (f * 6.0f - 15.0f) + 10.0f);
+
+        const float a = latticeGradient(cell, seed) * f;
+        const float b = latticeGradient(cell + 1, seed) * (f - 1.0f);
+        return 2.0f * (a + fade * (b - a));
+    }
+}
+
+StochasticEnsemble::StochasticEnsemble()
+{
+    for (int i = 0; i < maxWalkers; ++i)
+        setWalker(i, WalkerSettings {});
+
+    seed(baseSeed);
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void StochasticEnsemble::setNumWalkers(int count)
+{
+    count = std::clamp(count, 1, maxWalkers);
+    if (count == numWalkers)
+        return;
+
+    numWalkers = count;
+    rebuildAttractors();
+}
+
+void StochasticEnsemble::setWalker(int index, const WalkerSettings& newSettings)
+{
+    if (index < 0 || index >= maxWalkers)
+        return;
+
+    const auto i = static_cast<size_t>(index);
+    const bool typeChanged = settings[i].type != newSettings.type;
+
+    auto& walker = settings[i];
+    walker = newSettings;
+    walker.midiChannel = std::clamp(walker.midiChannel, 1, 16);
+    walker.minPitch = std::clamp(walker.minPitch, 0, 127);
+    walker.maxPitch = std::clamp(walker.maxPitch, walker.minPitch, 127);
+    walker.density = std::clamp(walker.density, 0.0f, 1.0f);
+
+    laneType[i] = static_cast<int32_t>(walker.type);
+    density[i] = walker.density;
+
+    if (typeChanged && index < numWalkers)
+        rebuildAttractors();
+}
+
+void StochasticEnsemble::seed(uint32_t seedValue)
+{
+    baseSeed = seedValue != 0 ? seedValue : 0x2545F491u;
+
+    for (int i = 0; i < maxWalkers; ++i)
+    {
+        // Distinct, non-zero stream per walker
+        uint32_t state = baseSeed ^ (0x9E3779B9u * static_cast<uint32_t>(i + 1));
+        rngState[static_cast<size_t>(i)] = state != 0 ? state : 1u;
+        noiseSeed[static_cast<size_t>(i)] = state * 0x85EBCA6Bu + 0xC2B2AE35u;
+    }
+
+    reset();
+}
+
+void StochasticEnsemble::reset()
+{
+    for (size_t i = 0; i < static_cast<size_t>(maxWalkers); ++i)
+    {
+        position[i] = 0.5f;
+        secondary[i] = 0.5f;
+        brownianVelocity[i] = 0.0f;
+        drunkTarget[i] = 0.5f;
+        drunkTimer[i] = 0.0f;
+        noiseTime[i] = static_cast<float>(i) * 17.0f;  // Decorrelate noise walkers
+        trigger[i] = 0;
+    }
+
+    rebuildAttractors();
+}
+
+void StochasticEnsemble::rebuildAttractors()
+{
+    attractors.clearVoices();
+    numAttractorWalkers = 0;
+
+    for (int i = 0; i < numWalkers; ++i)
+    {
+        const auto lane = static_cast<size_t>(i);
+        attractorVoice[lane] = -1;
+
+        if (laneType[lane] < firstAttractorType)
+            continue;
+
+        const auto system = static_cast<AttractorBank::System>(
+            std::clamp(laneType[lane] - firstAttractorType, 0, AttractorBank::numSystems - 1));
+        const int voice = attractors.addVoice(system);
+        attractorVoice[lane] = voice;
+
+        // Spread walkers of the same system over different trajectories
+        const float offset = 0.01f * static_cast<float>(i);
+        attractors.setState(voice, attractors.getState(voice, 0) + offset,
+                            attractors.getState(voice, 1) + offset,
+                            attractors.getState(voice, 2));
+        ++numAttractorWalkers;
+    }
+}
+
+// ============================================================================
+// Generation
+// ============================================================================
+
+void StochasticEnsemble::advance(float deltaTime)
+{
+    const float scaledTime = deltaTime * timeScale;
+    const float drunkInterval = 1.0f / (timeScale * 10.0f);
+
+    // One pass over all lanes. Every lane evaluates the Brownian, drunk and noise
+    // updates and keeps the one for its type, so the loop has no branches.
+    for (int i = 0; i < numWalkers; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+        const int32_t type = laneType[v];
+        uint32_t state = rngState[v];
+
+        const float u1 = nextUniform(state), u2 = nextUniform(state);
+        const float u3 = nextUniform(state), u4 = nextUniform(state);
+        const float u5 = nextUniform(state), u6 = nextUniform(state);
+        const float u7 = nextUniform(state);
+        rngState[v] = state;
+
+        // Brownian: approximately normal acceleration (Irwin-Hall, 4 uniforms)
+        const float normal = (u1 + u2 + u3 + u4 - 2.0f) * 1.7320508f;
+        float velocity = std::min(std::max(brownianVelocity[v] * momentum + normal * stepSize, -0.5f), 0.5f);
+        const float unclamped = position[v] + velocity * scaledTime;
+        const float brownian = std::min(std::max(unclamped, 0.0f), 1.0f);
+        velocity = (unclamped != brownian) ? velocity * -0.5f : velocity;   // Bounce with energy loss
+
+        // Drunk walk: discrete steps at the time-scaled rate, smoothed output
+        const float timer = drunkTimer[v] + deltaTime;
+        const bool stepNow = timer >= drunkInterval;
+        float target = drunkTarget[v] + (u5 - 0.5f) * 2.0f * stepSize;
+        target = target > 1.0f ? 2.0f - target : target;
+        target = std::min(std::max(std::abs(target), 0.0f), 1.0f);       // Bounce off both edges
+        target = stepNow ? target : drunkTarget[v];
+        const float drunk = position[v] + (target - position[v]) * 0.3f;
+
+        // Gradient noise: primary and secondary from two offsets of the walker's stream
+        float time = noiseTime[v] + scaledTime;
+        time = time >= noisePeriod ? time - noisePeriod : time;
+        const float noise = std::min(std::max(0.5f + 0.5f * gradientNoise(time, noiseSeed[v]), 0.0f), 1.0f);
+        const float noiseSecondary = std::min(std::max(0.5f + 0.5f * gradientNoise(time, noiseSeed[v] ^ 0x68E31DA4u), 0.0f), 1.0f);
+
+        // Keep the update for this walker's type (selects, not branches)
+        const bool isBrownian = type == brownianType;
+        const bool isDrunk = type == drunkType;
+        const bool isNoise = type == perlinType;
+
+        float newPosition = position[v];
+        newPosition = isBrownian ? brownian : newPosition;
+        newPosition = isDrunk ? drunk : newPosition;
+        newPosition = isNoise ? noise : newPosition;
+
+        float newSecondary = secondary[v];
+        newSecondary = isBrownian ? secondary[v] + (newPosition - secondary[v]) * 0.1f : newSecondary;
+        newSecondary = (isDrunk & (u7 < 0.3f)) ? u1 : newSecondary;
+        newSecondary = isNoise ? noiseSecondary : newSecondary;
+
+        brownianVelocity[v] = isBrownian ? velocity : brownianVelocity[v];
+        drunkTarget[v] = target;
+        drunkTimer[v] = stepNow ? 0.0f : timer;
+        noiseTime[v] = time;
+        position[v] = newPosition;
+        secondary[v] = newSecondary;
+
+        trigger[v] = static_cast<int32_t>(u6 < density[v]);
+    }
+
+    // Attractor walkers: one SoA integration for all of them
+    if (numAttractorWalkers > 0)
+    {
+        attractors.setSpeed(timeScale);
+        attractors.advance(deltaTime);
+
+        for (int i = 0; i < numWalkers; ++i)
+        {
+            const int voice = attractorVoice[static_cast<size_t>(i)];
+            if (voice < 0)
+                continue;
+
+            position[static_cast<size_t>(i)] = attractors.getNormalised(voice, 0);
+            secondary[static_cast<size_t>(i)] = attractors.getNormalised(voice, 1);
+        }
+    }
+}
+
+bool StochasticEnsemble::shouldTriggerNote(int walker) const
+{
+    return walker >= 0 && walker < numWalkers && trigger[static_cast<size_t>(walker)] != 0;
+}
+
+int StochasticEnsemble::getCurrentPitch(int walker) const
+{
+    const auto& walkerSettings = getWalker(walker);
+    const float normalised = std::clamp(getCurrentValue(walker), 0.0f, 1.0f);
+    const int pitch = walkerSettings.minPitch + static_cast<int>(normalised * (walkerSettings.maxPitch - walkerSettings.minPitch));
+    return std::clamp(pitch, 0, 127);
+}
+
+float StochasticEnsemble::getCurrentVelocity(int walker, float minVel, float maxVel) const
+{
+    if (walker < 0 || walker >= numWalkers)
+        return minVel;
+
+    const float normalised = std::clamp(secondary[static_cast<size_t>(walker)], 0.0f, 1.0f);
+    return minVel + normalised * (maxVel - minVel);
+}
+
+int StochasticEnsemble::getChannel(int walker) const
+{
+    return getWalker(walker).midiChannel;
+}
+
+float StochasticEnsemble::getCurrentValue(int walker) const
+{
+    if (walker < 0 || walker >= numWalkers)
+        return 0.5f;
+    return position[static_cast<size_t>(walker)];
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include "StochasticEngine.h"
+#include "AttractorBank.h"
+
+/**
+ * @class StochasticEnsemble
+ * @brief Up to 16 stochastic walkers advanced together for polyphonic textures
+ *
+ * Each walker has its own generator type, MIDI channel, pitch range and
+ * density. Walker state (positions, velocities, noise time, per-lane random
+ * state) is stored structure-of-arrays. Brownian, drunk-walk and noise walkers
+ * are advanced in one branch-free loop that the compiler vectorises. Attractor
+ * walkers share one AttractorBank.
+ *
+ * Random numbers come from a small xorshift generator per walker, so walkers
+ * need no std::mt19937 each and their streams are reproducible from a seed.
+ */
+class StochasticEnsemble
+{
+public:
+    static constexpr int maxWalkers = 16;
+
+    struct WalkerSettings
+    {
+        StochasticEngine::GeneratorType type = StochasticEngine::GeneratorType::BrownianMotion;
+        int midiChannel = 1;
+        int minPitch = 48;
+        int maxPitch = 84;
+        float density = 0.5f;
+    };
+
+    StochasticEnsemble();
+
+    // Configuration
+    void setNumWalkers(int count);
+    int getNumWalkers() const { return numWalkers; }
+
+    void setWalker(int index, const WalkerSettings& settings);
+    const WalkerSettings& getWalker(int index) const { return settings[static_cast<size_t>(std::clamp(index, 0, maxWalkers - 1))]; }
+
+    // Shared motion parameters (same meaning as in StochasticEngine)
+    void setStepSize(float size) { stepSize = std::clamp(size, 0.01f, 1.0f); }
+    void setMomentum(float newMomentum) { momentum = std::clamp(newMomentum, 0.0f, 1.0f); }
+    void setTimeScale(float scale) { timeScale = std::clamp(scale, 0.01f, 10.0f); }
+
+    void seed(uint32_t seedValue);
+    void reset();
+
+    // Advance every walker by deltaTime seconds and draw its trigger
+    void advance(float deltaTime);
+
+    // Results of the last advance()
+    bool shouldTriggerNote(int walker) const;
+    int getCurrentPitch(int walker) const;
+    float getCurrentVelocity(int walker, float minVel, float maxVel) const;
+    int getChannel(int walker) const;
+    float getCurrentValue(int walker) const;
+
+private:
+    using Lane = std::array<float, maxWalkers>;
+
+    void rebuildAttractors();
+
+    // Settings
+    std::array<WalkerSettings, maxWalkers> settings {};
+    std::array<int32_t, maxWalkers> laneType {};    // GeneratorType as int for the vector loop
+    Lane density {};
+    int numWalkers = 1;
+
+    float stepSize = 0.1f;
+    float momentum = 0.9f;
+    float timeScale = 1.0f;
+
+    // Walker state (structure of arrays)
+    Lane position {};           // Main output (0.0-1.0)
+    Lane secondary {};          // Velocity source (0.0-1.0)
+    Lane brownianVelocity {};
+    Lane drunkTarget {};
+    Lane drunkTimer {};
+    Lane noiseTime {};
+    std::array<uint32_t, maxWalkers> rngState {};
+    std::array<uint32_t, maxWalkers> noiseSeed {};
+    std::array<int32_t, maxWalkers> trigger {};      // int, not char: char stores would alias every lane
+
+    // Attractor walkers
+    AttractorBank attractors;
+    std::array<int, maxWalkers> attractorVoice {};
+    int numAttractorWalkers = 0;
+
+    uint32_t baseSeed = 0x2545F491u;
+};
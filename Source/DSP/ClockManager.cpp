@@ -42,7 +42,11 @@ void ClockManager::stop()
 void ClockManager::reset()
 {
     currentSample = 0;
+    beatPosition = 0.0;
+    nextSixteenth = 1;
     subdivisionCounter = 0;
+    hitGridTick = 0;
+    hitSampleOffset = 0;
     midiClockCounter = 0;
 }
 
@@ -51,28 +55,32 @@ void ClockManager::advance(int numSamples)
     if (!playing || externalSync)
         return;
 
-    int64_t previousSample = currentSample;
-    currentSample += numSamples;
-
-    // Check for subdivision hits
-    double samplesPerSixteenth = getSamplesPerSubdivision(16);
+    const double samplesPerBeat = getSamplesPerBeat();
+    const double previousBeat = beatPosition;
 
-    int previousSubdivision = static_cast<int>(previousSample / samplesPerSixteenth);
-    int currentSubdivision = static_cast<int>(currentSample / samplesPerSixteenth);
+    currentSample += numSamples;
+    beatPosition += numSamples / samplesPerBeat;
 
-    if (currentSubdivision > previousSubdivision && onSubdivisionHit)
+    // Fire a hit for each 16th-note grid line crossed in this block
+    while (nextSixteenth * 0.25 < beatPosition)
     {
-        // Fire callback for each subdivision crossed
-        for (int sub = previousSubdivision + 1; sub <= currentSubdivision; ++sub)
-        {
+        // First sample at or after the grid line, relative to this block
+        auto hitSample = static_cast<int64_t>(std::ceil((nextSixteenth * 0.25 - previousBeat) * samplesPerBeat));
+        hitSampleOffset = static_cast<int>(juce::jlimit<int64_t>(0, numSamples - 1, hitSample));
+
+        hitGridTick = nextSixteenth++;
+        ++subdivisionCounter;
+        if (onSubdivisionHit)
             onSubdivisionHit(16); // 16th note subdivision
-        }
     }
 }
 
-double ClockManager::getPositionInBeats() const
+void ClockManager::setPositionInBeats(double beats)
 {
-    return currentSample / getSamplesPerBeat();
+    beatPosition = juce::jmax(0.0, beats);
+
+    // A position a rounding error past a grid line still plays that line
+    nextSixteenth = static_cast<juce::int64>(std::ceil(beatPosition * 4.0 - 1.0e-6));
 }
 
 double ClockManager::getPositionInBars() const
@@ -116,19 +124,26 @@ void ClockManager::processExternalMidiClock(const juce::MidiMessage& message)
     if (!externalSync)
         return;
 
+    // Clock messages carry no position here; their hits count from the block start
+    hitSampleOffset = 0;
+
     if (message.isMidiClock())
     {
         midiClockCounter++;
+        beatPosition += 1.0 / 24.0;
+        hitGridTick = static_cast<juce::int64>(std::llround(beatPosition * 4.0));
 
         // MIDI clock runs at 24 ppqn (pulses per quarter note)
         if (midiClockCounter >= 24)
         {
             midiClockCounter = 0;
+            ++subdivisionCounter;
             if (onSubdivisionHit)
                 onSubdivisionHit(4); // Quarter note
         }
         else if (midiClockCounter % 6 == 0 && onSubdivisionHit)
         {
+            ++subdivisionCounter;
             onSubdivisionHit(16); // Sixteenth note
         }
     }
@@ -152,4 +167,6 @@ void ClockManager::setExternalSync(bool enabled)
     externalSync = enabled;
     if (enabled)
         midiClockCounter = 0;
+    else
+        setPositionInBeats(beatPosition);   // MIDI clock moved the position without the internal grid
 }
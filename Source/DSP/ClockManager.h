@@ -36,11 +36,18 @@ public:
     void reset();
     bool isPlaying() const { return playing; }
 
-    // Time advancement
+    // Time advancement. 16th-note hits are taken from the beat position, so
+    // they stay on the beat grid across tempo changes and locates.
     void advance(int numSamples);
 
-    // Position queries
-    double getPositionInBeats() const;
+    // Move to a transport position (host play start, seek or loop) without
+    // firing hits; the next hit is the first 16th at or after the position
+    void setPositionInBeats(double beats);
+
+    // Position queries. The beat (quarter note) position accumulates at the
+    // tempo in effect, so tempo changes do not move it; external MIDI clock
+    // advances it by 1/24 beat per pulse.
+    double getPositionInBeats() const { return beatPosition; }
     double getPositionInBars() const;
     int getPositionInSamples() const { return currentSample; }
 
@@ -52,6 +59,16 @@ public:
     // Callbacks for subdivision hits
     std::function<void(int subdivision)> onSubdivisionHit;
 
+    // Number of 16th-note hits fired since reset (valid inside onSubdivisionHit)
+    juce::int64 getSubdivisionCount() const { return subdivisionCounter; }
+
+    // Beat-grid index of the current hit: 16ths from beat 0 of the transport, so
+    // it follows host play starts, seeks and loops (valid inside onSubdivisionHit)
+    juce::int64 getHitGridTick() const { return hitGridTick; }
+
+    // Sample offset of the current hit within the block passed to advance() (valid inside onSubdivisionHit)
+    int getHitSampleOffset() const { return hitSampleOffset; }
+
     // Quantization
     int quantizeToSubdivision(int subdivision) const;
     bool isOnSubdivision(int subdivision) const;
@@ -69,7 +86,11 @@ private:
 
     bool playing = false;
     int64_t currentSample = 0;
-    int subdivisionCounter = 0;
+    double beatPosition = 0.0;
+    juce::int64 nextSixteenth = 1;      // Beat-grid index of the next hit (first hit one 16th after reset)
+    juce::int64 subdivisionCounter = 0;
+    juce::int64 hitGridTick = 0;
+    int hitSampleOffset = 0;
 
     // External sync
     bool externalSync = false;
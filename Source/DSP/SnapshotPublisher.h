@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+    SnapshotPublisher.h
+
+    Wait-free publication of immutable configuration snapshots
+    The message thread edits a copy and publishes it with an atomic pointer
+    swap; the audio thread acquires the newest snapshot without locking.
+    Superseded snapshots are reclaimed on the message thread once the audio
+    thread has acknowledged a newer version.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+template <typename SnapshotType>
+class SnapshotPublisher
+{
+public:
+    explicit SnapshotPublisher(std::unique_ptr<SnapshotType> initial)
+    {
+        latest = std::make_unique<Entry>();
+        latest->snapshot = std::move(initial);
+        latest->version = 1;
+        current.store(latest.get(), std::memory_order_release);
+    }
+
+    ~SnapshotPublisher() = default;
+
+    //==============================================================================
+    // Message thread
+
+    /** Most recently published snapshot (owned by the message thread). */
+    const SnapshotType& getLatest() const { return *latest->snapshot; }
+
+    /** Copy of the latest snapshot, for editing before publish(). */
+    std::unique_ptr<SnapshotType> copyLatest() const
+    {
+        return std::make_unique<SnapshotType>(*latest->snapshot);
+    }
+
+    /** Publishes a new snapshot; the previous one is retired, not deleted. */
+    void publish(std::unique_ptr<SnapshotType> next)
+    {
+        auto entry = std::make_unique<Entry>();
+        entry->snapshot = std::move(next);
+        entry->version = latest->version + 1;
+
+        current.store(entry.get(), std::memory_order_release);
+
+        retired.push_back(std::move(latest));
+        latest = std::move(entry);
+
+        collectGarbage();
+    }
+
+    /** Deletes retired snapshots the audio thread can no longer be reading. */
+    void collectGarbage()
+    {
+        auto acknowledged = acknowledgedVersion.load(std::memory_order_acquire);
+
+        retired.erase(std::remove_if(retired.begin(), retired.end(),
+                          [acknowledged](const std::unique_ptr<Entry>& entry) {
+                              return entry->version < acknowledged;
+                          }),
+                      retired.end());
+    }
+
+    int getNumRetired() const { return static_cast<int>(retired.size()); }
+
+    /**
+     * Takes back the snapshot published just before the latest one, once the
+     * audio thread has acknowledged the latest (so it can no longer be reading
+     * it); nullptr otherwise. Lets a large snapshot be double-buffered: the
+     * caller brings the old copy up to date instead of copying the latest.
+     */
+    std::unique_ptr<SnapshotType> reclaimPrevious()
+    {
+        if (retired.empty() || retired.back()->version + 1 != latest->version
+            || acknowledgedVersion.load(std::memory_order_acquire) < latest->version)
+            return nullptr;
+
+        auto previous = std::move(retired.back()->snapshot);
+        retired.clear();    // Older still, and equally unreachable
+        return previous;
+    }
+
+    //==============================================================================
+    // Audio thread (single reader)
+
+    /**
+     * Returns the newest snapshot and acknowledges its version.
+     * The reference stays valid until the next call to acquire().
+     */
+    const SnapshotType& acquire() noexcept
+    {
+        auto* entry = current.load(std::memory_order_acquire);
+        acknowledgedVersion.store(entry->version, std::memory_order_release);
+        return *entry->snapshot;
+    }
+
+    /** Version of the snapshot returned by the last acquire(). */
+    uint64_t getAcknowledgedVersion() const noexcept
+    {
+        return acknowledgedVersion.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<SnapshotType> snapshot;
+        uint64_t version = 0;
+    };
+
+    std::atomic<Entry*> current { nullptr };
+    std::atomic<uint64_t> acknowledgedVersion { 0 };
+
+    std::unique_ptr<Entry> latest;
+    std::vector<std::unique_ptr<Entry>> retired;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SnapshotPublisher)
+};
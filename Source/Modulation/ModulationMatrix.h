@@ -5,6 +5,20 @@
     Routes modulation sources to parameter destinations
     Manages modulation connections and depth/amount
 
+    Connections are compiled into a dense table grouped by destination
+    index whenever routing changes, so the audio thread resolves every
+    destination with one linear pass and no string comparisons.
+
+    Routing (connections, destinations and the compiled table) is an
+    immutable snapshot: message-thread edits copy the latest routing and
+    publish it through a SnapshotPublisher, and the audio thread acquires
+    the newest one without locking. Sources are added during setup, before
+    audio processing starts.
+
+    Banked sources (LFO, Random, Envelope) share one ModulationSourceBank
+    and are advanced and evaluated together; only other sources are
+    called through the virtual interface.
+
   ==============================================================================
 */
 
@@ -12,8 +26,12 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "ModulationSource.h"
+#include "../DSP/SnapshotPublisher.h"
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <functional>
+#include <cmath>
 
 // ============================================================================
 // Modulation Connection
@@ -21,9 +39,11 @@
 struct ModulationConnection
 {
     int sourceIndex = -1;           // Index into modulation sources array
-    juce::String parameterID;       // Target parameter ID
+    juce::String parameterID;       // Target parameter ID (or a source rate / connection depth ID)
+    int destinationIndex = -1;      // Dense index of parameterID (set by the matrix)
     float depth = 0.5f;             // Modulation depth/amount (0.0 - 1.0)
     bool enabled = true;
+    int connectionID = -1;          // Stable ID, used to address this connection's depth
 
     bool isValid() const
     {
@@ -31,14 +51,223 @@ struct ModulationConnection
     }
 };
 
+// ============================================================================
+// Compiled Route (one enabled connection in the routing table)
+// ============================================================================
+struct CompiledModulationRoute
+{
+    int sourceIndex = -1;
+    float depth = 0.0f;
+    int depthModulationIndex = 0;   // Destination modulating the depth, or the always-zero slot
+};
+
+// ============================================================================
+// Modulation Routing (immutable snapshot shared with the audio thread)
+//
+// Besides plugin parameters, a destination can be a source's rate
+// ("modRate:<source index>") or a connection's depth ("modDepth:<connection
+// ID>"). Depth destinations feed routes of other destinations, so these
+// internal destinations are compiled into a dependency order; edges that
+// close a cycle are dropped from the order and read the previous block's value.
+// ============================================================================
+struct ModulationRouting
+{
+    // Capacity of the audio-thread modulation table. Destinations keep their
+    // index; only a connection-depth destination left without its connection
+    // is reused, and only once the table is full.
+    static constexpr int maxDestinations = 256;
+
+    // Index of an extra table entry that is always zero (for unmodulated depths)
+    static constexpr int zeroModulationIndex = maxDestinations;
+
+    std::vector<ModulationConnection> connections;
+    std::vector<juce::String> destinationIDs;
+    int nextConnectionID = 0;
+
+    // Enabled connections compiled by destination:
+    // routes for destination d are [routeStart[d], routeStart[d + 1])
+    std::vector<CompiledModulationRoute> routes;
+    std::vector<int> routeStart { 0 };
+
+    // Internal destinations (source rates, connection depths)
+    std::vector<char> isInternalDestination;        // Per destination
+    std::vector<int> modulatorOrder;                 // Internal destinations, dependencies first
+    std::vector<int> sourceRateDestination;          // Per source, or -1
+    int numDelayedEdges = 0;                         // Cycle edges that lag by one block
+
+    static juce::String getSourceRateID(int sourceIndex) { return "modRate:" + juce::String(sourceIndex); }
+    static juce::String getConnectionDepthID(int connectionID) { return "modDepth:" + juce::String(connectionID); }
+
+    int getNumDestinations() const { return static_cast<int>(destinationIDs.size()); }
+
+    int findDestination(const juce::String& parameterID) const
+    {
+        auto it = std::find(destinationIDs.begin(), destinationIDs.end(), parameterID);
+        return it != destinationIDs.end() ? static_cast<int>(it - destinationIDs.begin()) : -1;
+    }
+
+    // Appends a destination, or reuses an unused one when the table is full; -1 if none is free
+    int addDestination(const juce::String& parameterID)
+    {
+        if (getNumDestinations() < maxDestinations)
+        {
+            destinationIDs.push_back(parameterID);
+            return getNumDestinations() - 1;
+        }
+
+        const int unused = findUnusedDestination();
+        if (unused >= 0)
+            destinationIDs[static_cast<size_t>(unused)] = parameterID;
+        return unused;
+    }
+
+    // A connection-depth destination whose connection was removed and that no
+    // connection targets (its modulation has resolved to zero since); -1 if none
+    int findUnusedDestination() const
+    {
+        for (int d = 0; d < getNumDestinations(); ++d)
+        {
+            const auto& id = destinationIDs[static_cast<size_t>(d)];
+            if (!id.startsWith("modDepth:"))
+                continue;
+
+            const int connectionID = id.getTrailingIntValue();
+            const bool inUse = std::any_of(connections.begin(), connections.end(), [d, connectionID](const ModulationConnection& conn) {
+                return conn.connectionID == connectionID || conn.destinationIndex == d;
+            });
+
+            if (!inUse)
+                return d;
+        }
+
+        return -1;
+    }
+
+    // Remove connections matching shouldRemove, and with them any connections
+    // that modulated a removed connection's depth (transitively)
+    template <typename Predicate>
+    void removeConnections(Predicate shouldRemove)
+    {
+        std::vector<juce::String> removedDepthIDs;
+        auto isRemoved = [&](const ModulationConnection& conn) {
+            if (shouldRemove(conn)
+                || std::find(removedDepthIDs.begin(), removedDepthIDs.end(), conn.parameterID) != removedDepthIDs.end())
+            {
+                removedDepthIDs.push_back(getConnectionDepthID(conn.connectionID));
+                return true;
+            }
+            return false;
+        };
+
+        for (size_t numRemoved = 0;;)
+        {
+            connections.erase(std::remove_if(connections.begin(), connections.end(), isRemoved), connections.end());
+            if (removedDepthIDs.size() == numRemoved)
+                break;
+            numRemoved = removedDepthIDs.size();
+        }
+    }
+
+    void compile(int numSources)
+    {
+        const int numDestinations = getNumDestinations();
+
+        auto isRouted = [numDestinations, numSources](const ModulationConnection& conn) {
+            return conn.enabled && conn.isValid() && conn.sourceIndex < numSources
+                && conn.destinationIndex >= 0 && conn.destinationIndex < numDestinations;
+        };
+
+        auto depthModulationOf = [this](const ModulationConnection& conn) {
+            const int index = findDestination(getConnectionDepthID(conn.connectionID));
+            return index >= 0 ? index : zeroModulationIndex;
+        };
+
+        routeStart.assign(numDestinations + 1, 0);
+        for (const auto& conn : connections)
+            if (isRouted(conn))
+                ++routeStart[conn.destinationIndex + 1];
+
+        for (int d = 0; d < numDestinations; ++d)
+            routeStart[d + 1] += routeStart[d];
+
+        routes.assign(routeStart[numDestinations], CompiledModulationRoute {});
+        std::vector<int> fill(routeStart.begin(), routeStart.end() - 1);
+        for (const auto& conn : connections)
+            if (isRouted(conn))
+                routes[fill[conn.destinationIndex]++] = { conn.sourceIndex, conn.depth, depthModulationOf(conn) };
+
+        compileModulators(numSources);
+    }
+
+private:
+    // Classify internal destinations and order them so each depth destination
+    // is resolved before the destinations whose routes it scales
+    void compileModulators(int numSources)
+    {
+        const int numDestinations = getNumDestinations();
+        isInternalDestination.assign(numDestinations, 0);
+        sourceRateDestination.assign(numSources, -1);
+
+        for (int d = 0; d < numDestinations; ++d)
+        {
+            const auto& id = destinationIDs[d];
+            if (id.startsWith("modRate:"))
+            {
+                isInternalDestination[d] = 1;
+                const int source = id.getTrailingIntValue();
+                if (source >= 0 && source < numSources)
+                    sourceRateDestination[source] = d;
+            }
+            else if (id.startsWith("modDepth:"))
+            {
+                isInternalDestination[d] = 1;
+            }
+        }
+
+        // Depth-first post-order over "destination d needs depth destination e"
+        modulatorOrder.clear();
+        numDelayedEdges = 0;
+        std::vector<char> state(numDestinations, 0);  // 0 new, 1 on stack, 2 done
+
+        std::function<void(int)> visit = [&](int d) {
+            state[d] = 1;
+            for (int r = routeStart[d]; r < routeStart[d + 1]; ++r)
+            {
+                const int e = routes[r].depthModulationIndex;
+                if (e == zeroModulationIndex)
+                    continue;
+
+                if (state[e] == 1)
+                    ++numDelayedEdges;   // Cycle: e is read as resolved in the previous block
+                else if (state[e] == 0)
+                    visit(e);
+            }
+            state[d] = 2;
+            modulatorOrder.push_back(d);
+        };
+
+        for (int d = 0; d < numDestinations; ++d)
+            if (isInternalDestination[d] && state[d] == 0)
+                visit(d);
+    }
+};
+
 // ============================================================================
 // Modulation Matrix
 // ============================================================================
 class ModulationMatrix
 {
 public:
+    static constexpr int maxDestinations = ModulationRouting::maxDestinations;
+
+    // Rate modulation of +/-1 scales a source's rate by this many octaves
+    static constexpr float rateModulationOctaves = 2.0f;
+
     ModulationMatrix()
+        : routingPublisher(std::make_unique<ModulationRouting>())
     {
+        destinationModulation.assign(maxDestinations + 1, 0.0f);   // + the always-zero slot
+
         // Create default modulation sources
         addSource(std::make_unique<LFOModulationSource>());
         addSource(std::make_unique<LFOModulationSource>());
@@ -51,7 +280,20 @@ public:
     // Source management
     int addSource(std::unique_ptr<ModulationSource> source)
     {
+        int bankSlot = -1;
+        if (auto* banked = dynamic_cast<BankedModulationSource*>(source.get()))
+        {
+            banked->moveToBank(sourceBank);
+            bankSlot = banked->getBankSlot();
+        }
+
+        sourceBankSlots.push_back(bankSlot);
         sources.push_back(std::move(source));
+        sourceValues.assign(sources.size(), 0.0f);
+        bankValues.assign(sourceBank.getNumSlots(), 0.0f);
+
+        // Connections to this source index may already exist
+        publishRoutingEdit([](ModulationRouting&) {});
         return sources.size() - 1;
     }
 
@@ -64,50 +306,145 @@ public:
 
     int getNumSources() const { return sources.size(); }
 
-    // Connection management
+    //==============================================================================
+    // Message thread: every routing edit copies the latest routing and publishes it
+
+    // Latest published routing
+    const ModulationRouting& getRouting() const { return routingPublisher.getLatest(); }
+
+    // Destination management: parameters are addressed by a dense index.
+    // Register destinations up front (e.g. in parameter order); unknown IDs
+    // used by connections are registered on demand. Returns -1 when the
+    // table is full and no depth destination can be reused.
+    int registerDestination(const juce::String& parameterID)
+    {
+        int index = getDestinationIndex(parameterID);
+        if (index >= 0)
+            return index;
+
+        publishRoutingEdit([&parameterID, &index](ModulationRouting& routing) {
+            index = routing.addDestination(parameterID);
+        });
+        return index;
+    }
+
+    // String lookup; resolve once and keep the index on realtime paths
+    int getDestinationIndex(const juce::String& parameterID) const
+    {
+        return getRouting().findDestination(parameterID);
+    }
+
+    int getNumDestinations() const { return getRouting().getNumDestinations(); }
+
+    // Connection management; returns the new connection's index, or -1 if
+    // its destination could not be registered (the table is full)
     int addConnection(int sourceIndex, const juce::String& parameterID, float depth = 0.5f)
     {
         ModulationConnection conn;
         conn.sourceIndex = sourceIndex;
         conn.parameterID = parameterID;
+        conn.destinationIndex = registerDestination(parameterID);
         conn.depth = depth;
         conn.enabled = true;
 
-        connections.push_back(conn);
-        return connections.size() - 1;
+        if (conn.destinationIndex < 0)
+            return -1;
+
+        publishRoutingEdit([&conn](ModulationRouting& routing) {
+            conn.connectionID = routing.nextConnectionID++;
+            routing.connections.push_back(conn);
+        });
+        return getNumConnections() - 1;
     }
 
+    // Removes the connection and any connections modulating its depth
     void removeConnection(int connectionIndex)
     {
-        if (connectionIndex >= 0 && connectionIndex < connections.size())
-            connections.erase(connections.begin() + connectionIndex);
+        if (connectionIndex >= 0 && connectionIndex < getNumConnections())
+        {
+            publishRoutingEdit([connectionIndex](ModulationRouting& routing) {
+                const int connectionID = routing.connections[connectionIndex].connectionID;
+                routing.removeConnections([connectionID](const ModulationConnection& conn) {
+                    return conn.connectionID == connectionID;
+                });
+            });
+        }
+    }
+
+    // Modulation-of-modulation: destination IDs for a source's rate and a
+    // connection's depth, usable with addConnection like parameter IDs
+    static juce::String getSourceRateDestinationID(int sourceIndex)
+    {
+        return ModulationRouting::getSourceRateID(sourceIndex);
+    }
+
+    juce::String getConnectionDepthDestinationID(int connectionIndex) const
+    {
+        const auto* conn = getConnection(connectionIndex);
+        return conn ? ModulationRouting::getConnectionDepthID(conn->connectionID) : juce::String();
+    }
+
+    // Index of the connection with this stable ID, or -1
+    int getConnectionIndex(int connectionID) const
+    {
+        const auto& connections = getConnections();
+        for (int i = 0; i < static_cast<int>(connections.size()); ++i)
+            if (connections[static_cast<size_t>(i)].connectionID == connectionID)
+                return i;
+        return -1;
+    }
+
+    // Number of modulation-of-modulation edges that close a cycle (they lag by one block)
+    int getNumDelayedModulationEdges() const { return getRouting().numDelayedEdges; }
+
+    void setConnectionDepth(int connectionIndex, float depth)
+    {
+        if (connectionIndex >= 0 && connectionIndex < getNumConnections())
+        {
+            publishRoutingEdit([connectionIndex, depth](ModulationRouting& routing) {
+                routing.connections[connectionIndex].depth = depth;
+            });
+        }
+    }
+
+    void setConnectionEnabled(int connectionIndex, bool enabled)
+    {
+        if (connectionIndex >= 0 && connectionIndex < getNumConnections())
+        {
+            publishRoutingEdit([connectionIndex, enabled](ModulationRouting& routing) {
+                routing.connections[connectionIndex].enabled = enabled;
+            });
+        }
     }
 
     void removeConnectionsForParameter(const juce::String& parameterID)
     {
-        connections.erase(
-            std::remove_if(connections.begin(), connections.end(),
-                [&parameterID](const ModulationConnection& conn) {
-                    return conn.parameterID == parameterID;
-                }),
-            connections.end());
+        publishRoutingEdit([&parameterID](ModulationRouting& routing) {
+            routing.removeConnections([&parameterID](const ModulationConnection& conn) {
+                return conn.parameterID == parameterID;
+            });
+        });
     }
 
-    ModulationConnection* getConnection(int index)
+    // Read-only, valid until the next routing edit: edit through
+    // setConnectionDepth / setConnectionEnabled so a new routing is published
+    const ModulationConnection* getConnection(int index) const
     {
+        const auto& connections = getConnections();
         if (index >= 0 && index < connections.size())
             return &connections[index];
         return nullptr;
     }
 
-    int getNumConnections() const { return connections.size(); }
+    int getNumConnections() const { return static_cast<int>(getConnections().size()); }
 
     // Get all connections (for iteration)
-    const std::vector<ModulationConnection>& getConnections() const { return connections; }
+    const std::vector<ModulationConnection>& getConnections() const { return getRouting().connections; }
 
     // Get all connections for a specific parameter
     std::vector<int> getConnectionsForParameter(const juce::String& parameterID) const
     {
+        const auto& connections = getConnections();
         std::vector<int> indices;
         for (int i = 0; i < connections.size(); ++i)
         {
@@ -117,35 +454,91 @@ public:
         return indices;
     }
 
-    // Calculate total modulation value for a parameter
+    // Reclaims superseded routings (call periodically from the message thread)
+    void collectGarbage() { routingPublisher.collectGarbage(); }
+
+    // Calculate total modulation value for a parameter from the current source values
+    // (for the UI; the audio thread uses resolveModulation / getModulation)
     float calculateModulation(const juce::String& parameterID) const
     {
-        float totalModulation = 0.0f;
+        return calculateModulation(getDestinationIndex(parameterID));
+    }
 
-        for (const auto& conn : connections)
+    float calculateModulation(int destinationIndex) const
+    {
+        const auto& routing = getRouting();
+        if (destinationIndex < 0 || destinationIndex >= routing.getNumDestinations())
+            return 0.0f;
+
+        float totalModulation = 0.0f;
+        for (int r = routing.routeStart[destinationIndex]; r < routing.routeStart[destinationIndex + 1]; ++r)
         {
-            if (conn.parameterID == parameterID && conn.enabled && conn.isValid())
-            {
-                auto* source = const_cast<ModulationMatrix*>(this)->getSource(conn.sourceIndex);
-                if (source && source->getEnabled())
-                {
-                    float modValue = source->getNormalizedValue();
-                    totalModulation += modValue * conn.depth;
-                }
-            }
+            const auto& route = routing.routes[r];
+            const auto* source = sources[route.sourceIndex].get();
+            if (source && source->getEnabled())
+                totalModulation += source->getNormalizedValue() * getEffectiveDepth(route);
         }
 
         return juce::jlimit(-1.0f, 1.0f, totalModulation);
     }
 
-    // Update all modulation sources
+    //==============================================================================
+    // Audio thread
+
+    // Resolve every destination for this block: read each source once, then
+    // walk the compiled routes of the newest routing in one linear pass
+    void resolveModulation()
+    {
+        resolveModulationAt(0.0);
+    }
+
+    // Same, with every source evaluated secondsAhead of its current state
+    // (closed form, sources are not advanced). Used for events inside a block.
+    void resolveModulationAt(double secondsAhead)
+    {
+        evaluateSources(secondsAhead);
+
+        // Internal destinations (source rates, connection depths) keep the
+        // values resolved once per block by advance()
+        const auto& routing = routingPublisher.acquire();
+        const int numDestinations = routing.getNumDestinations();
+        for (int d = 0; d < numDestinations; ++d)
+            if (!routing.isInternalDestination[d])
+                destinationModulation[d] = accumulateDestination(routing, d);
+    }
+
+    // Modulation resolved by the last resolveModulation() / resolveModulationAt() call
+    float getModulation(int destinationIndex) const
+    {
+        if (destinationIndex < 0 || destinationIndex >= maxDestinations)
+            return 0.0f;
+        return destinationModulation[destinationIndex];
+    }
+
+    // Phase-lock tempo-synced sources to the transport (position in quarter notes).
+    // Call at the start of each block, before modulation is resolved.
+    void syncToTransport(double beatPosition, double beatsPerSecond)
+    {
+        sourceBank.syncToTransport(beatPosition, beatsPerSecond);
+    }
+
+    // Update all modulation sources: banked ones in one pass, disabled ones hold
     void advance(double timeSeconds)
     {
-        for (auto& source : sources)
+        for (size_t s = 0; s < sources.size(); ++s)
         {
-            if (source && source->getEnabled())
+            auto* source = sources[s].get();
+            const int bankSlot = sourceBankSlots[s];
+
+            if (bankSlot >= 0)
+                sourceBank.setActive(bankSlot, source->getEnabled());
+            else if (source && source->getEnabled())
                 source->advance(timeSeconds);
         }
+
+        sourceBank.advance(timeSeconds);
+
+        resolveModulators();
     }
 
     // Reset all sources
@@ -158,18 +551,10 @@ public:
         }
     }
 
-    // Trigger envelopes
+    // Trigger envelopes (all envelopes are banked)
     void triggerEnvelopes()
     {
-        for (auto& source : sources)
-        {
-            if (source && source->getType() == ModulationSourceType::Envelope)
-            {
-                auto* env = dynamic_cast<EnvelopeModulationSource*>(source.get());
-                if (env)
-                    env->trigger();
-            }
-        }
+        sourceBank.triggerEnvelopes();
     }
 
     // Serialization
@@ -178,38 +563,149 @@ public:
         auto xml = std::make_unique<juce::XmlElement>("ModulationMatrix");
 
         // Save connections
-        for (const auto& conn : connections)
+        for (const auto& conn : getConnections())
         {
             auto connXml = xml->createNewChildElement("Connection");
             connXml->setAttribute("sourceIndex", conn.sourceIndex);
             connXml->setAttribute("parameterID", conn.parameterID);
             connXml->setAttribute("depth", conn.depth);
             connXml->setAttribute("enabled", conn.enabled);
+            connXml->setAttribute("id", conn.connectionID);
         }
 
         return xml;
     }
 
+    // Replaces all connections, published as a single routing
     void fromXml(const juce::XmlElement& xml)
     {
-        connections.clear();
+        publishRoutingEdit([&xml](ModulationRouting& routing) {
+            routing.connections.clear();
+            routing.nextConnectionID = 0;
+
+            for (auto* connXml : xml.getChildWithTagNameIterator("Connection"))
+            {
+                ModulationConnection conn;
+                conn.sourceIndex = connXml->getIntAttribute("sourceIndex", -1);
+                conn.parameterID = connXml->getStringAttribute("parameterID");
+                conn.depth = static_cast<float>(connXml->getDoubleAttribute("depth", 0.5));
+                conn.enabled = connXml->getBoolAttribute("enabled", true);
+                conn.connectionID = connXml->getIntAttribute("id", -1);
+
+                if (!conn.isValid())
+                    continue;
+
+                conn.destinationIndex = routing.findDestination(conn.parameterID);
+                if (conn.destinationIndex < 0)
+                    conn.destinationIndex = routing.addDestination(conn.parameterID);
+
+                // Table full: drop the connection rather than keep one that cannot route
+                if (conn.destinationIndex < 0)
+                    continue;
+
+                routing.connections.push_back(conn);
+            }
+
+            // Keep saved IDs (depth destinations refer to them); number the rest after them
+            for (const auto& conn : routing.connections)
+                routing.nextConnectionID = juce::jmax(routing.nextConnectionID, conn.connectionID + 1);
+
+            for (auto& conn : routing.connections)
+                if (conn.connectionID < 0)
+                    conn.connectionID = routing.nextConnectionID++;
+        });
+    }
+
+private:
+    // Audio thread: current value of every source secondsAhead, into sourceValues
+    void evaluateSources(double secondsAhead)
+    {
+        sourceBank.evaluate(secondsAhead, bankValues.data());
+
+        for (size_t s = 0; s < sources.size(); ++s)
+        {
+            const auto* source = sources[s].get();
+            const int bankSlot = sourceBankSlots[s];
+
+            if (!source || !source->getEnabled())
+                sourceValues[s] = 0.0f;
+            else if (bankSlot >= 0)
+                sourceValues[s] = bankValues[bankSlot];
+            else
+                sourceValues[s] = source->getNormalizedValueAt(secondsAhead);
+        }
+    }
+
+    // Route depth plus any modulation of that depth (resolved once per block)
+    float getEffectiveDepth(const CompiledModulationRoute& route) const
+    {
+        return juce::jlimit(-1.0f, 1.0f, route.depth + destinationModulation[route.depthModulationIndex]);
+    }
+
+    float accumulateDestination(const ModulationRouting& routing, int destinationIndex) const
+    {
+        float totalModulation = 0.0f;
+        for (int r = routing.routeStart[destinationIndex]; r < routing.routeStart[destinationIndex + 1]; ++r)
+        {
+            const auto& route = routing.routes[r];
+            totalModulation += sourceValues[route.sourceIndex] * getEffectiveDepth(route);
+        }
+
+        return juce::jlimit(-1.0f, 1.0f, totalModulation);
+    }
+
+    // Once per block, after the sources advance: resolve source-rate and
+    // connection-depth destinations in dependency order (one pass; cycle edges
+    // read last block's value), then apply the rate scales for the next block
+    void resolveModulators()
+    {
+        const auto& routing = routingPublisher.acquire();
 
-        for (auto* connXml : xml.getChildWithTagNameIterator("Connection"))
+        if (!routing.modulatorOrder.empty())
         {
-            ModulationConnection conn;
-            conn.sourceIndex = connXml->getIntAttribute("sourceIndex", -1);
-            conn.parameterID = connXml->getStringAttribute("parameterID");
-            conn.depth = static_cast<float>(connXml->getDoubleAttribute("depth", 0.5));
-            conn.enabled = connXml->getBoolAttribute("enabled", true);
+            evaluateSources(0.0);
 
-            if (conn.isValid())
-                connections.push_back(conn);
+            for (const int d : routing.modulatorOrder)
+                destinationModulation[d] = accumulateDestination(routing, d);
+        }
+
+        const int numRated = juce::jmin(static_cast<int>(sources.size()), static_cast<int>(routing.sourceRateDestination.size()));
+        for (int s = 0; s < numRated; ++s)
+        {
+            const int rateDestination = routing.sourceRateDestination[s];
+            const float scale = rateDestination >= 0
+                ? std::exp2(rateModulationOctaves * destinationModulation[rateDestination])
+                : 1.0f;
+
+            if (sourceBankSlots[s] >= 0)
+                sourceBank.setRateScale(sourceBankSlots[s], scale);
+            else if (sources[s])
+                sources[s]->setRateScale(scale);
         }
     }
 
-private:
+    // Copies the latest routing, applies edit, recompiles and publishes it
+    template <typename EditFunction>
+    void publishRoutingEdit(EditFunction&& edit)
+    {
+        auto next = routingPublisher.copyLatest();
+        edit(*next);
+        next->compile(getNumSources());
+        routingPublisher.publish(std::move(next));
+    }
+
+    // Declared before the sources that point into it
+    ModulationSourceBank sourceBank;
+    std::vector<int> sourceBankSlots;   // Bank slot per source, -1 if not banked
+    std::vector<float> bankValues;
+
     std::vector<std::unique_ptr<ModulationSource>> sources;
-    std::vector<ModulationConnection> connections;
+
+    SnapshotPublisher<ModulationRouting> routingPublisher;
+
+    // Audio-thread scratch and results (sized up front, never reallocated while processing)
+    std::vector<float> sourceValues;
+    std::vector<float> destinationModulation;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
 };
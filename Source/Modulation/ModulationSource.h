@@ -5,12 +5,18 @@
     Base class for modulation sources (LFO, Envelope, Random, etc.)
     Provides normalized 0.0-1.0 output values
 
+    LFO, Random and Envelope sources are adapters over a slot of a
+    ModulationSourceBank, so a matrix full of them is processed in batches.
+
   ==============================================================================
 */
 
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "../Core/SimplexNoise.h"
+#include "ModulationSourceBank.h"
+#include <memory>
 
 // ============================================================================
 // Modulation Source Types
@@ -21,9 +27,53 @@ enum class ModulationSourceType
     Envelope,
     Random,
     StepSequencer,
+    Noise,
     None
 };
 
+// ============================================================================
+// Tempo Sync Divisions (one LFO cycle / random step per division)
+// ============================================================================
+enum class ModulationSyncDivision
+{
+    Free,               // Runs at its own rate in seconds
+    FourBars,
+    TwoBars,
+    OneBar,
+    Half,
+    DottedQuarter,
+    Quarter,
+    QuarterTriplet,
+    DottedEighth,
+    Eighth,
+    EighthTriplet,
+    Sixteenth,
+    SixteenthTriplet,
+    ThirtySecond
+};
+
+// Length of a division in quarter notes (0 for Free); bars are 4/4
+inline double getSyncDivisionLengthInBeats(ModulationSyncDivision division)
+{
+    switch (division)
+    {
+        case ModulationSyncDivision::FourBars:         return 16.0;
+        case ModulationSyncDivision::TwoBars:          return 8.0;
+        case ModulationSyncDivision::OneBar:           return 4.0;
+        case ModulationSyncDivision::Half:             return 2.0;
+        case ModulationSyncDivision::DottedQuarter:    return 1.5;
+        case ModulationSyncDivision::Quarter:          return 1.0;
+        case ModulationSyncDivision::QuarterTriplet:   return 2.0 / 3.0;
+        case ModulationSyncDivision::DottedEighth:     return 0.75;
+        case ModulationSyncDivision::Eighth:           return 0.5;
+        case ModulationSyncDivision::EighthTriplet:    return 1.0 / 3.0;
+        case ModulationSyncDivision::Sixteenth:        return 0.25;
+        case ModulationSyncDivision::SixteenthTriplet: return 1.0 / 6.0;
+        case ModulationSyncDivision::ThirtySecond:     return 0.125;
+        default:                                       return 0.0;
+    }
+}
+
 // ============================================================================
 // Base Modulation Source
 // ============================================================================
@@ -36,6 +86,10 @@ public:
     // Get current modulation value (0.0 - 1.0, can be bipolar -1.0 to +1.0)
     virtual float getValue() const = 0;
 
+    // Value secondsAhead after the current state, in closed form; the state is
+    // not advanced. Lets events inside a block see the source at their own time.
+    virtual float getValueAt(double secondsAhead) const { juce::ignoreUnused(secondsAhead); return getValue(); }
+
     // Advance modulation state
     virtual void advance(double timeSeconds) = 0;
 
@@ -48,6 +102,10 @@ public:
     // Get display name
     virtual juce::String getName() const = 0;
 
+    // Multiplier on the source's own rate, set by the matrix's rate modulation
+    // (1 = unmodulated). Sources without a rate ignore it.
+    virtual void setRateScale(float scale) { juce::ignoreUnused(scale); }
+
     // Enable/disable
     void setEnabled(bool enabled) { isEnabled = enabled; }
     bool getEnabled() const { return isEnabled; }
@@ -69,6 +127,15 @@ public:
             return val; // 0 to 1
     }
 
+    // Normalized value secondsAhead after the current state (see getValueAt)
+    float getNormalizedValueAt(double secondsAhead) const
+    {
+        if (!isEnabled)
+            return isBipolar ? 0.0f : 0.5f;
+
+        return getValueAt(secondsAhead);
+    }
+
 protected:
     bool isEnabled = true;
     bool isBipolar = false;
@@ -77,12 +144,85 @@ protected:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationSource)
 };
 
+// ============================================================================
+// Banked Modulation Source
+// Adapter for sources whose state lives in a ModulationSourceBank slot. A
+// source starts with a private one-slot bank; ModulationMatrix::addSource
+// moves it into the matrix's shared bank, which then advances and evaluates
+// every banked source in one batched pass.
+// ============================================================================
+class BankedModulationSource : public ModulationSource
+{
+public:
+    float getValue() const override
+    {
+        return bank->getValue(slot);
+    }
+
+    float getValueAt(double secondsAhead) const override
+    {
+        return bank->getValueAt(slot, secondsAhead);
+    }
+
+    void advance(double timeSeconds) override
+    {
+        bank->advance(timeSeconds, slot, slot + 1);
+    }
+
+    void reset() override
+    {
+        bank->resetSlot(slot);
+    }
+
+    void setRateScale(float scale) override
+    {
+        bank->setRateScale(slot, scale);
+    }
+
+    // Move this source's slot (settings and state) into a shared bank that
+    // outlives the source. Done once, when the source joins a matrix.
+    void moveToBank(ModulationSourceBank& target)
+    {
+        if (&target == bank)
+            return;
+
+        slot = target.adoptSlot(*bank, slot);
+        bank = &target;
+        ownBank.reset();
+    }
+
+    ModulationSourceBank& getBank() const { return *bank; }
+    int getBankSlot() const { return slot; }
+
+protected:
+    // Sync the slot to a note division, or run it free (periodic slots only)
+    void setSlotSyncDivision(ModulationSyncDivision division)
+    {
+        syncDivision = division;
+        const double length = getSyncDivisionLengthInBeats(division);
+        bank->setSync(slot, length > 0.0 ? 1.0 / length : 0.0);
+    }
+
+    BankedModulationSource()
+        : ownBank(std::make_unique<ModulationSourceBank>()), bank(ownBank.get())
+    {
+    }
+
+    std::unique_ptr<ModulationSourceBank> ownBank;
+    ModulationSourceBank* bank;
+    int slot = 0;
+    ModulationSyncDivision syncDivision = ModulationSyncDivision::Free;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BankedModulationSource)
+};
+
 // ============================================================================
 // LFO Modulation Source
 // ============================================================================
-class LFOModulationSource : public ModulationSource
+class LFOModulationSource : public BankedModulationSource
 {
 public:
+    // Matches ModulationSourceBank::Shape for the periodic shapes
     enum class Waveform
     {
         Sine,
@@ -94,124 +234,88 @@ public:
     };
 
     LFOModulationSource()
+        : LFOModulationSource({}, Waveform::Sine, 1.0f, true) // LFOs are typically bipolar
     {
-        setBipolar(true); // LFOs are typically bipolar
     }
 
     LFOModulationSource(const juce::String& sourceName, Waveform wave, float freq, bool isBipolar)
-        : waveform(wave), rate(freq)
     {
         customName = sourceName;
         setBipolar(isBipolar);
+        slot = bank->addPeriodic(static_cast<ModulationSourceBank::Shape>(wave), freq);
     }
 
-    float getValue() const override
-    {
-        return currentValue;
-    }
+    ModulationSourceType getType() const override { return ModulationSourceType::LFO; }
+    juce::String getName() const override { return customName.isEmpty() ? "LFO" : customName; }
 
-    void advance(double timeSeconds) override
+    // LFO-specific parameters
+    void setRate(float hz) { bank->setRate(slot, hz); }
+    float getRate() const { return bank->getRate(slot); }
+
+    void setWaveform(Waveform wf) { bank->setShape(slot, static_cast<ModulationSourceBank::Shape>(wf)); }
+    Waveform getWaveform() const { return static_cast<Waveform>(bank->getShape(slot)); }
+
+    // One cycle per note division, phase-locked to the transport (Free uses the rate)
+    void setSyncDivision(ModulationSyncDivision division) { setSlotSyncDivision(division); }
+    ModulationSyncDivision getSyncDivision() const { return syncDivision; }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LFOModulationSource)
+};
+
+// ============================================================================
+// Random Modulation Source (new 0-1 value every interval: a sample-and-hold slot)
+// ============================================================================
+class RandomModulationSource : public BankedModulationSource
+{
+public:
+    RandomModulationSource()
+        : RandomModulationSource({}, 0.1f, false)
     {
-        phase += rate * timeSeconds;
-
-        // Wrap phase
-        while (phase >= 1.0)
-            phase -= 1.0;
-
-        // Calculate waveform
-        switch (waveform)
-        {
-            case Waveform::Sine:
-                currentValue = std::sin(phase * juce::MathConstants<float>::twoPi);
-                break;
-
-            case Waveform::Triangle:
-                currentValue = phase < 0.5
-                    ? (phase * 4.0f - 1.0f)
-                    : (3.0f - phase * 4.0f);
-                break;
-
-            case Waveform::Saw:
-                currentValue = phase * 2.0f - 1.0f;
-                break;
-
-            case Waveform::Square:
-                currentValue = phase < 0.5 ? -1.0f : 1.0f;
-                break;
-
-            case Waveform::Random:
-            {
-                // Smooth random interpolation
-                if (phase < lastPhase) // Wrapped
-                {
-                    randomStart = randomEnd;
-                    randomEnd = random.nextFloat() * 2.0f - 1.0f;
-                }
-                float t = phase;
-                currentValue = randomStart + (randomEnd - randomStart) * t;
-                break;
-            }
-
-            case Waveform::SampleAndHold:
-                if (phase < lastPhase) // Wrapped
-                    currentValue = random.nextFloat() * 2.0f - 1.0f;
-                break;
-        }
-
-        lastPhase = phase;
     }
 
-    void reset() override
+    RandomModulationSource(const juce::String& sourceName, float intervalSeconds, bool isBipolar)
     {
-        phase = 0.0;
-        lastPhase = 0.0;
-        currentValue = 0.0f;
-        randomStart = 0.0f;
-        randomEnd = 0.0f;
+        customName = sourceName;
+        setBipolar(isBipolar);
+        slot = bank->addPeriodic(ModulationSourceBank::Shape::SampleAndHold, 1.0f, 0.0f, 1.0f);
+        setInterval(intervalSeconds);
     }
 
-    ModulationSourceType getType() const override { return ModulationSourceType::LFO; }
-    juce::String getName() const override { return customName.isEmpty() ? "LFO" : customName; }
+    ModulationSourceType getType() const override { return ModulationSourceType::Random; }
+    juce::String getName() const override { return customName.isEmpty() ? "Random" : customName; }
 
-    // LFO-specific parameters
-    void setRate(float hz) { rate = juce::jlimit(0.01f, 100.0f, hz); }
-    float getRate() const { return rate; }
+    // Random-specific parameters
+    void setInterval(float seconds) { bank->setRate(slot, 1.0f / juce::jmax(0.01f, seconds)); }
+    float getInterval() const { return 1.0f / bank->getRate(slot); }
 
-    void setWaveform(Waveform wf) { waveform = wf; }
-    Waveform getWaveform() const { return waveform; }
+    // One new value per note division, on the transport grid (Free uses the interval).
+    // Synced values are a function of the transport position, so renders repeat.
+    void setSyncDivision(ModulationSyncDivision division) { setSlotSyncDivision(division); }
+    ModulationSyncDivision getSyncDivision() const { return syncDivision; }
 
 private:
-    float rate = 1.0f; // Hz
-    Waveform waveform = Waveform::Sine;
-    double phase = 0.0;
-    double lastPhase = 0.0;
-    mutable float currentValue = 0.0f;
-
-    // Random waveform state
-    mutable float randomStart = 0.0f;
-    mutable float randomEnd = 0.0f;
-    juce::Random random;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LFOModulationSource)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RandomModulationSource)
 };
 
 // ============================================================================
-// Random Modulation Source
+// Noise Modulation Source (smooth multi-octave simplex noise)
 // ============================================================================
-class RandomModulationSource : public ModulationSource
+class NoiseModulationSource : public ModulationSource
 {
 public:
-    RandomModulationSource()
+    NoiseModulationSource()
     {
-        currentValue = random.nextFloat();
+        setBipolar(true);
+        noise.setSeed(static_cast<uint32_t>(random.nextInt()));
     }
 
-    RandomModulationSource(const juce::String& sourceName, float intervalSeconds, bool isBipolar)
-        : interval(intervalSeconds)
+    NoiseModulationSource(const juce::String& sourceName, float rateHz, int numOctaves, bool isBipolar)
+        : rate(rateHz), octaves(juce::jlimit(1, SimplexNoise::maxOctaves, numOctaves))
     {
         customName = sourceName;
         setBipolar(isBipolar);
-        currentValue = random.nextFloat();
+        noise.setSeed(static_cast<uint32_t>(random.nextInt()));
     }
 
     float getValue() const override
@@ -219,52 +323,92 @@ public:
         return currentValue;
     }
 
+    float getValueAt(double secondsAhead) const override
+    {
+        float primary = 0.0f, secondary = 0.0f;
+        noise.fractal(static_cast<float>(noiseTime + getScaledRate() * secondsAhead), octaves, primary, secondary);
+        return toOutput(primary);
+    }
+
     void advance(double timeSeconds) override
     {
-        timer += timeSeconds;
+        noiseTime += getScaledRate() * timeSeconds;
 
-        if (timer >= interval)
-        {
-            timer = 0.0;
-            currentValue = random.nextFloat();
-        }
+        float primary = 0.0f, secondary = 0.0f;
+        noise.fractal(static_cast<float>(noiseTime), octaves, primary, secondary);
+        currentValue = toOutput(primary);
+    }
+
+    // Fill numValues values spaced secondsPerValue apart (one batch per block),
+    // advancing the source past them. Cheap enough for per-sample modulation.
+    void renderBlock(float* dest, int numValues, double secondsPerValue)
+    {
+        if (numValues <= 0)
+            return;
+
+        const double step = getScaledRate() * secondsPerValue;
+        noise.fractalBlock(static_cast<float>(noiseTime + step), static_cast<float>(step), octaves, dest, numValues);
+
+        for (int i = 0; i < numValues; ++i)
+            dest[i] = toOutput(dest[i]);
+
+        noiseTime += step * numValues;
+        currentValue = dest[numValues - 1];
     }
 
     void reset() override
     {
-        timer = 0.0;
-        currentValue = random.nextFloat();
+        noiseTime = 0.0;
+        currentValue = isBipolar ? 0.0f : 0.5f;
     }
 
-    ModulationSourceType getType() const override { return ModulationSourceType::Random; }
-    juce::String getName() const override { return customName.isEmpty() ? "Random" : customName; }
+    void setRateScale(float scale) override { rateScale = juce::jmax(0.0f, scale); }
 
-    // Random-specific parameters
-    void setInterval(float seconds) { interval = juce::jmax(0.01f, seconds); }
-    float getInterval() const { return interval; }
+    ModulationSourceType getType() const override { return ModulationSourceType::Noise; }
+    juce::String getName() const override { return customName.isEmpty() ? "Noise" : customName; }
+
+    // Noise-specific parameters
+    void setRate(float hz) { rate = juce::jlimit(0.01f, 100.0f, hz); }
+    float getRate() const { return rate; }
+
+    void setOctaves(int numOctaves) { octaves = juce::jlimit(1, SimplexNoise::maxOctaves, numOctaves); }
+    int getOctaves() const { return octaves; }
 
 private:
-    float interval = 0.1f; // Seconds between random values
-    double timer = 0.0;
+    float toOutput(float bipolarValue) const
+    {
+        return isBipolar ? bipolarValue : 0.5f + 0.5f * bipolarValue;
+    }
+
+    double getScaledRate() const { return static_cast<double>(rate) * rateScale; }
+
+    float rate = 0.5f; // Lattice cells per second at the lowest octave
+    float rateScale = 1.0f;
+    int octaves = 3;
+    double noiseTime = 0.0;
     float currentValue = 0.0f;
+    SimplexNoise noise;
     juce::Random random;
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RandomModulationSource)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NoiseModulationSource)
 };
 
 // ============================================================================
 // Envelope Modulation Source (Simple AD envelope per note)
 // ============================================================================
-class EnvelopeModulationSource : public ModulationSource
+class EnvelopeModulationSource : public BankedModulationSource
 {
 public:
-    EnvelopeModulationSource() = default;
+    EnvelopeModulationSource()
+        : EnvelopeModulationSource({}, 0.01f, 0.5f, false)
+    {
+    }
 
     EnvelopeModulationSource(const juce::String& sourceName, float attack, float decay, bool isBipolar)
-        : attackTime(attack), decayTime(decay)
     {
         customName = sourceName;
         setBipolar(isBipolar);
+        slot = bank->addEnvelope(attack, decay);
     }
 
     enum class Stage
@@ -274,77 +418,30 @@ public:
         Decay
     };
 
-    float getValue() const override
-    {
-        return currentValue;
-    }
-
-    void advance(double timeSeconds) override
-    {
-        switch (stage)
-        {
-            case Stage::Idle:
-                currentValue = 0.0f;
-                break;
-
-            case Stage::Attack:
-                stageTime += timeSeconds;
-                if (stageTime >= attackTime)
-                {
-                    stage = Stage::Decay;
-                    stageTime = 0.0;
-                    currentValue = 1.0f;
-                }
-                else
-                {
-                    currentValue = stageTime / attackTime;
-                }
-                break;
-
-            case Stage::Decay:
-                stageTime += timeSeconds;
-                if (stageTime >= decayTime)
-                {
-                    stage = Stage::Idle;
-                    currentValue = 0.0f;
-                }
-                else
-                {
-                    currentValue = 1.0f - (stageTime / decayTime);
-                }
-                break;
-        }
-    }
-
-    void reset() override
+    // The slot's phase is the time since the trigger
+    Stage getStage() const
     {
-        stage = Stage::Idle;
-        stageTime = 0.0;
-        currentValue = 0.0f;
+        const float time = bank->getPhase(slot);
+        if (time < bank->getAttackTime(slot))
+            return Stage::Attack;
+        return time < bank->getAttackTime(slot) + bank->getDecayTime(slot) ? Stage::Decay : Stage::Idle;
     }
 
     void trigger()
     {
-        stage = Stage::Attack;
-        stageTime = 0.0;
+        bank->trigger(slot);
     }
 
     ModulationSourceType getType() const override { return ModulationSourceType::Envelope; }
     juce::String getName() const override { return customName.isEmpty() ? "Envelope" : customName; }
 
     // Envelope-specific parameters
-    void setAttackTime(float seconds) { attackTime = juce::jmax(0.001f, seconds); }
-    float getAttackTime() const { return static_cast<float>(attackTime); }
+    void setAttackTime(float seconds) { bank->setEnvelopeTimes(slot, seconds, getDecayTime()); }
+    float getAttackTime() const { return bank->getAttackTime(slot); }
 
-    void setDecayTime(float seconds) { decayTime = juce::jmax(0.001f, seconds); }
-    float getDecayTime() const { return static_cast<float>(decayTime); }
+    void setDecayTime(float seconds) { bank->setEnvelopeTimes(slot, getAttackTime(), seconds); }
+    float getDecayTime() const { return bank->getDecayTime(slot); }
 
 private:
-    Stage stage = Stage::Idle;
-    double stageTime = 0.0;
-    float currentValue = 0.0f;
-    double attackTime = 0.01; // Seconds
-    double decayTime = 0.5;    // Seconds
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EnvelopeModulationSource)
 };
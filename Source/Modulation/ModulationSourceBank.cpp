@@ -0,0 +1,380 @@
+#include "ModulationSourceBank.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+    constexpr float minimumStageTime = 0.001f;
+
+    // sin(pi/2 * t) for t in [-1, 1] (odd Taylor series to t^9, error below 4e-6)
+    inline float quarterSine(float t)
+    {
+        const float t2 = t * t;
+        return t * (1.5707963f - t2 * (0.6459641f - t2 * (0.0796926f - t2 * (0.0046818f - t2 * 0.0001604f))));
+    }
+
+    inline uint32_t mixBits(uint32_t h)
+    {
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return h;
+    }
+}
+
+ModulationSourceBank::ModulationSourceBank()
+    : rngState(std::random_device {}() | 1u)
+{
+}
+
+// ============================================================================
+// Slots
+// ============================================================================
+
+int ModulationSourceBank::addSlot(Shape slotShape, float slotRate, float slotMin, float slotMax)
+{
+    const bool isEnvelope = slotShape == Shape::Envelope;
+
+    phase.push_back(0.0f);
+    rate.push_back(slotRate);
+    freeRate.push_back(slotRate);
+    rateScale.push_back(1.0f);
+    limit.push_back(1.0f);
+    periodic.push_back(isEnvelope ? 0.0f : 1.0f);
+    shape.push_back(static_cast<int32_t>(slotShape));
+    active.push_back(1.0f);
+    attack.push_back(minimumStageTime);
+    decay.push_back(minimumStageTime);
+    inverseAttack.push_back(1.0f / minimumStageTime);
+    inverseDecay.push_back(1.0f / minimumStageTime);
+    randomStart.push_back(0.0f);
+    randomEnd.push_back(0.0f);
+    randomNext.push_back(0.0f);
+    randomMin.push_back(slotMin);
+    randomRange.push_back(slotMax - slotMin);
+    cyclesPerBeat.push_back(0.0);
+    syncCycle.push_back(0);
+    syncSeed.push_back(mixBits(static_cast<uint32_t>(phase.size()) * 0x9E3779B9u));
+    value.push_back(0.0f);
+
+    scratchPhase.push_back(0.0f);
+    scratchWraps.push_back(0.0f);
+
+    return getNumSlots() - 1;
+}
+
+int ModulationSourceBank::addPeriodic(Shape slotShape, float rateHz, float slotMin, float slotMax)
+{
+    const int slot = addSlot(slotShape == Shape::Envelope ? Shape::Sine : slotShape, 0.0f, slotMin, slotMax);
+    setRate(slot, rateHz);
+    resetSlot(slot);
+    return slot;
+}
+
+int ModulationSourceBank::addEnvelope(float attackSeconds, float decaySeconds)
+{
+    const int slot = addSlot(Shape::Envelope, 1.0f, 0.0f, 0.0f);
+    setEnvelopeTimes(slot, attackSeconds, decaySeconds);
+    resetSlot(slot);
+    return slot;
+}
+
+int ModulationSourceBank::adoptSlot(const ModulationSourceBank& other, int otherSlot)
+{
+    const auto from = static_cast<size_t>(otherSlot);
+    const int slot = addSlot(static_cast<Shape>(other.shape[from]), other.rate[from],
+                             other.randomMin[from], other.randomMin[from] + other.randomRange[from]);
+    const auto to = static_cast<size_t>(slot);
+
+    // The sync seed follows the slot index in this bank, so synced output
+    // depends only on the order slots are added
+    freeRate[to] = other.freeRate[from];
+    rateScale[to] = other.rateScale[from];
+    cyclesPerBeat[to] = other.cyclesPerBeat[from];
+    syncCycle[to] = other.syncCycle[from];
+    phase[to] = other.phase[from];
+    limit[to] = other.limit[from];
+    active[to] = other.active[from];
+    attack[to] = other.attack[from];
+    decay[to] = other.decay[from];
+    inverseAttack[to] = other.inverseAttack[from];
+    inverseDecay[to] = other.inverseDecay[from];
+    randomStart[to] = other.randomStart[from];
+    randomEnd[to] = other.randomEnd[from];
+    randomNext[to] = other.randomNext[from];
+    value[to] = other.value[from];
+
+    return slot;
+}
+
+void ModulationSourceBank::setShape(int slot, Shape newShape)
+{
+    const auto s = static_cast<size_t>(slot);
+    if (periodic[s] != 0.0f && newShape != Shape::Envelope)
+        shape[s] = static_cast<int32_t>(newShape);
+}
+
+void ModulationSourceBank::setRate(int slot, float rateHz)
+{
+    const auto s = static_cast<size_t>(slot);
+    if (periodic[s] == 0.0f)
+        return;
+
+    freeRate[s] = std::clamp(rateHz, 0.01f, 100.0f);
+    if (cyclesPerBeat[s] <= 0.0)
+        rate[s] = freeRate[s] * rateScale[s];
+}
+
+void ModulationSourceBank::setRateScale(int slot, float scale)
+{
+    const auto s = static_cast<size_t>(slot);
+    if (periodic[s] == 0.0f)
+        return;
+
+    rateScale[s] = std::max(0.0f, scale);
+    if (cyclesPerBeat[s] <= 0.0)
+        rate[s] = freeRate[s] * rateScale[s];
+}
+
+void ModulationSourceBank::setSync(int slot, double newCyclesPerBeat)
+{
+    const auto s = static_cast<size_t>(slot);
+    if (periodic[s] == 0.0f)
+        return;
+
+    cyclesPerBeat[s] = std::max(0.0, newCyclesPerBeat);
+    if (cyclesPerBeat[s] <= 0.0)
+        rate[s] = freeRate[s] * rateScale[s];
+}
+
+void ModulationSourceBank::syncToTransport(double beatPosition, double beatsPerSecond)
+{
+    const int numSlots = getNumSlots();
+    for (int i = 0; i < numSlots; ++i)
+    {
+        const auto s = static_cast<size_t>(i);
+        if (cyclesPerBeat[s] <= 0.0)
+            continue;
+
+        // Position in cycles is computed in double; only the fraction is stored
+        const double cycles = std::max(0.0, beatPosition) * cyclesPerBeat[s];
+        const double cycle = std::floor(cycles);
+
+        phase[s] = static_cast<float>(cycles - cycle);
+        rate[s] = static_cast<float>(cyclesPerBeat[s] * beatsPerSecond);
+
+        syncCycle[s] = static_cast<int64_t>(cycle);
+        randomStart[s] = syncedTarget(i, syncCycle[s]);
+        randomEnd[s] = syncedTarget(i, syncCycle[s] + 1);
+        randomNext[s] = syncedTarget(i, syncCycle[s] + 2);
+    }
+}
+
+void ModulationSourceBank::setEnvelopeTimes(int slot, float attackSeconds, float decaySeconds)
+{
+    const auto s = static_cast<size_t>(slot);
+    attack[s] = std::max(minimumStageTime, attackSeconds);
+    decay[s] = std::max(minimumStageTime, decaySeconds);
+    inverseAttack[s] = 1.0f / attack[s];
+    inverseDecay[s] = 1.0f / decay[s];
+
+    if (periodic[s] == 0.0f)
+    {
+        limit[s] = attack[s] + decay[s];
+        phase[s] = std::min(phase[s], limit[s]);
+    }
+}
+
+void ModulationSourceBank::setActive(int slot, bool shouldBeActive)
+{
+    active[static_cast<size_t>(slot)] = shouldBeActive ? 1.0f : 0.0f;
+}
+
+// ============================================================================
+// Envelopes and Reset
+// ============================================================================
+
+void ModulationSourceBank::trigger(int slot)
+{
+    const auto s = static_cast<size_t>(slot);
+    if (periodic[s] == 0.0f)
+        phase[s] = 0.0f;
+}
+
+void ModulationSourceBank::triggerEnvelopes()
+{
+    // Envelope phases restart at 0, periodic phases are kept
+    const int numSlots = getNumSlots();
+    for (int i = 0; i < numSlots; ++i)
+        phase[static_cast<size_t>(i)] *= periodic[static_cast<size_t>(i)];
+}
+
+void ModulationSourceBank::resetSlot(int slot)
+{
+    const auto s = static_cast<size_t>(slot);
+
+    // Envelopes rest at their end (idle, value 0)
+    phase[s] = periodic[s] != 0.0f ? 0.0f : limit[s];
+    randomStart[s] = randomEnd[s] = drawRandom(slot);
+    randomNext[s] = drawRandom(slot);
+
+    float slotValue = 0.0f;
+    render(0.0f, slot, slot + 1, &scratchPhase[s], &slotValue, &scratchWraps[s]);
+    value[s] = slotValue;
+}
+
+void ModulationSourceBank::reset()
+{
+    for (int i = 0; i < getNumSlots(); ++i)
+        resetSlot(i);
+}
+
+float ModulationSourceBank::drawRandom(int slot)
+{
+    // xorshift32
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+
+    const float unit = static_cast<float>(rngState >> 8) * (1.0f / 16777216.0f);
+    const auto s = static_cast<size_t>(slot);
+    return randomMin[s] + unit * randomRange[s];
+}
+
+float ModulationSourceBank::syncedTarget(int slot, int64_t cycle) const
+{
+    const auto s = static_cast<size_t>(slot);
+    const auto c = static_cast<uint64_t>(cycle);
+    const uint32_t h = mixBits(syncSeed[s] ^ mixBits(static_cast<uint32_t>(c) ^ mixBits(static_cast<uint32_t>(c >> 32))));
+
+    const float unit = static_cast<float>(h >> 8) * (1.0f / 16777216.0f);
+    return randomMin[s] + unit * randomRange[s];
+}
+
+// ============================================================================
+// Kernel
+// ============================================================================
+
+void ModulationSourceBank::render(float secondsAhead, int begin, int end,
+                                  float* __restrict phaseOut, float* __restrict valueOut, float* __restrict wrapsOut) const
+{
+    const float* phaseIn = phase.data();
+    const float* rateIn = rate.data();
+    const float* limitIn = limit.data();
+    const float* periodicIn = periodic.data();
+    const int32_t* shapeIn = shape.data();
+    const float* activeIn = active.data();
+    const float* attackIn = attack.data();
+    const float* inverseAttackIn = inverseAttack.data();
+    const float* inverseDecayIn = inverseDecay.data();
+    const float* startIn = randomStart.data();
+    const float* endIn = randomEnd.data();
+    const float* nextIn = randomNext.data();
+
+    const int count = end - begin;
+    for (int n = 0; n < count; ++n)
+    {
+        const int i = begin + n;
+
+        // Phases are non-negative, so truncation is floor. Kept in float
+        // arithmetic throughout, which vectorises on every SSE/NEON level.
+        const float advanced = phaseIn[i] + rateIn[i] * activeIn[i] * secondsAhead;
+        const float wraps = static_cast<float>(static_cast<int32_t>(advanced)) * periodicIn[i];
+        const float p = std::min(advanced - wraps, limitIn[i]);
+
+        // Random targets: this cycle's, or the next one's after a wrap
+        const float crossed = std::min(wraps, 1.0f);
+        const float from = startIn[i] + crossed * (endIn[i] - startIn[i]);
+        const float to = endIn[i] + crossed * (nextIn[i] - endIn[i]);
+
+        // Sine as a shaped triangle that peaks at p = 0.25
+        float q = p + 0.75f;
+        q -= static_cast<float>(static_cast<int32_t>(q));
+        const float sine = quarterSine(4.0f * std::abs(q - 0.5f) - 1.0f);
+
+        const float triangle = 1.0f - 4.0f * std::abs(p - 0.5f);
+        const float saw = 2.0f * p - 1.0f;
+        const float square = 2.0f * static_cast<float>(static_cast<int32_t>(2.0f * p)) - 1.0f;
+        const float smooth = from + (to - from) * p;
+        const float envelope = std::max(0.0f, std::min(p * inverseAttackIn[i],
+                                                       1.0f - (p - attackIn[i]) * inverseDecayIn[i]));
+
+        // Branch-free select: exactly one weight is 1
+        const int32_t s = shapeIn[i];
+        auto weight = [s](Shape candidate) { return static_cast<float>(s == static_cast<int32_t>(candidate)); };
+
+        const float out = weight(Shape::Sine) * sine
+                        + weight(Shape::Triangle) * triangle
+                        + weight(Shape::Saw) * saw
+                        + weight(Shape::Square) * square
+                        + weight(Shape::SmoothRandom) * smooth
+                        + weight(Shape::SampleAndHold) * to
+                        + weight(Shape::Envelope) * envelope;
+
+        phaseOut[n] = p;
+        valueOut[n] = out;
+        wrapsOut[n] = wraps;
+    }
+}
+
+// ============================================================================
+// Advance / Evaluate
+// ============================================================================
+
+void ModulationSourceBank::advance(double timeSeconds)
+{
+    advance(timeSeconds, 0, getNumSlots());
+}
+
+void ModulationSourceBank::advance(double timeSeconds, int begin, int end)
+{
+    render(static_cast<float>(timeSeconds), begin, end,
+           scratchPhase.data() + begin, value.data() + begin, scratchWraps.data() + begin);
+
+    std::copy(scratchPhase.begin() + begin, scratchPhase.begin() + end, phase.begin() + begin);
+
+    // Move random targets on for slots that wrapped (value already uses the new ones)
+    for (int i = begin; i < end; ++i)
+    {
+        const auto s = static_cast<size_t>(i);
+        if (scratchWraps[s] > 0.0f)
+        {
+            randomStart[s] = randomEnd[s];
+            randomEnd[s] = randomNext[s];
+
+            if (cyclesPerBeat[s] > 0.0)
+                randomNext[s] = syncedTarget(i, ++syncCycle[s] + 2);
+            else
+                randomNext[s] = drawRandom(i);
+        }
+    }
+}
+
+void ModulationSourceBank::evaluate(double secondsAhead, float* out) const
+{
+    evaluate(secondsAhead, out, 0, getNumSlots());
+}
+
+void ModulationSourceBank::evaluate(double secondsAhead, float* out, int begin, int end) const
+{
+    // Phase and wrap results are discarded; a fixed-size chunk keeps this allocation-free
+    constexpr int chunkSize = 64;
+    float chunkPhase[chunkSize];
+    float chunkWraps[chunkSize];
+
+    for (int start = begin; start < end; start += chunkSize)
+    {
+        const int stop = std::min(end, start + chunkSize);
+        render(static_cast<float>(secondsAhead), start, stop, chunkPhase, out + (start - begin), chunkWraps);
+    }
+}
+
+float ModulationSourceBank::getValueAt(int slot, double secondsAhead) const
+{
+    float slotValue = 0.0f;
+    evaluate(secondsAhead, &slotValue, slot, slot + 1);
+    return slotValue;
+}
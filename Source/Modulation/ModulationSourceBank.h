@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+    ModulationSourceBank.h
+
+    Structure-of-arrays storage for LFO, random and envelope sources
+    Every slot is advanced and evaluated in one batched pass
+
+    Each slot is a phase that moves at a per-slot rate: LFO and random
+    slots wrap it every cycle, envelope slots run it as seconds since the
+    trigger. All waveforms are computed for every slot and the slot's shape
+    selects one, so the kernels have no per-slot branches and are
+    vectorised by the compiler. Random targets are redrawn in a short
+    scalar pass over the slots that wrapped.
+
+    Periodic slots can be synced to the transport: syncToTransport() sets
+    their phase from the musical position, and their random targets are
+    hashed from the cycle number, so synced output depends only on where
+    the transport is.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class ModulationSourceBank
+{
+public:
+    enum class Shape : int32_t
+    {
+        Sine,
+        Triangle,
+        Saw,
+        Square,
+        SmoothRandom,     // Ramps between random targets once per cycle
+        SampleAndHold,    // Holds a new random target each cycle
+        Envelope          // Attack/decay, 0-1, restarted by trigger()
+    };
+
+    ModulationSourceBank();
+
+    // Slot creation; returns the slot index. Random targets are drawn in
+    // [randomMin, randomMax].
+    int addPeriodic(Shape shape, float rateHz, float randomMin = -1.0f, float randomMax = 1.0f);
+    int addEnvelope(float attackSeconds, float decaySeconds);
+
+    // Copy a slot (settings and state) from another bank; returns the new slot index
+    int adoptSlot(const ModulationSourceBank& other, int otherSlot);
+
+    int getNumSlots() const { return static_cast<int>(phase.size()); }
+
+    // Slot settings. Periodic slots can switch between the periodic shapes;
+    // a slot's kind (periodic or envelope) is fixed when it is added.
+    void setShape(int slot, Shape shape);
+    Shape getShape(int slot) const { return static_cast<Shape>(shape[static_cast<size_t>(slot)]); }
+
+    // Free-running rate, used while the slot is not synced
+    void setRate(int slot, float rateHz);
+    float getRate(int slot) const { return freeRate[static_cast<size_t>(slot)]; }
+
+    // Multiplier on the free-running rate (rate modulation); synced slots ignore it
+    void setRateScale(int slot, float scale);
+    float getRateScale(int slot) const { return rateScale[static_cast<size_t>(slot)]; }
+
+    // Tempo sync: cycles per quarter note, or 0 to run at the free rate
+    void setSync(int slot, double cyclesPerBeat);
+    double getSync(int slot) const { return cyclesPerBeat[static_cast<size_t>(slot)]; }
+
+    void setEnvelopeTimes(int slot, float attackSeconds, float decaySeconds);
+    float getAttackTime(int slot) const { return attack[static_cast<size_t>(slot)]; }
+    float getDecayTime(int slot) const { return decay[static_cast<size_t>(slot)]; }
+
+    // Inactive slots hold their phase when advanced
+    void setActive(int slot, bool shouldBeActive);
+
+    // Phase of a slot: cycle position in [0, 1), or seconds since an envelope trigger
+    float getPhase(int slot) const { return phase[static_cast<size_t>(slot)]; }
+
+    // Phase-lock synced slots to a transport position (in quarter notes) and
+    // set their rate from the tempo. Call before evaluating or advancing a block.
+    void syncToTransport(double beatPosition, double beatsPerSecond);
+
+    // Envelopes
+    void trigger(int slot);
+    void triggerEnvelopes();
+
+    void resetSlot(int slot);
+    void reset();
+
+    // Advance slots [begin, end) (all slots by default) and update their values
+    void advance(double timeSeconds);
+    void advance(double timeSeconds, int begin, int end);
+
+    // Value of slots [begin, end) secondsAhead of their current state, in closed
+    // form; out[i - begin] receives slot i. State is not changed.
+    void evaluate(double secondsAhead, float* out) const;
+    void evaluate(double secondsAhead, float* out, int begin, int end) const;
+
+    float getValue(int slot) const { return value[static_cast<size_t>(slot)]; }
+    float getValueAt(int slot, double secondsAhead) const;
+
+private:
+    int addSlot(Shape slotShape, float slotRate, float slotMin, float slotMax);
+
+    // Batched kernel: phases and values secondsAhead on, and the number of
+    // wraps per slot (0 for envelopes)
+    void render(float secondsAhead, int begin, int end, float* __restrict phaseOut, float* __restrict valueOut, float* __restrict wrapsOut) const;
+
+    float drawRandom(int slot);
+    float syncedTarget(int slot, int64_t cycle) const;
+
+    // Per-slot state and settings (structure of arrays)
+    std::vector<float> phase;
+    std::vector<float> rate;          // Cycles per second; 1 for envelopes (phase in seconds)
+    std::vector<float> freeRate;      // Rate set by setRate()
+    std::vector<float> rateScale;     // Set by setRateScale(), 1 by default
+    std::vector<float> limit;         // Phase ceiling: 1 for periodic slots, attack + decay for envelopes
+    std::vector<float> periodic;      // 1 if the phase wraps every cycle, else 0
+    std::vector<int32_t> shape;
+    std::vector<float> active;        // 0 or 1, scales the phase increment
+
+    std::vector<float> attack;        // Envelope stage times and reciprocals
+    std::vector<float> decay;
+    std::vector<float> inverseAttack;
+    std::vector<float> inverseDecay;
+
+    std::vector<float> randomStart;   // Random target this cycle starts from
+    std::vector<float> randomEnd;     // ... and ends at (the held value)
+    std::vector<float> randomNext;    // Next cycle's target, drawn one cycle ahead
+    std::vector<float> randomMin;
+    std::vector<float> randomRange;
+
+    std::vector<double> cyclesPerBeat;   // 0 for free-running slots
+    std::vector<int64_t> syncCycle;      // Transport cycle a synced slot is in
+    std::vector<uint32_t> syncSeed;      // Per-slot hash seed for synced random targets
+
+    std::vector<float> value;
+
+    // Scratch for advance()
+    std::vector<float> scratchPhase;
+    std::vector<float> scratchWraps;
+
+    uint32_t rngState;
+};
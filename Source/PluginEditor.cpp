@@ -32,6 +32,15 @@ GenerativeMIDIEditor::GenerativeMIDIEditor(GenerativeMIDIProcessor& p)
     // Pattern display (polyrhythm layer editor commented out for now)
     addAndMakeVisible(patternDisplay);
 
+    // Right-click a step for its probability, conditional trig and locks
+    patternDisplay.onStepRightClicked = [this](int step) {
+        auto& euclidean = audioProcessor.getEuclideanEngine();
+        StepConditionMenu::show(euclidean.getConditionLane(), euclidean.getMicrotimingLane(), step,
+            [&euclidean](const StepConditionMenu::LaneEdit& edit) {
+                euclidean.editStepLanes([&edit](EuclideanStepLanes& lanes) { edit(lanes.conditions, lanes.microtiming); });
+            });
+    };
+
     // TODO: Polyrhythm layer editor - implement in future version
     // polyLayerEditor = std::make_unique<PolyrhythmLayerEditor>(audioProcessor.getPolyrhythmEngine());
     // patternAreaTabs = std::make_unique<PatternAreaTabs>(patternDisplay, *polyLayerEditor);
@@ -44,7 +53,8 @@ GenerativeMIDIEditor::GenerativeMIDIEditor(GenerativeMIDIProcessor& p)
 
     addAndMakeVisible(generatorTypeCombo);
     generatorTypeCombo.addItemList(juce::StringArray{"Euclidean", "Polyrhythm", "Markov", "L-System", "Cellular", "Probabilistic",
-                                                      "Brownian", "Perlin Noise", "Drunk Walk", "Lorenz"}, 1);
+                                                      "Brownian", "Perlin Noise", "Drunk Walk", "Lorenz", "Life",
+                                                      "Rossler", "Thomas", "Henon", "Chua"}, 1);
     generatorAttachment.reset(new juce::AudioProcessorValueTreeState::ComboBoxAttachment(
         audioProcessor.getValueTreeState(), "generatorType", generatorTypeCombo));
 
@@ -297,6 +307,35 @@ GenerativeMIDIEditor::GenerativeMIDIEditor(GenerativeMIDIProcessor& p)
         options.launchAsync();
     };
 
+    // Markov model training / loading
+    addAndMakeVisible(markovModelButton);
+    markovModelButton.setButtonText("Markov Model");
+    markovModelButton.onClick = [this]() { showMarkovModelMenu(); };
+
+    // Pattern chain editor
+    addAndMakeVisible(patternChainButton);
+    patternChainButton.setButtonText("Chain");
+    patternChainButton.onClick = [this]()
+    {
+        if (!patternChainEditor)
+        {
+            patternChainEditor = std::make_unique<PatternChainEditor>(audioProcessor.getPatternChain(),
+                                                                      audioProcessor.getValueTreeState());
+            patternChainEditor->setSize(780, 360);
+        }
+
+        juce::DialogWindow::LaunchOptions options;
+        options.content.setNonOwned(patternChainEditor.get());
+        options.dialogTitle = "Pattern Chain";
+        options.componentToCentreAround = this;
+        options.dialogBackgroundColour = juce::Colour(0xff0f0f0f);
+        options.escapeKeyTriggersCloseButton = true;
+        options.useNativeTitleBar = true;
+        options.resizable = true;
+
+        options.launchAsync();
+    };
+
     // Current preset label
     addAndMakeVisible(currentPresetLabel);
     currentPresetLabel.setText("No Preset", juce::dontSendNotification);
@@ -467,6 +506,94 @@ void GenerativeMIDIEditor::paint(juce::Graphics& g)
     drawBrassPanel(juce::Rectangle<float>(25, 610, getWidth() - 50, 120), "ADVANCED");
 }
 
+void GenerativeMIDIEditor::showMarkovModelMenu()
+{
+    juce::PopupMenu menu;
+    menu.addItem(1, "Train From MIDI Folder...", !audioProcessor.isTrainingMarkovModel());
+    menu.addItem(2, "Load Model...");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&markovModelButton),
+        [safeThis = juce::Component::SafePointer<GenerativeMIDIEditor>(this)](int result)
+        {
+            if (safeThis == nullptr)
+                return;
+
+            if (result == 1)
+                safeThis->trainMarkovModel();
+            else if (result == 2)
+                safeThis->loadMarkovModel();
+        });
+}
+
+void GenerativeMIDIEditor::trainMarkovModel()
+{
+    auto folderChooser = std::make_shared<juce::FileChooser>("Choose a folder of MIDI files");
+    folderChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories,
+        [safeThis = juce::Component::SafePointer<GenerativeMIDIEditor>(this), folderChooser](const juce::FileChooser& fc)
+        {
+            auto midiFolder = fc.getResult();
+            if (safeThis == nullptr || !midiFolder.isDirectory())
+                return;
+
+            auto modelChooser = std::make_shared<juce::FileChooser>("Save Markov Model",
+                midiFolder.getSiblingFile(midiFolder.getFileName()).withFileExtension(MarkovModelFile::fileExtension),
+                juce::String("*") + MarkovModelFile::fileExtension);
+
+            modelChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles,
+                [safeThis, modelChooser, midiFolder](const juce::FileChooser& saveFc)
+                {
+                    if (safeThis == nullptr || saveFc.getResult() == juce::File())
+                        return;
+
+                    auto modelFile = saveFc.getResult().withFileExtension(MarkovModelFile::fileExtension);
+
+                    safeThis->markovModelButton.setButtonText("Training...");
+                    safeThis->markovModelButton.setEnabled(false);
+
+                    const bool started = safeThis->audioProcessor.trainMarkovModel(midiFolder, modelFile,
+                        [safeThis](const MarkovCorpusTrainer::Report& report)
+                        {
+                            if (safeThis == nullptr)
+                                return;
+
+                            safeThis->markovModelButton.setButtonText("Markov Model");
+                            safeThis->markovModelButton.setEnabled(true);
+
+                            if (report.written)
+                                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon, "Markov Model",
+                                    "Trained on " + juce::String(report.filesParsed) + " files ("
+                                    + juce::String(report.numStates) + " states) and loaded.");
+                            else
+                                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Markov Model",
+                                    "Training failed or was cancelled.");
+                        });
+
+                    // Another run is still in progress (started from another editor)
+                    if (!started)
+                    {
+                        safeThis->markovModelButton.setButtonText("Markov Model");
+                        safeThis->markovModelButton.setEnabled(true);
+                        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon, "Markov Model",
+                            "A model is already being trained.");
+                    }
+                });
+        });
+}
+
+void GenerativeMIDIEditor::loadMarkovModel()
+{
+    auto chooser = std::make_shared<juce::FileChooser>("Load Markov Model", juce::File(),
+                                                       juce::String("*") + MarkovModelFile::fileExtension);
+    chooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [safeThis = juce::Component::SafePointer<GenerativeMIDIEditor>(this), chooser](const juce::FileChooser& fc)
+        {
+            auto file = fc.getResult();
+            if (safeThis != nullptr && file.existsAsFile() && !safeThis->audioProcessor.loadMarkovModelFile(file))
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Markov Model",
+                    "Not a valid model file for this machine.");
+        });
+}
+
 void GenerativeMIDIEditor::resized()
 {
     auto area = getLocalBounds();
@@ -475,6 +602,8 @@ void GenerativeMIDIEditor::resized()
     auto titleArea = area.removeFromTop(60).reduced(20, 10);
     auto presetArea = titleArea.removeFromRight(180);
     presetBrowserButton.setBounds(presetArea.removeFromTop(30).reduced(5));
+    markovModelButton.setBounds(titleArea.removeFromRight(130).removeFromTop(30).reduced(5));
+    patternChainButton.setBounds(titleArea.removeFromRight(80).removeFromTop(30).reduced(5));
     currentPresetLabel.setBounds(presetArea.reduced(5, 0));
     titleLabel.setBounds(titleArea);
 
@@ -646,6 +775,9 @@ void GenerativeMIDIEditor::timerCallback()
     int currentStep = audioProcessor.getCurrentStep() % euclidean.getSteps();
     patternDisplay.setCurrentStep(currentStep);
 
+    // Reclaim step lane snapshots the audio thread has moved past
+    euclidean.collectGarbage();
+
     // Update current preset label
     const juce::String& presetName = audioProcessor.getPresetManager().getCurrentPresetName();
     if (presetName.isNotEmpty())
@@ -661,11 +793,13 @@ void GenerativeMIDIEditor::updateControlsForGeneratorType(int generatorType)
     // 1 = Polyrhythm
     // 2-5 = Algorithmic (Markov, L-System, Cellular, Probabilistic)
     // 6-9 = Stochastic (Brownian, Perlin, Drunk Walk, Lorenz)
+    // 10 = Algorithmic (Life)
+    // 11-14 = Stochastic (Rossler, Thomas, Henon, Chua)
 
     bool isEuclidean = (generatorType == 0);
     bool isPolyrhythm = (generatorType == 1);
-    bool isAlgorithmic = (generatorType >= 2 && generatorType <= 5);
-    bool isStochastic = (generatorType >= 6 && generatorType <= 9);
+    bool isAlgorithmic = (generatorType >= 2 && generatorType <= 5) || generatorType == 10;
+    bool isStochastic = (generatorType >= 6 && generatorType <= 9) || (generatorType >= 11 && generatorType <= 14);
 
     // Euclidean-specific controls (steps, pulses, rotation)
     if (stepsSlider) stepsSlider->setEnabled(isEuclidean);
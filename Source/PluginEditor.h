@@ -13,8 +13,10 @@
 #include "PluginProcessor.h"
 #include "UI/CustomLookAndFeel.h"
 #include "UI/PatternVisualizer.h"
+#include "UI/StepConditionMenu.h"
 #include "UI/PresetBrowser.h"
 #include "UI/PolyrhythmLayerEditor.h"
+#include "UI/PatternChainEditor.h"
 #include "UI/PatternAreaTabs.h"
 #include "UI/ModulationPanel.h"
 #include "UI/ModulationTarget.h"
@@ -78,6 +80,16 @@ private:
     juce::ComboBox generatorTypeCombo;
     juce::ComboBox midiChannelCombo;
 
+    // Markov model file: train from a MIDI folder or load a trained model
+    juce::TextButton markovModelButton;
+    void showMarkovModelMenu();
+    void trainMarkovModel();
+    void loadMarkovModel();
+
+    // Pattern chain (song mode) editor
+    juce::TextButton patternChainButton;
+    std::unique_ptr<PatternChainEditor> patternChainEditor;
+
     // Preset controls
     juce::TextButton presetBrowserButton;
     juce::Label currentPresetLabel;
@@ -32,22 +32,33 @@ GenerativeMIDIProcessor::GenerativeMIDIProcessor()
         onSubdivisionHit(subdivision);
     };
 
-    // Initialize modulation sources
-    // LFO 1 - slow sine
-    modulationMatrix.addSource(std::make_unique<LFOModulationSource>(
-        "LFO 1", LFOModulationSource::Waveform::Sine, 0.5, true));
-
-    // LFO 2 - fast triangle
-    modulationMatrix.addSource(std::make_unique<LFOModulationSource>(
-        "LFO 2", LFOModulationSource::Waveform::Triangle, 2.0, true));
-
-    // Random 1 - slow random
-    modulationMatrix.addSource(std::make_unique<RandomModulationSource>(
-        "Random 1", 1.0, false));
-
-    // Random 2 - fast random
-    modulationMatrix.addSource(std::make_unique<RandomModulationSource>(
-        "Random 2", 0.25, false));
+    parameters.addParameterListener(PARAM_MARKOV_LEARN, this);
+
+    // Initialize modulation sources. LFOs and randoms are tempo-synced (their
+    // free rates match the divisions at 120 BPM), so renders repeat exactly.
+    // LFO 1 - slow sine, one bar
+    auto lfo1 = std::make_unique<LFOModulationSource>(
+        "LFO 1", LFOModulationSource::Waveform::Sine, 0.5, true);
+    lfo1->setSyncDivision(ModulationSyncDivision::OneBar);
+    modulationMatrix.addSource(std::move(lfo1));
+
+    // LFO 2 - fast triangle, quarter note
+    auto lfo2 = std::make_unique<LFOModulationSource>(
+        "LFO 2", LFOModulationSource::Waveform::Triangle, 2.0, true);
+    lfo2->setSyncDivision(ModulationSyncDivision::Quarter);
+    modulationMatrix.addSource(std::move(lfo2));
+
+    // Random 1 - slow random, half note
+    auto random1 = std::make_unique<RandomModulationSource>(
+        "Random 1", 1.0, false);
+    random1->setSyncDivision(ModulationSyncDivision::Half);
+    modulationMatrix.addSource(std::move(random1));
+
+    // Random 2 - fast random, eighth note
+    auto random2 = std::make_unique<RandomModulationSource>(
+        "Random 2", 0.25, false);
+    random2->setSyncDivision(ModulationSyncDivision::Eighth);
+    modulationMatrix.addSource(std::move(random2));
 
     // Envelope 1 - fast attack
     modulationMatrix.addSource(std::make_unique<EnvelopeModulationSource>(
@@ -56,10 +67,42 @@ GenerativeMIDIProcessor::GenerativeMIDIProcessor()
     // Envelope 2 - slow attack
     modulationMatrix.addSource(std::make_unique<EnvelopeModulationSource>(
         "Envelope 2", 0.5, 2.0, false));
+
+    // Noise 1 - smooth fractal noise
+    modulationMatrix.addSource(std::make_unique<NoiseModulationSource>(
+        "Noise 1", 0.5, 3, true));
+
+    // Modulation destinations use the parameter indices, so realtime code can
+    // address modulated parameters by index instead of by ID
+    for (auto* param : getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
+        {
+            modulationMatrix.registerDestination(ranged->paramID);
+            rangedParameters.push_back(ranged);
+            rawParameterValues.push_back(parameters.getRawParameterValue(ranged->paramID));
+        }
+    }
+
+    modulatedParams.tempo = modulationMatrix.getDestinationIndex(PARAM_TEMPO);
+    modulatedParams.euclideanSteps = modulationMatrix.getDestinationIndex(PARAM_EUCLIDEAN_STEPS);
+    modulatedParams.euclideanPulses = modulationMatrix.getDestinationIndex(PARAM_EUCLIDEAN_PULSES);
+    modulatedParams.euclideanRotation = modulationMatrix.getDestinationIndex(PARAM_EUCLIDEAN_ROTATION);
+    modulatedParams.noteDensity = modulationMatrix.getDestinationIndex(PARAM_NOTE_DENSITY);
+    modulatedParams.velocityMin = modulationMatrix.getDestinationIndex(PARAM_VELOCITY_MIN);
+    modulatedParams.velocityMax = modulationMatrix.getDestinationIndex(PARAM_VELOCITY_MAX);
+    modulatedParams.pitchMin = modulationMatrix.getDestinationIndex(PARAM_PITCH_MIN);
+    modulatedParams.pitchMax = modulationMatrix.getDestinationIndex(PARAM_PITCH_MAX);
+    modulatedParams.swingAmount = modulationMatrix.getDestinationIndex(PARAM_SWING_AMOUNT);
+    modulatedParams.gateLength = modulationMatrix.getDestinationIndex(PARAM_GATE_LENGTH);
 }
 
 GenerativeMIDIProcessor::~GenerativeMIDIProcessor()
 {
+    parameters.removeParameterListener(PARAM_MARKOV_LEARN, this);
+    cancelMarkovTraining.store(true);
+    markovTrainingPool.removeAllJobs(true, 10000);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -88,12 +131,22 @@ juce::AudioProcessorValueTreeState::ParameterLayout GenerativeMIDIProcessor::cre
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         PARAM_GENERATOR_TYPE, "Generator Type",
         juce::StringArray{"Euclidean", "Polyrhythm", "Markov", "L-System", "Cellular", "Probabilistic",
-                         "Brownian", "Perlin Noise", "Drunk Walk", "Lorenz"},
+                         "Brownian", "Perlin Noise", "Drunk Walk", "Lorenz", "Life",
+                         "Rossler", "Thomas", "Henon", "Chua"},
         0));
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         PARAM_NOTE_DENSITY, "Note Density", 0.0f, 1.0f, 0.5f));
 
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        PARAM_FILL_MODE, "Fill Mode", false)); // Activates FILL conditional trigs
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        PARAM_CHAIN_MODE, "Chain Mode", false)); // Plays the pattern chain (song mode)
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        PARAM_MARKOV_LEARN, "Learn From Input", false)); // Trains the Markov generator from MIDI input
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         PARAM_VELOCITY_MIN, "Velocity Min", 0.0f, 1.0f, 0.5f));
 
@@ -160,6 +213,12 @@ juce::AudioProcessorValueTreeState::ParameterLayout GenerativeMIDIProcessor::cre
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         PARAM_TIME_SCALE, "Time Scale", 0.01f, 10.0f, 1.0f));
 
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        PARAM_ENSEMBLE_VOICES, "Ensemble Voices", 1, StochasticEnsemble::maxWalkers, 1)); // 1 = single walker
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        PARAM_ENSEMBLE_SPREAD_CHANNELS, "Ensemble Spread Channels", false)); // One MIDI channel per voice
+
     // MIDI Routing
     params.push_back(std::make_unique<juce::AudioParameterInt>(
         PARAM_MIDI_CHANNEL, "MIDI Channel", 1, 16, 1));
@@ -262,6 +321,7 @@ void GenerativeMIDIProcessor::prepareToPlay(double sampleRate, int samplesPerBlo
     auto timeSigNum = parameters.getRawParameterValue(PARAM_TIME_SIG_NUM)->load();
     auto timeSigDenom = parameters.getRawParameterValue(PARAM_TIME_SIG_DENOM)->load();
     clockManager.setTimeSignature(static_cast<int>(timeSigNum), static_cast<int>(timeSigDenom));
+    patternChain.setTimeSignature(static_cast<int>(timeSigNum), static_cast<int>(timeSigDenom));
 
     // Initialize engines
     auto steps = parameters.getRawParameterValue(PARAM_EUCLIDEAN_STEPS)->load();
@@ -281,25 +341,59 @@ void GenerativeMIDIProcessor::prepareToPlay(double sampleRate, int samplesPerBlo
     if (polyrhythmEngine.getNumLayers() == 0)
     {
         int layerIdx = polyrhythmEngine.addLayer();
-        auto* layer = polyrhythmEngine.getLayer(layerIdx);
-        if (layer)
-        {
+        polyrhythmEngine.editLayer(layerIdx, [](PolyrhythmLayer& layer) {
             // Create a simple pattern
-            for (int i = 0; i < layer->length; ++i)
+            for (int i = 0; i < layer.length; ++i)
             {
-                layer->pattern[i] = (i % 4 == 0); // Every 4 steps
-                layer->velocities[i] = 0.8f;
-                layer->pitches[i] = 60 + (i % 12); // C major scale-ish
+                layer.pattern[i] = (i % 4 == 0); // Every 4 steps
+                layer.velocities[i] = 0.8f;
+                layer.pitches[i] = 60 + (i % 12); // C major scale-ish
             }
-        }
+        });
     }
 
+    isPrepared = true;
+    updateMarkovLearnerThread();
     clockManager.start();
 }
 
 void GenerativeMIDIProcessor::releaseResources()
 {
     clockManager.stop();
+    isPrepared = false;
+    updateMarkovLearnerThread();
+}
+
+void GenerativeMIDIProcessor::parameterChanged(const juce::String& parameterID, float)
+{
+    // May be called from the audio thread; the learner thread is started or
+    // stopped on the message thread
+    if (parameterID == PARAM_MARKOV_LEARN)
+        triggerAsyncUpdate();
+}
+
+void GenerativeMIDIProcessor::handleAsyncUpdate()
+{
+    updateMarkovLearnerThread();
+
+    if (markovTrainingFinished.exchange(false))
+    {
+        if (markovTrainingReport.written)
+            markovTrainingReport.written = mapMarkovModelFile(markovTrainingOutput);
+
+        if (auto onFinished = std::move(onMarkovTrainingFinished))
+            onFinished(markovTrainingReport);
+    }
+}
+
+void GenerativeMIDIProcessor::updateMarkovLearnerThread()
+{
+    const bool learnFromInput = parameters.getRawParameterValue(PARAM_MARKOV_LEARN)->load() > 0.5f;
+
+    if (isPrepared && learnFromInput)
+        markovLearner.start();
+    else
+        markovLearner.stop();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -333,36 +427,62 @@ void GenerativeMIDIProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Update engines from parameters (live parameter updates)
-    auto steps = static_cast<int>(parameters.getRawParameterValue(PARAM_EUCLIDEAN_STEPS)->load());
-    auto pulses = static_cast<int>(parameters.getRawParameterValue(PARAM_EUCLIDEAN_PULSES)->load());
-    auto rotation = static_cast<int>(parameters.getRawParameterValue(PARAM_EUCLIDEAN_ROTATION)->load());
+    // Update engines from parameters (live parameter updates); block-rate parameters
+    // use the modulation resolved at the end of the previous block, i.e. this block's start
+    auto steps = static_cast<int>(getModulatedParameterValue(modulatedParams.euclideanSteps));
+    auto pulses = static_cast<int>(getModulatedParameterValue(modulatedParams.euclideanPulses));
+    auto rotation = static_cast<int>(getModulatedParameterValue(modulatedParams.euclideanRotation));
 
     // Ensure pulses never exceeds steps
     pulses = juce::jmin(pulses, steps);
 
-    if (euclideanEngine.getSteps() != steps)
-        euclideanEngine.setSteps(steps);
-    if (euclideanEngine.getPulses() != pulses)
-        euclideanEngine.setPulses(pulses);
-    euclideanEngine.setRotation(rotation);
+    // While a chain entry is playing, the Euclidean pattern comes from the chain
+    if (patternChain.getActiveState() == nullptr)
+    {
+        if (euclideanEngine.getSteps() != steps)
+            euclideanEngine.setSteps(steps);
+        if (euclideanEngine.getPulses() != pulses)
+            euclideanEngine.setPulses(pulses);
+        if (euclideanEngine.getRotation() != rotation % steps)
+            euclideanEngine.setRotation(rotation);
+    }
 
-    auto tempo = parameters.getRawParameterValue(PARAM_TEMPO)->load();
+    auto tempo = getModulatedParameterValue(modulatedParams.tempo);
     clockManager.setTempo(tempo);
 
-    // Process MIDI clock messages for external sync
+    syncToHostTransport();
+
+    auto learnFromInput = parameters.getRawParameterValue(PARAM_MARKOV_LEARN)->load() > 0.5f;
+    const double samplesPerStep = clockManager.getSamplesPerSubdivision(16);
+
+    // Process MIDI clock messages for external sync, and feed input notes to the learner
+    // (timed on the free-running sample counter, so intervals are learned while stopped too)
     for (const auto metadata : midiMessages)
     {
         const auto message = metadata.getMessage();
         clockManager.processExternalMidiClock(message);
+
+        if (learnFromInput && message.isNoteOn())
+            markovLearner.pushNote(message.getNoteNumber(), message.getFloatVelocity(),
+                                   static_cast<double>(currentSamplePosition + metadata.samplePosition) / samplesPerStep);
     }
 
+    // Learned models are published whether or not the Markov generator plays them
+    algorithmicEngine.acknowledgeModels();
+
+    // Tempo-synced modulation takes its phase from the clock's beat position at the
+    // block start (the host position while the host is playing), so it re-aligns
+    // whenever that position jumps
+    const double beatsPerSecond = clockManager.isPlaying() ? clockManager.getTempo() / 60.0 : 0.0;
+    modulationMatrix.syncToTransport(clockManager.getPositionInBeats(), beatsPerSecond);
+
     // Advance clock
     clockManager.advance(buffer.getNumSamples());
 
     // Advance modulation sources
     double timeStep = static_cast<double>(buffer.getNumSamples()) / getSampleRate();
     modulationMatrix.advance(timeStep);
+    modulationMatrix.resolveModulation();
 
     // Generate MIDI events
     processGenerativeOutput(midiMessages, buffer.getNumSamples());
@@ -373,6 +493,59 @@ void GenerativeMIDIProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
     currentSamplePosition += buffer.getNumSamples();
 }
 
+void GenerativeMIDIProcessor::syncToHostTransport()
+{
+    if (clockManager.isExternalSync())
+        return;
+
+    auto* playHead = getPlayHead();
+    if (playHead == nullptr)
+        return;
+
+    const auto position = playHead->getPosition();
+    if (!position)
+        return;
+
+    // Until the host first plays (or without a host transport) the clock free-runs from prepareToPlay
+    const bool hostPlaying = position->getIsPlaying();
+    if (hostPlaying && !hostWasPlaying)
+    {
+        restartSequence();
+        clockManager.start();
+    }
+    else if (!hostPlaying && hostWasPlaying)
+    {
+        clockManager.stop();
+    }
+    hostWasPlaying = hostPlaying;
+
+    if (!hostPlaying)
+        return;
+
+    if (const auto bpm = position->getBpm())
+        clockManager.setTempo(*bpm);
+
+    // Follow seeks and loops; steady playback stays on the accumulated position.
+    // The chain restarts on the next bar line after a jump rather than carrying its
+    // cursor across it
+    if (const auto ppq = position->getPpqPosition())
+        if (std::abs(*ppq - clockManager.getPositionInBeats()) * clockManager.getSamplesPerBeat() > 1.0)
+        {
+            clockManager.setPositionInBeats(*ppq);
+            patternChain.resetPlayback();
+        }
+}
+
+void GenerativeMIDIProcessor::restartSequence()
+{
+    clockManager.reset();
+    lastSubdivisionStep = 0;
+    euclideanEngine.resetConditionState();
+    polyrhythmEngine.reset();
+    algorithmicEngine.resetCursors();
+    patternChain.resetPlayback();
+}
+
 void GenerativeMIDIProcessor::processGenerativeOutput(juce::MidiBuffer& midiMessages, int numSamples)
 {
     // This method is called to generate MIDI events based on current settings
@@ -381,6 +554,12 @@ void GenerativeMIDIProcessor::processGenerativeOutput(juce::MidiBuffer& midiMess
 
 void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
 {
+    // Sources sit at the block start until the block is finished; evaluate them in
+    // closed form at this tick's sample position so results do not depend on block size
+    const int tickOffset = clockManager.getHitSampleOffset();
+    const auto tickSamplePosition = currentSamplePosition + tickOffset;
+    modulationMatrix.resolveModulationAt(tickOffset / getSampleRate());
+
     // Update scale quantizer from parameters
     auto scaleRoot = static_cast<int>(parameters.getRawParameterValue(PARAM_SCALE_ROOT)->load());
     auto scaleType = static_cast<int>(parameters.getRawParameterValue(PARAM_SCALE_TYPE)->load());
@@ -388,7 +567,7 @@ void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
     scaleQuantizer.setScale(static_cast<ScaleQuantizer::Scale>(scaleType));
 
     // Update swing engine from parameters
-    auto swingAmount = parameters.getRawParameterValue(PARAM_SWING_AMOUNT)->load();
+    auto swingAmount = getModulatedParameterValue(modulatedParams.swingAmount);
     auto timingHumanize = parameters.getRawParameterValue(PARAM_TIMING_HUMANIZE)->load();
     auto velocityHumanize = parameters.getRawParameterValue(PARAM_VELOCITY_HUMANIZE)->load();
     swingEngine.setSwingAmount(swingAmount);
@@ -396,7 +575,7 @@ void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
     swingEngine.setVelocityRandomness(velocityHumanize);
 
     // Update gate length controller from parameters
-    auto gateLength = parameters.getRawParameterValue(PARAM_GATE_LENGTH)->load();
+    auto gateLength = getModulatedParameterValue(modulatedParams.gateLength);
     auto legatoMode = parameters.getRawParameterValue(PARAM_LEGATO_MODE)->load() > 0.5f;
     gateLengthController.setGateLength(gateLength);
     gateLengthController.setLegatoMode(legatoMode);
@@ -412,17 +591,50 @@ void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
     // Generate events based on selected generator type
     auto generatorType = parameters.getRawParameterValue(PARAM_GENERATOR_TYPE)->load();
 
-    // Get velocity and pitch range parameters
-    auto velocityMin = parameters.getRawParameterValue(PARAM_VELOCITY_MIN)->load();
-    auto velocityMax = parameters.getRawParameterValue(PARAM_VELOCITY_MAX)->load();
-    auto pitchMin = static_cast<int>(parameters.getRawParameterValue(PARAM_PITCH_MIN)->load());
-    auto pitchMax = static_cast<int>(parameters.getRawParameterValue(PARAM_PITCH_MAX)->load());
+    // Get velocity and pitch range parameters (modulated at the tick)
+    auto velocityMin = getModulatedParameterValue(modulatedParams.velocityMin);
+    auto velocityMax = getModulatedParameterValue(modulatedParams.velocityMax);
+    auto pitchMin = static_cast<int>(getModulatedParameterValue(modulatedParams.pitchMin));
+    auto pitchMax = static_cast<int>(getModulatedParameterValue(modulatedParams.pitchMax));
 
     // Get MIDI channel parameter
     auto midiChannel = static_cast<int>(parameters.getRawParameterValue(PARAM_MIDI_CHANNEL)->load());
 
     // Get probability/density parameter - applies to ALL generators
-    auto density = parameters.getRawParameterValue(PARAM_NOTE_DENSITY)->load();
+    auto density = getModulatedParameterValue(modulatedParams.noteDensity);
+
+    // Pattern chain: switch engine states at exact tick positions
+    if (parameters.getRawParameterValue(PARAM_CHAIN_MODE)->load() > 0.5f)
+    {
+        // Beat-grid index of this hit, so the chain's bar lines are the host's
+        auto tick = clockManager.getHitGridTick();
+
+        if (const auto* chainState = patternChain.processTick(tick))
+        {
+            // State was prepared when the chain was compiled; only copy it in
+            const auto& entry = chainState->entry;
+            euclideanEngine.applyPreparedPattern(entry.euclideanSteps, entry.euclideanPulses,
+                                                 entry.euclideanRotation,
+                                                 chainState->euclideanPattern,
+                                                 chainState->euclideanVelocities);
+            euclideanEngine.resetConditionState();
+            polyrhythmEngine.reset();
+            lastSubdivisionStep = 0;
+        }
+
+        if (const auto* activeState = patternChain.getActiveState())
+        {
+            generatorType = static_cast<float>(activeState->entry.generatorType);
+            density = activeState->entry.noteDensity;
+        }
+    }
+    else
+    {
+        patternChain.resetPlayback();
+    }
+
+    // Fill mode for conditional trigs (Euclidean and Polyrhythm)
+    auto fillMode = parameters.getRawParameterValue(PARAM_FILL_MODE)->load() > 0.5f;
 
     // Get MIDI expression parameters
     auto aftertouchEnable = parameters.getRawParameterValue(PARAM_AFTERTOUCH_ENABLE)->load() > 0.5f;
@@ -437,160 +649,163 @@ void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
     {
         case 0: // Euclidean
         {
-            int step = lastSubdivisionStep % euclideanEngine.getSteps();
-            if (euclideanEngine.getStep(step))
+            // Immutable lanes: UI edits publish a new snapshot instead of mutating this
+            const auto& stepLanes = euclideanEngine.acquireStepLanes();
+            const auto& conditionLane = stepLanes.conditions;
+            auto& conditionState = euclideanEngine.getConditionState();
+
+            // Precomputed swing + nudge offsets
+            int samplesPerStep = static_cast<int>(clockManager.getSamplesPerSubdivision(16));
+            auto& microtiming = euclideanEngine.getMicrotimingTable();
+            microtiming.update(stepLanes.microtiming, swingEngine, samplesPerStep);
+
+            // Decides a step (once, in step order) and schedules it relative to its own tick
+            auto playStep = [&](int step, juce::int64 stepSamplePosition, bool early)
             {
-                // Apply probability check to Euclidean rhythm
-                if (juce::Random::getSystemRandom().nextFloat() < density)
-                {
-                    // Get raw velocity from engine and map to user-defined range
-                    float rawVelocity = euclideanEngine.getVelocity(step);
-                    float velocity = velocityMin + (rawVelocity * (velocityMax - velocityMin));
+                // Combine conditional trig masks once per pattern cycle
+                if (step == 0 || !conditionState.cycleStarted)
+                    conditionLane.beginCycle(conditionState, fillMode);
 
-                    // Apply velocity humanization
-                    velocity = swingEngine.humanizeVelocity(velocity);
+                if (!euclideanEngine.getStep(step))
+                    return;
 
-                    // Map step to pitch range instead of just adding offset
-                    int pitchRange = pitchMax - pitchMin;
-                    int rawPitch = pitchMin + (step % (pitchRange + 1));
+                // Step probability and conditions, scaled by the global density
+                if (!conditionLane.evaluate(conditionState, step,
+                        juce::Random::getSystemRandom().nextFloat(), density))
+                    return; // Probability or condition miss - note scheduled but not played
 
-                    // Apply scale quantization
-                    int pitch = scaleQuantizer.quantize(rawPitch);
+                const auto& locks = conditionLane.getParameterLocks(step);
 
-                    // Calculate swing and humanization timing offset
-                    int samplesPerStep = static_cast<int>(clockManager.getSamplesPerSubdivision(16));
-                    int timingOffset = swingEngine.calculateTotalTimingOffset(
-                        step, samplesPerStep, getSampleRate());
+                // Get raw velocity from engine and map to user-defined range
+                float rawVelocity = locks.locksVelocity() ? locks.velocity : euclideanEngine.getVelocity(step);
+                float velocity = velocityMin + (rawVelocity * (velocityMax - velocityMin));
 
-                    // Check if ratcheting should be applied
-                    bool useRatcheting = ratchetEngine.shouldRatchet();
-                    auto ratchetOffsets = useRatcheting ?
-                        ratchetEngine.calculateRatchetOffsets(samplesPerStep) :
-                        std::vector<int>{0};
+                // Apply velocity humanization
+                velocity = swingEngine.humanizeVelocity(velocity);
 
-                    // Schedule note(s) with optional ratcheting
-                    for (size_t ratchetIdx = 0; ratchetIdx < ratchetOffsets.size(); ++ratchetIdx)
-                    {
-                        // Calculate velocity with ratchet decay
-                        float ratchetVelocity = ratchetEngine.calculateRatchetVelocity(
-                            velocity, static_cast<int>(ratchetIdx));
+                // Map step to pitch range instead of just adding offset
+                int pitchRange = pitchMax - pitchMin;
+                int rawPitch = locks.locksPitch() ? locks.pitch : pitchMin + (step % (pitchRange + 1));
 
-                        int ratchetTimingOffset = timingOffset + ratchetOffsets[ratchetIdx];
+                // Apply scale quantization
+                int pitch = scaleQuantizer.quantize(rawPitch);
 
-                        // Schedule note on
-                        eventScheduler.scheduleNoteOn(pitch, ratchetVelocity, midiChannel,
-                            currentSamplePosition + ratchetTimingOffset);
+                // An early step that could not be looked ahead plays on its tick, never in the past
+                int stepOffset = early ? microtiming.getOffset(step) : juce::jmax(0, microtiming.getOffset(step));
+                int timingOffset = stepOffset + swingEngine.calculateTimingHumanization(getSampleRate());
 
-                        // Schedule note off using gate length controller
-                        int noteDuration = gateLengthController.calculateGateLengthSamples(samplesPerStep);
-                        eventScheduler.scheduleNoteOff(pitch, midiChannel,
-                            currentSamplePosition + ratchetTimingOffset + noteDuration);
-                    }
+                // Check if ratcheting should be applied
+                bool useRatcheting = ratchetEngine.shouldRatchet();
+                auto ratchetOffsets = useRatcheting ?
+                    ratchetEngine.calculateRatchetOffsets(samplesPerStep) :
+                    std::vector<int>{0};
+
+                // Schedule note(s) with optional ratcheting
+                for (size_t ratchetIdx = 0; ratchetIdx < ratchetOffsets.size(); ++ratchetIdx)
+                {
+                    // Calculate velocity with ratchet decay
+                    float ratchetVelocity = ratchetEngine.calculateRatchetVelocity(
+                        velocity, static_cast<int>(ratchetIdx));
+
+                    int ratchetTimingOffset = timingOffset + ratchetOffsets[ratchetIdx];
+
+                    // Schedule note on
+                    eventScheduler.scheduleNoteOn(pitch, ratchetVelocity, midiChannel,
+                        stepSamplePosition + ratchetTimingOffset);
+
+                    // Schedule note off using gate length controller (or the step's gate lock)
+                    int noteDuration = locks.locksGate()
+                        ? gateLengthController.calculateGateLengthSamples(samplesPerStep, locks.gateLength)
+                        : gateLengthController.calculateGateLengthSamples(samplesPerStep);
+                    eventScheduler.scheduleNoteOff(pitch, midiChannel,
+                        stepSamplePosition + ratchetTimingOffset + noteDuration);
                 }
-                // else: probability miss - note scheduled but not played
-            }
+            };
+
+            const int numSteps = euclideanEngine.getSteps();
+            const int step = lastSubdivisionStep % numSteps;
+
+            // A step nudged early was already decided and scheduled on the previous tick
+            if (!conditionState.nextStepDecided)
+                playStep(step, tickSamplePosition, false);
+
+            // Look one step ahead: a step that starts before its own tick is scheduled
+            // now, so it lands at the same sample whatever the buffer size
+            const int nextStep = (step + 1) % numSteps;
+            conditionState.nextStepDecided = microtiming.getOffset(nextStep) < 0;
+            if (conditionState.nextStepDecided)
+                playStep(nextStep, tickSamplePosition + samplesPerStep, true);
+
             lastSubdivisionStep++;
             break;
         }
 
         case 1: // Polyrhythm
         {
-            for (int i = 0; i < polyrhythmEngine.getNumLayers(); ++i)
+            // Immutable snapshot: UI edits publish a new one instead of mutating this
+            const auto& polySnapshot = polyrhythmEngine.acquireSnapshot();
+            const auto globalRatchet = ratchetEngine.getProfile();
+            int samplesPerStep = static_cast<int>(clockManager.getSamplesPerSubdivision(16));
+
+            for (int i = 0; i < static_cast<int>(polySnapshot.layers.size()); ++i)
             {
-                auto* layer = polyrhythmEngine.getLayer(i);
-                if (!layer || !layer->enabled)
+                const auto& layer = polySnapshot.layers[i];
+                if (!layer.enabled)
                     continue;
 
-                // Check if this step should trigger
-                if (layer->pattern[layer->currentStep])
-                {
-                    // Apply probability check to polyrhythm
-                    if (juce::Random::getSystemRandom().nextFloat() < density)
-                    {
-                        // Constrain pitch to user-defined range then quantize to scale
-                        int rawPitch = juce::jlimit(pitchMin, pitchMax, layer->pitches[layer->currentStep]);
-                        int pitch = scaleQuantizer.quantize(rawPitch);
-
-                        // Map velocity to user-defined range
-                        float rawVelocity = layer->velocities[layer->currentStep];
-                        float velocity = velocityMin + (rawVelocity * (velocityMax - velocityMin));
-
-                        // Apply velocity humanization
-                        velocity = swingEngine.humanizeVelocity(velocity);
-
-                        // Calculate swing and timing offset
-                        int samplesPerStep = static_cast<int>(clockManager.getSamplesPerSubdivision(16));
-                        int timingOffset = swingEngine.calculateTotalTimingOffset(
-                            layer->currentStep, samplesPerStep, getSampleRate());
-
-                        // Check if ratcheting should be applied
-                        bool useRatcheting = ratchetEngine.shouldRatchet();
-                        auto ratchetOffsets = useRatcheting ?
-                            ratchetEngine.calculateRatchetOffsets(samplesPerStep) :
-                            std::vector<int>{0};
-
-                        // Schedule note(s) with optional ratcheting
-                        for (size_t ratchetIdx = 0; ratchetIdx < ratchetOffsets.size(); ++ratchetIdx)
-                        {
-                            // Calculate velocity with ratchet decay
-                            float ratchetVelocity = ratchetEngine.calculateRatchetVelocity(
-                                velocity, static_cast<int>(ratchetIdx));
-
-                            int ratchetTimingOffset = timingOffset + ratchetOffsets[ratchetIdx];
-
-                            // Schedule note on
-                            eventScheduler.scheduleNoteOn(pitch, ratchetVelocity, 1,
-                                currentSamplePosition + ratchetTimingOffset);
-
-                            // Schedule note off using gate length controller
-                            int noteDuration = gateLengthController.calculateGateLengthSamples(samplesPerStep);
-                            eventScheduler.scheduleNoteOff(pitch, 1,
-                                currentSamplePosition + ratchetTimingOffset + noteDuration);
-                        }
-                    }
-                    // else: probability miss - note scheduled but not played
-                }
+                auto& conditionState = polyrhythmEngine.getConditionState(i);
 
-                // Advance to next step
-                layer->currentStep = (layer->currentStep + 1) % layer->length;
-            }
-            break;
-        }
+                // Precomputed swing + nudge offsets
+                auto& microtiming = polyrhythmEngine.getMicrotimingTable(i);
+                microtiming.update(layer.microtiming, swingEngine, samplesPerStep);
 
-        default: // Algorithmic generators
-        {
-            // Apply probability check to algorithmic generators
-            if (juce::Random::getSystemRandom().nextFloat() < density)
-            {
-                // Update algorithmic engine with current parameter ranges
-                algorithmicEngine.setPitchRange(pitchMin, pitchMax);
-                algorithmicEngine.setVelocityRange(velocityMin, velocityMax);
-
-                auto notes = algorithmicEngine.generateNoteSequence(1);
-                if (!notes.empty() && notes[0] >= 0)
+                // Decides a step (once, in step order) and schedules it relative to its own tick
+                auto playStep = [&](int step, juce::int64 stepSamplePosition, bool early)
                 {
-                    // Constrain generated note to user-defined pitch range then quantize to scale
-                    int rawPitch = juce::jlimit(pitchMin, pitchMax, notes[0]);
+                    // Combine conditional trig masks once per layer cycle
+                    if (step == 0 || !conditionState.cycleStarted)
+                        layer.conditions.beginCycle(conditionState, fillMode);
+
+                    // Check if this step should trigger
+                    if (!layer.pattern[step])
+                        return;
+
+                    // Step probability and conditions, scaled by the global density
+                    if (!layer.conditions.evaluate(conditionState, step,
+                            juce::Random::getSystemRandom().nextFloat(), density))
+                        return; // Probability or condition miss - note scheduled but not played
+
+                    const auto& locks = layer.conditions.getParameterLocks(step);
+
+                    // Resolve per-layer routing (falls back to global settings)
+                    const auto& routing = layer.routing;
+                    int layerChannel = routing.midiChannel > 0 ? routing.midiChannel : midiChannel;
+                    float layerGate = locks.locksGate() ? locks.gateLength
+                                    : (routing.gateLength > 0.0f ? routing.gateLength : gateLength);
+                    const auto& layerRatchet = routing.useGlobalRatchet ? globalRatchet : routing.ratchet;
+                    float layerVelocityMin = routing.useGlobalVelocityRange ? velocityMin : routing.velocityMin;
+                    float layerVelocityMax = routing.useGlobalVelocityRange ? velocityMax : routing.velocityMax;
+
+                    // Constrain pitch to user-defined range then quantize to scale
+                    int stepPitch = locks.locksPitch() ? locks.pitch : layer.pitches[step];
+                    int rawPitch = juce::jlimit(pitchMin, pitchMax, stepPitch);
                     int pitch = scaleQuantizer.quantize(rawPitch);
 
-                    auto velocities = algorithmicEngine.generateVelocitySequence(1);
-                    float rawVelocity = velocities.empty() ? 0.7f : velocities[0];
-
-                    // Map velocity to user-defined range
-                    float velocity = velocityMin + (rawVelocity * (velocityMax - velocityMin));
+                    // Map velocity to the layer's velocity range
+                    float rawVelocity = locks.locksVelocity() ? locks.velocity : layer.velocities[step];
+                    float velocity = layerVelocityMin + (rawVelocity * (layerVelocityMax - layerVelocityMin));
 
                     // Apply velocity humanization
                     velocity = swingEngine.humanizeVelocity(velocity);
 
-                    // Calculate swing and timing offset
-                    int samplesPerStep = static_cast<int>(clockManager.getSamplesPerSubdivision(16));
-                    int timingOffset = swingEngine.calculateTotalTimingOffset(
-                        lastSubdivisionStep, samplesPerStep, getSampleRate());
+                    // An early step that could not be looked ahead plays on its tick, never in the past
+                    int stepOffset = early ? microtiming.getOffset(step) : juce::jmax(0, microtiming.getOffset(step));
+                    int timingOffset = stepOffset + swingEngine.calculateTimingHumanization(getSampleRate());
 
                     // Check if ratcheting should be applied
-                    bool useRatcheting = ratchetEngine.shouldRatchet();
+                    bool useRatcheting = ratchetEngine.shouldRatchet(layerRatchet);
                     auto ratchetOffsets = useRatcheting ?
-                        ratchetEngine.calculateRatchetOffsets(samplesPerStep) :
+                        ratchetEngine.calculateRatchetOffsets(samplesPerStep, layerRatchet.count) :
                         std::vector<int>{0};
 
                     // Schedule note(s) with optional ratcheting
@@ -598,22 +813,138 @@ void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
                     {
                         // Calculate velocity with ratchet decay
                         float ratchetVelocity = ratchetEngine.calculateRatchetVelocity(
-                            velocity, static_cast<int>(ratchetIdx));
+                            velocity, static_cast<int>(ratchetIdx), layerRatchet.velocityDecay);
 
                         int ratchetTimingOffset = timingOffset + ratchetOffsets[ratchetIdx];
 
                         // Schedule note on
-                        eventScheduler.scheduleNoteOn(pitch, ratchetVelocity, midiChannel,
-                            currentSamplePosition + ratchetTimingOffset);
+                        eventScheduler.scheduleNoteOn(pitch, ratchetVelocity, layerChannel,
+                            stepSamplePosition + ratchetTimingOffset);
 
-                        // Schedule note off using gate length controller
-                        int noteDuration = gateLengthController.calculateGateLengthSamples(samplesPerStep);
-                        eventScheduler.scheduleNoteOff(pitch, midiChannel,
-                            currentSamplePosition + ratchetTimingOffset + noteDuration);
+                        // Schedule note off using the layer's gate length
+                        int noteDuration = gateLengthController.calculateGateLengthSamples(samplesPerStep, layerGate);
+                        eventScheduler.scheduleNoteOff(pitch, layerChannel,
+                            stepSamplePosition + ratchetTimingOffset + noteDuration);
                     }
+                };
+
+                const int currentStep = polyrhythmEngine.getCurrentStep(i, layer.length);
+
+                // A step nudged early was already decided and scheduled on the previous tick
+                if (!conditionState.nextStepDecided)
+                    playStep(currentStep, tickSamplePosition, false);
+
+                // Look one step ahead for steps that start before their own tick
+                const int nextStep = (currentStep + 1) % layer.length;
+                conditionState.nextStepDecided = microtiming.getOffset(nextStep) < 0;
+                if (conditionState.nextStepDecided)
+                    playStep(nextStep, tickSamplePosition + samplesPerStep, true);
+
+                // Advance to next step
+                polyrhythmEngine.advanceStep(i, layer);
+            }
+            break;
+        }
+
+        default: // Algorithmic generators
+        {
+            // Select the sub-generator (2-5 = Markov, L-System, Cellular, Probabilistic)
+            static constexpr AlgorithmicEngine::GeneratorType algorithmicTypes[] = {
+                AlgorithmicEngine::Markov, AlgorithmicEngine::LSystem,
+                AlgorithmicEngine::CellularAutomatonType, AlgorithmicEngine::Probabilistic };
+
+            const int algorithmicIndex = juce::jlimit(0, 3, static_cast<int>(generatorType) - 2);
+            algorithmicEngine.setGeneratorType(algorithmicTypes[algorithmicIndex]);
+
+            // Update algorithmic engine with current parameter ranges
+            algorithmicEngine.setPitchRange(pitchMin, pitchMax);
+            algorithmicEngine.setVelocityRange(velocityMin, velocityMax);
+
+            // Advance the generator's cursor every tick so its state follows the clock,
+            // then apply the probability check to the event it produced
+            const auto event = algorithmicEngine.nextEvent();
+
+            if (event.pitch >= 0 && juce::Random::getSystemRandom().nextFloat() < density)
+            {
+                // Constrain generated note to user-defined pitch range then quantize to scale
+                int rawPitch = juce::jlimit(pitchMin, pitchMax, event.pitch);
+                int pitch = scaleQuantizer.quantize(rawPitch);
+
+                float rawVelocity = event.velocity;
+
+                // Map velocity to user-defined range
+                float velocity = velocityMin + (rawVelocity * (velocityMax - velocityMin));
+
+                // Apply velocity humanization
+                velocity = swingEngine.humanizeVelocity(velocity);
+
+                // Calculate swing and timing offset
+                int samplesPerStep = static_cast<int>(clockManager.getSamplesPerSubdivision(16));
+                int timingOffset = swingEngine.calculateTotalTimingOffset(
+                    lastSubdivisionStep, samplesPerStep, getSampleRate());
+
+                // Check if ratcheting should be applied
+                bool useRatcheting = ratchetEngine.shouldRatchet();
+                auto ratchetOffsets = useRatcheting ?
+                    ratchetEngine.calculateRatchetOffsets(samplesPerStep) :
+                    std::vector<int>{0};
+
+                // Events longer than a step (Markov IOI, L-System durations) scale the gate
+                int samplesPerEvent = static_cast<int>(samplesPerStep * juce::jmax(0.0625f, event.durationSteps));
+
+                // Schedule note(s) with optional ratcheting
+                for (size_t ratchetIdx = 0; ratchetIdx < ratchetOffsets.size(); ++ratchetIdx)
+                {
+                    // Calculate velocity with ratchet decay
+                    float ratchetVelocity = ratchetEngine.calculateRatchetVelocity(
+                        velocity, static_cast<int>(ratchetIdx));
+
+                    int ratchetTimingOffset = timingOffset + ratchetOffsets[ratchetIdx];
+
+                    // Schedule note on
+                    eventScheduler.scheduleNoteOn(pitch, ratchetVelocity, midiChannel,
+                        tickSamplePosition + ratchetTimingOffset);
+
+                    // Schedule note off using gate length controller
+                    int noteDuration = gateLengthController.calculateGateLengthSamples(
+                        useRatcheting ? samplesPerStep : samplesPerEvent);
+                    eventScheduler.scheduleNoteOff(pitch, midiChannel,
+                        tickSamplePosition + ratchetTimingOffset + noteDuration);
                 }
             }
-            // else: probability miss - note scheduled but not played
+            // else: rest, or probability miss - note scheduled but not played
+            break;
+        }
+
+        case 10: // Life: every cell born in the play column triggers a note
+        {
+            algorithmicEngine.setPitchRange(pitchMin, pitchMax);
+            algorithmicEngine.setVelocityRange(velocityMin, velocityMax);
+
+            std::array<int, LifeAutomaton::numRows> voices;
+            const int numVoices = algorithmicEngine.generateLifeVoices(voices.data(), static_cast<int>(voices.size()));
+
+            int samplesPerStep = static_cast<int>(clockManager.getSamplesPerSubdivision(16));
+            int timingOffset = swingEngine.calculateTotalTimingOffset(
+                lastSubdivisionStep, samplesPerStep, getSampleRate());
+            int noteDuration = gateLengthController.calculateGateLengthSamples(samplesPerStep);
+
+            for (int voice = 0; voice < numVoices; ++voice)
+            {
+                // Density thins out dense generations
+                if (juce::Random::getSystemRandom().nextFloat() >= density)
+                    continue;
+
+                int pitch = scaleQuantizer.quantize(voices[static_cast<size_t>(voice)]);
+
+                float rawVelocity = juce::Random::getSystemRandom().nextFloat();
+                float velocity = swingEngine.humanizeVelocity(velocityMin + (rawVelocity * (velocityMax - velocityMin)));
+
+                eventScheduler.scheduleNoteOn(pitch, velocity, midiChannel,
+                    tickSamplePosition + timingOffset);
+                eventScheduler.scheduleNoteOff(pitch, midiChannel,
+                    tickSamplePosition + timingOffset + noteDuration);
+            }
             break;
         }
 
@@ -621,6 +952,10 @@ void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
         case 7: // Perlin Noise
         case 8: // Drunk Walk
         case 9: // Lorenz Attractor
+        case 11: // Rossler Attractor
+        case 12: // Thomas Attractor
+        case 13: // Henon Map
+        case 14: // Chua Circuit
         {
             // Update stochastic engine from parameters
             auto stochasticType = static_cast<int>(parameters.getRawParameterValue(PARAM_STOCHASTIC_TYPE)->load());
@@ -637,9 +972,62 @@ void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
                 case 7: type = StochasticEngine::GeneratorType::PerlinNoise; break;
                 case 8: type = StochasticEngine::GeneratorType::DrunkWalk; break;
                 case 9: type = StochasticEngine::GeneratorType::LorenzAttractor; break;
+                case 11: type = StochasticEngine::GeneratorType::RosslerAttractor; break;
+                case 12: type = StochasticEngine::GeneratorType::ThomasAttractor; break;
+                case 13: type = StochasticEngine::GeneratorType::HenonMap; break;
+                case 14: type = StochasticEngine::GeneratorType::ChuaCircuit; break;
                 default: type = StochasticEngine::GeneratorType::BrownianMotion; break;
             }
 
+            // Ensemble mode: several walkers of this type, each on its own pitch band
+            const int ensembleVoices = static_cast<int>(parameters.getRawParameterValue(PARAM_ENSEMBLE_VOICES)->load());
+            if (ensembleVoices > 1)
+            {
+                const bool spreadChannels = parameters.getRawParameterValue(PARAM_ENSEMBLE_SPREAD_CHANNELS)->load() > 0.5f;
+                const int pitchSpan = juce::jmax(0, pitchMax - pitchMin);
+
+                stochasticEnsemble.setNumWalkers(ensembleVoices);
+                stochasticEnsemble.setStepSize(stepSize);
+                stochasticEnsemble.setMomentum(momentum);
+                stochasticEnsemble.setTimeScale(timeScale);
+
+                for (int walker = 0; walker < ensembleVoices; ++walker)
+                {
+                    StochasticEnsemble::WalkerSettings walkerSettings;
+                    walkerSettings.type = type;
+                    walkerSettings.midiChannel = spreadChannels ? ((midiChannel - 1 + walker) % 16) + 1 : midiChannel;
+                    walkerSettings.minPitch = pitchMin + (pitchSpan * walker) / ensembleVoices;
+                    walkerSettings.maxPitch = pitchMin + (pitchSpan * (walker + 1)) / ensembleVoices;
+                    walkerSettings.density = density;
+                    stochasticEnsemble.setWalker(walker, walkerSettings);
+                }
+
+                double secondsPerSubdivision = clockManager.getSamplesPerSubdivision(16) / getSampleRate();
+                stochasticEnsemble.advance(static_cast<float>(secondsPerSubdivision));
+
+                int samplesPerStep = static_cast<int>(clockManager.getSamplesPerSubdivision(16));
+                int timingOffset = swingEngine.calculateTotalTimingOffset(
+                    lastSubdivisionStep, samplesPerStep, getSampleRate());
+                int noteDuration = gateLengthController.calculateGateLengthSamples(samplesPerStep);
+
+                for (int walker = 0; walker < ensembleVoices; ++walker)
+                {
+                    if (!stochasticEnsemble.shouldTriggerNote(walker))
+                        continue;
+
+                    int pitch = scaleQuantizer.quantize(stochasticEnsemble.getCurrentPitch(walker));
+                    float velocity = swingEngine.humanizeVelocity(
+                        stochasticEnsemble.getCurrentVelocity(walker, velocityMin, velocityMax));
+                    int channel = stochasticEnsemble.getChannel(walker);
+
+                    eventScheduler.scheduleNoteOn(pitch, velocity, channel,
+                        tickSamplePosition + timingOffset);
+                    eventScheduler.scheduleNoteOff(pitch, channel,
+                        tickSamplePosition + timingOffset + noteDuration);
+                }
+                break;
+            }
+
             stochasticEngine.setGeneratorType(type);
             stochasticEngine.setDensity(density);
             stochasticEngine.setStepSize(stepSize);
@@ -682,13 +1070,13 @@ void GenerativeMIDIProcessor::onSubdivisionHit(int subdivision)
                     int ratchetTimingOffset = timingOffset + ratchetOffsets[ratchetIdx];
 
                     // Schedule note on
-                    eventScheduler.scheduleNoteOn(pitch, ratchetVelocity, 1,
-                        currentSamplePosition + ratchetTimingOffset);
+                    eventScheduler.scheduleNoteOn(pitch, ratchetVelocity, midiChannel,
+                        tickSamplePosition + ratchetTimingOffset);
 
                     // Schedule note off using gate length controller
                     int noteDuration = gateLengthController.calculateGateLengthSamples(samplesPerStep);
-                    eventScheduler.scheduleNoteOff(pitch, 1,
-                        currentSamplePosition + ratchetTimingOffset + noteDuration);
+                    eventScheduler.scheduleNoteOff(pitch, midiChannel,
+                        tickSamplePosition + ratchetTimingOffset + noteDuration);
                 }
             }
             break;
@@ -707,11 +1095,60 @@ juce::AudioProcessorEditor* GenerativeMIDIProcessor::createEditor()
     return new GenerativeMIDIEditor(*this);
 }
 
+//==============================================================================
+bool GenerativeMIDIProcessor::loadMarkovModelFile(const juce::File& modelFile)
+{
+    if (!mapMarkovModelFile(modelFile))
+        return false;
+
+    algorithmicEngine.getVariableOrderMarkov().reset();
+    return true;
+}
+
+bool GenerativeMIDIProcessor::mapMarkovModelFile(const juce::File& modelFile)
+{
+    if (!algorithmicEngine.getMarkovChain().loadModelFile(modelFile))
+        return false;
+
+    parameters.state.setProperty("markovModelPath", modelFile.getFullPathName(), nullptr);
+    return true;
+}
+
+bool GenerativeMIDIProcessor::trainMarkovModel(const juce::File& midiFolder, const juce::File& modelFile,
+                                               std::function<void(const MarkovCorpusTrainer::Report&)> onFinished)
+{
+    if (isTrainingMarkovModel())
+        return false;
+
+    markovTrainingOutput = modelFile;
+    onMarkovTrainingFinished = std::move(onFinished);
+
+    const int order = algorithmicEngine.getMarkovChain().getOrder();
+    markovTrainingPool.addJob([this, midiFolder, modelFile, order]
+    {
+        auto& jointModel = algorithmicEngine.getVariableOrderMarkov();
+        jointModel.reset();
+
+        MarkovCorpusTrainer trainer(order);
+        trainer.setJointModel(&jointModel);
+        trainer.addFolder(midiFolder);
+        markovTrainingReport = trainer.train(modelFile, &cancelMarkovTraining);
+
+        markovTrainingFinished.store(true);
+        triggerAsyncUpdate();
+    });
+
+    return true;
+}
+
 //==============================================================================
 void GenerativeMIDIProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
     auto state = parameters.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    xml->addChildElement(patternChain.toXml().release());
+    xml->addChildElement(euclideanEngine.stepLanesToXml().release());
+    xml->addChildElement(polyrhythmEngine.stepLanesToXml().release());
     copyXmlToBinary(*xml, destData);
 }
 
@@ -720,8 +1157,35 @@ void GenerativeMIDIProcessor::setStateInformation(const void* data, int sizeInBy
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
+    {
         if (xmlState->hasTagName(parameters.state.getType()))
+        {
+            if (auto* chainXml = xmlState->getChildByName("PatternChain"))
+                patternChain.fromXml(*chainXml);
+            xmlState->deleteAllChildElementsWithTagName("PatternChain");
+
+            // Per-step conditions and locks; older states have none, so clear the lanes
+            if (auto* lanesXml = xmlState->getChildByName("EuclideanStepLanes"))
+                euclideanEngine.stepLanesFromXml(*lanesXml);
+            else
+                euclideanEngine.stepLanesFromXml(juce::XmlElement("EuclideanStepLanes"));
+
+            if (auto* lanesXml = xmlState->getChildByName("PolyrhythmStepLanes"))
+                polyrhythmEngine.stepLanesFromXml(*lanesXml);
+            else
+                polyrhythmEngine.stepLanesFromXml(juce::XmlElement("PolyrhythmStepLanes"));
+
+            xmlState->deleteAllChildElementsWithTagName("EuclideanStepLanes");
+            xmlState->deleteAllChildElementsWithTagName("PolyrhythmStepLanes");
+
             parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+
+            // Re-map a trained Markov model; shared with other instances via the page cache
+            auto modelPath = parameters.state.getProperty("markovModelPath").toString();
+            if (modelPath.isNotEmpty() && juce::File(modelPath).existsAsFile())
+                algorithmicEngine.getMarkovChain().loadModelFile(juce::File(modelPath));
+        }
+    }
 }
 
 //==============================================================================
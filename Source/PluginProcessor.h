@@ -14,17 +14,23 @@
 #include "Core/PolyrhythmEngine.h"
 #include "Core/AlgorithmicEngine.h"
 #include "Core/StochasticEngine.h"
+#include "Core/StochasticEnsemble.h"
 #include "Core/MIDIGenerator.h"
 #include "Core/ScaleQuantizer.h"
 #include "Core/SwingEngine.h"
 #include "Core/GateLengthController.h"
 #include "Core/RatchetEngine.h"
 #include "Core/PresetManager.h"
+#include "Core/PatternChain.h"
+#include "Core/MarkovLearner.h"
+#include "Core/MarkovCorpusTrainer.h"
 #include "DSP/ClockManager.h"
 #include "DSP/EventScheduler.h"
 #include "Modulation/ModulationMatrix.h"
 
-class GenerativeMIDIProcessor : public juce::AudioProcessor
+class GenerativeMIDIProcessor : public juce::AudioProcessor,
+                                private juce::AudioProcessorValueTreeState::Listener,
+                                private juce::AsyncUpdater
 {
 public:
     GenerativeMIDIProcessor();
@@ -69,6 +75,7 @@ public:
     PolyrhythmEngine& getPolyrhythmEngine() { return polyrhythmEngine; }
     AlgorithmicEngine& getAlgorithmicEngine() { return algorithmicEngine; }
     StochasticEngine& getStochasticEngine() { return stochasticEngine; }
+    StochasticEnsemble& getStochasticEnsemble() { return stochasticEnsemble; }
     MIDIGenerator& getMIDIGenerator() { return midiGenerator; }
     ClockManager& getClockManager() { return clockManager; }
     EventScheduler& getEventScheduler() { return eventScheduler; }
@@ -78,6 +85,8 @@ public:
     RatchetEngine& getRatchetEngine() { return ratchetEngine; }
     PresetManager& getPresetManager() { return presetManager; }
     ModulationMatrix& getModulationMatrix() { return modulationMatrix; }
+    PatternChain& getPatternChain() { return patternChain; }
+    MarkovLearner& getMarkovLearner() { return markovLearner; }
 
     // Parameter tree
     juce::AudioProcessorValueTreeState& getValueTreeState() { return parameters; }
@@ -85,18 +94,42 @@ public:
     // Playback state
     int getCurrentStep() const { return lastSubdivisionStep; }
 
-    // Helper to get modulated parameter value
-    float getModulatedParameterValue(const juce::String& paramID) const
+    // Memory-maps a trained Markov model file; the path is saved with the plugin state.
+    // Clears the in-memory joint model, which would otherwise take precedence.
+    bool loadMarkovModelFile(const juce::File& modelFile);
+
+    // Trains a Markov model from a folder of MIDI files on a background thread,
+    // writes it to modelFile and loads it; the joint model is retrained from the
+    // same corpus. onFinished is called on the message thread. Returns false if
+    // a training run is already in progress.
+    bool trainMarkovModel(const juce::File& midiFolder, const juce::File& modelFile,
+                          std::function<void(const MarkovCorpusTrainer::Report&)> onFinished);
+    bool isTrainingMarkovModel() const { return markovTrainingPool.getNumJobs() > 0 || markovTrainingFinished.load(); }
+
+    // Modulated parameter value by index (modulation destination index == parameter index).
+    // Modulation is added in the parameter's normalised 0-1 range and the result is
+    // returned in parameter units. Uses the modulation last resolved (block start or
+    // tick position); no string lookups.
+    float getModulatedParameterValue(int parameterIndex) const
     {
-        auto* param = parameters.getRawParameterValue(paramID);
-        if (!param)
+        if (parameterIndex < 0 || parameterIndex >= static_cast<int>(rangedParameters.size()))
             return 0.0f;
 
-        float baseValue = param->load();
-        float modulation = modulationMatrix.calculateModulation(paramID);
+        const auto index = static_cast<size_t>(parameterIndex);
+        float baseValue = rawParameterValues[index]->load();
+        float modulation = modulationMatrix.getModulation(parameterIndex);
+        if (modulation == 0.0f)
+            return baseValue;
+
+        const auto* param = rangedParameters[index];
+        float normalised = juce::jlimit(0.0f, 1.0f, param->convertTo0to1(baseValue) + modulation);
+        return param->getNormalisableRange().snapToLegalValue(param->convertFrom0to1(normalised));
+    }
 
-        // Apply modulation (normalized 0-1 range)
-        return juce::jlimit(0.0f, 1.0f, baseValue + modulation);
+    // Helper to get modulated parameter value by ID (looks up the index; not for realtime use)
+    float getModulatedParameterValue(const juce::String& paramID) const
+    {
+        return getModulatedParameterValue(modulationMatrix.getDestinationIndex(paramID));
     }
 
 private:
@@ -106,6 +139,7 @@ private:
     PolyrhythmEngine polyrhythmEngine;
     AlgorithmicEngine algorithmicEngine;
     StochasticEngine stochasticEngine;
+    StochasticEnsemble stochasticEnsemble;
     MIDIGenerator midiGenerator;
     ClockManager clockManager;
     EventScheduler eventScheduler;
@@ -114,8 +148,49 @@ private:
     GateLengthController gateLengthController;
     RatchetEngine ratchetEngine;
 
+    // Song mode
+    PatternChain patternChain;
+
+    // Trains the Markov generator from incoming MIDI notes; its thread runs
+    // only while prepared and the markovLearn parameter is on
+    MarkovLearner markovLearner { algorithmicEngine.getMarkovChain(), algorithmicEngine.getVariableOrderMarkov() };
+    std::atomic<bool> isPrepared { false };
+
+    // Corpus training runs on its own thread; the result is picked up in handleAsyncUpdate()
+    juce::ThreadPool markovTrainingPool { 1 };
+    std::atomic<bool> cancelMarkovTraining { false };
+    std::atomic<bool> markovTrainingFinished { false };
+    MarkovCorpusTrainer::Report markovTrainingReport;   // Written by the job before markovTrainingFinished
+    juce::File markovTrainingOutput;
+    std::function<void(const MarkovCorpusTrainer::Report&)> onMarkovTrainingFinished;
+
+    bool mapMarkovModelFile(const juce::File& modelFile);
+
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void updateMarkovLearnerThread();
+
     // Modulation
     ModulationMatrix modulationMatrix;
+    std::vector<juce::RangedAudioParameter*> rangedParameters;  // Indexed like the modulation destinations
+    std::vector<std::atomic<float>*> rawParameterValues;
+
+    // Indices of the parameters read with modulation applied
+    struct ModulatedParameterIndices
+    {
+        int tempo = -1;
+        int euclideanSteps = -1;
+        int euclideanPulses = -1;
+        int euclideanRotation = -1;
+        int noteDensity = -1;
+        int velocityMin = -1;
+        int velocityMax = -1;
+        int pitchMin = -1;
+        int pitchMax = -1;
+        int swingAmount = -1;
+        int gateLength = -1;
+    };
+    ModulatedParameterIndices modulatedParams;
 
     // Parameters
     juce::AudioProcessorValueTreeState parameters;
@@ -132,6 +207,9 @@ private:
     static constexpr const char* PARAM_EUCLIDEAN_ROTATION = "euclideanRotation";
     static constexpr const char* PARAM_GENERATOR_TYPE = "generatorType";
     static constexpr const char* PARAM_NOTE_DENSITY = "noteDensity";
+    static constexpr const char* PARAM_FILL_MODE = "fillMode";
+    static constexpr const char* PARAM_CHAIN_MODE = "chainMode";
+    static constexpr const char* PARAM_MARKOV_LEARN = "markovLearn";
     static constexpr const char* PARAM_VELOCITY_MIN = "velocityMin";
     static constexpr const char* PARAM_VELOCITY_MAX = "velocityMax";
     static constexpr const char* PARAM_PITCH_MIN = "pitchMin";
@@ -154,6 +232,8 @@ private:
     static constexpr const char* PARAM_STEP_SIZE = "stepSize";
     static constexpr const char* PARAM_MOMENTUM = "momentum";
     static constexpr const char* PARAM_TIME_SCALE = "timeScale";
+    static constexpr const char* PARAM_ENSEMBLE_VOICES = "ensembleVoices";
+    static constexpr const char* PARAM_ENSEMBLE_SPREAD_CHANNELS = "ensembleSpreadChannels";
 
     // MIDI routing parameters
     static constexpr const char* PARAM_MIDI_CHANNEL = "midiChannel";
@@ -170,8 +250,11 @@ private:
     // Processing state
     int64_t currentSamplePosition = 0;
     int lastSubdivisionStep = 0;
+    bool hostWasPlaying = false;
 
     // Helper methods
+    void syncToHostTransport();
+    void restartSequence();
     void processGenerativeOutput(juce::MidiBuffer& midiMessages, int numSamples);
     void onSubdivisionHit(int subdivision);
 
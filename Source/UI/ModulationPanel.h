@@ -3,7 +3,7 @@
     ModulationPanel.h
 
     Visual modulation source panel with JUCE drag-and-drop routing
-    Shows LFOs, Envelopes, Random sources
+    Shows LFOs, Envelopes, Random and Noise sources
 
   ==============================================================================
 */
@@ -16,12 +16,14 @@
 
 // ============================================================================
 // Modulation Source Button (draggable using JUCE DragAndDropContainer)
+// Dropping another source on a button routes it to this source's rate
 // ============================================================================
-class ModulationSourceButton : public juce::Component
+class ModulationSourceButton : public juce::Component,
+                               public juce::DragAndDropTarget
 {
 public:
-    ModulationSourceButton(int sourceIdx, ModulationSource* src)
-        : sourceIndex(sourceIdx), source(src)
+    ModulationSourceButton(int sourceIdx, ModulationSource* src, ModulationMatrix& matrix)
+        : sourceIndex(sourceIdx), source(src), modMatrix(matrix)
     {
         setSize(80, 60);
     }
@@ -83,6 +85,16 @@ public:
                        juce::Justification::centred);
         }
 
+        // Drag-over indicator (rate modulation target)
+        if (isDragOver)
+        {
+            g.setColour(juce::Colour(CustomLookAndFeel::AETHER_CYAN).withAlpha(0.3f));
+            g.fillRoundedRectangle(bounds, 4.0f);
+
+            g.setColour(juce::Colour(CustomLookAndFeel::AETHER_CYAN));
+            g.drawRoundedRectangle(bounds, 4.0f, 2.0f);
+        }
+
         // Enabled/disabled indicator
         if (source && !source->getEnabled())
         {
@@ -122,13 +134,62 @@ public:
         repaint();
     }
 
+    // DragAndDropTarget interface: another source modulates this source's rate
+    bool isInterestedInDragSource(const SourceDetails& dragSourceDetails) override
+    {
+        return dragSourceDetails.description.isInt()
+            && static_cast<int>(dragSourceDetails.description) != sourceIndex;
+    }
+
+    void itemDragEnter(const SourceDetails& /*dragSourceDetails*/) override
+    {
+        isDragOver = true;
+        repaint();
+    }
+
+    void itemDragExit(const SourceDetails& /*dragSourceDetails*/) override
+    {
+        isDragOver = false;
+        repaint();
+    }
+
+    void itemDropped(const SourceDetails& dragSourceDetails) override
+    {
+        isDragOver = false;
+
+        const int modulatorIndex = dragSourceDetails.description;
+        const auto rateID = ModulationMatrix::getSourceRateDestinationID(sourceIndex);
+
+        bool exists = false;
+        for (const auto& conn : modMatrix.getConnections())
+        {
+            if (conn.sourceIndex == modulatorIndex && conn.parameterID == rateID)
+            {
+                exists = true;
+                break;
+            }
+        }
+
+        if (!exists)
+        {
+            if (modMatrix.addConnection(modulatorIndex, rateID, 0.5f) >= 0)
+                DBG("Created rate modulation: Source " << modulatorIndex << " -> " << rateID);
+            else
+                DBG("Modulation table full: Source " << modulatorIndex << " -> " << rateID);
+        }
+
+        repaint();
+    }
+
     int getSourceIndex() const { return sourceIndex; }
     ModulationSource* getSource() const { return source; }
 
 private:
     int sourceIndex;
     ModulationSource* source;
+    ModulationMatrix& modMatrix;
     bool isDragging = false;
+    bool isDragOver = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationSourceButton)
 };
@@ -197,7 +258,7 @@ public:
             auto* source = modMatrix.getSource(i);
             if (source)
             {
-                auto* button = sourceButtons.add(new ModulationSourceButton(i, source));
+                auto* button = sourceButtons.add(new ModulationSourceButton(i, source, modMatrix));
                 addAndMakeVisible(button);
             }
         }
@@ -213,6 +274,9 @@ private:
         {
             button->repaint();
         }
+
+        // Reclaim routing snapshots the audio thread has moved past
+        modMatrix.collectGarbage();
     }
 
     ModulationMatrix& modMatrix;
@@ -67,8 +67,10 @@ public:
         if (!exists)
         {
             // Create new connection with default depth
-            modMatrix.addConnection(sourceIndex, parameterID, 0.5f);
-            DBG("Created modulation connection: Source " << sourceIndex << " -> " << parameterID);
+            if (modMatrix.addConnection(sourceIndex, parameterID, 0.5f) >= 0)
+                DBG("Created modulation connection: Source " << sourceIndex << " -> " << parameterID);
+            else
+                DBG("Modulation table full: Source " << sourceIndex << " -> " << parameterID);
         }
 
         repaint();
@@ -155,13 +157,20 @@ private:
         }
     }
 
+    // Menu item IDs: each connection's submenu owns a block of connectionItemBlock IDs
+    static constexpr int connectionItemBlock = 1000;
+    static constexpr int toggleItem = 2;
+    static constexpr int removeItem = 3;
+    static constexpr int clearDepthItem = 4;
+    static constexpr int depthSourceItem = 100;     // + source index
+
     void showModulationMenu()
     {
         juce::PopupMenu menu;
 
-        // Show current connections
-        bool hasConnections = false;
-        int menuItemID = 1;
+        // Show current connections; items are resolved by connection ID when chosen
+        std::vector<int> menuConnectionIDs;
+        const int numDepthSources = juce::jmin(modMatrix.getNumSources(), connectionItemBlock - depthSourceItem);
 
         for (int i = 0; i < modMatrix.getNumConnections(); ++i)
         {
@@ -171,28 +180,98 @@ private:
                 auto* source = modMatrix.getSource(conn->sourceIndex);
                 if (source)
                 {
-                    hasConnections = true;
+                    const int menuItemID = static_cast<int>(menuConnectionIDs.size() + 1) * connectionItemBlock;
+                    menuConnectionIDs.push_back(conn->connectionID);
 
                     juce::PopupMenu connMenu;
                     connMenu.addItem(menuItemID + 1, "Depth: " + juce::String(conn->depth, 2), false, false);
-                    connMenu.addItem(menuItemID + 2, conn->enabled ? "Disable" : "Enable", true, conn->enabled);
-                    connMenu.addItem(menuItemID + 3, "Remove Connection", true, false);
+                    connMenu.addItem(menuItemID + toggleItem, conn->enabled ? "Disable" : "Enable", true, conn->enabled);
+                    connMenu.addItem(menuItemID + removeItem, "Remove Connection", true, false);
+
+                    // Modulation of this connection's depth by another source
+                    const auto depthID = modMatrix.getConnectionDepthDestinationID(i);
+                    juce::PopupMenu depthMenu;
+                    for (int s = 0; s < numDepthSources; ++s)
+                        if (auto* depthSource = modMatrix.getSource(s))
+                            depthMenu.addItem(menuItemID + depthSourceItem + s, depthSource->getName(),
+                                              true, findConnection(s, depthID) >= 0);
+
+                    depthMenu.addSeparator();
+                    depthMenu.addItem(menuItemID + clearDepthItem, "Clear Depth Modulation",
+                                      !modMatrix.getConnectionsForParameter(depthID).empty(), false);
+
+                    connMenu.addSeparator();
+                    connMenu.addSubMenu("Modulate Depth", depthMenu);
 
                     menu.addSubMenu(source->getName(), connMenu);
-                    menuItemID += 10;
                 }
             }
         }
 
-        if (!hasConnections)
+        if (menuConnectionIDs.empty())
         {
             menu.addItem(1, "No modulation connections", false);
         }
 
         menu.addSeparator();
-        menu.addItem(1000, "Drag modulation sources here...", false);
+        menu.addItem(2, "Drag modulation sources here...", false);
+
+        menu.showMenuAsync(juce::PopupMenu::Options(),
+            [safeThis = juce::Component::SafePointer<ModulatedSlider>(this), menuConnectionIDs](int result) {
+                const int block = result / connectionItemBlock - 1;
+                if (safeThis == nullptr || block < 0 || block >= static_cast<int>(menuConnectionIDs.size()))
+                    return;
+
+                safeThis->applyConnectionMenuItem(menuConnectionIDs[static_cast<size_t>(block)],
+                                                  result % connectionItemBlock);
+            });
+    }
+
+    void applyConnectionMenuItem(int connectionID, int item)
+    {
+        // The connection may have been removed while the menu was open
+        const int index = modMatrix.getConnectionIndex(connectionID);
+        auto* conn = modMatrix.getConnection(index);
+        if (!conn)
+            return;
 
-        menu.showMenuAsync(juce::PopupMenu::Options());
+        const auto depthID = modMatrix.getConnectionDepthDestinationID(index);
+
+        if (item == toggleItem)
+        {
+            modMatrix.setConnectionEnabled(index, !conn->enabled);
+        }
+        else if (item == removeItem)
+        {
+            modMatrix.removeConnection(index);
+        }
+        else if (item == clearDepthItem)
+        {
+            modMatrix.removeConnectionsForParameter(depthID);
+        }
+        else if (item >= depthSourceItem)
+        {
+            // Toggle the chosen source's modulation of this connection's depth
+            const int depthSourceIndex = item - depthSourceItem;
+            const int existing = findConnection(depthSourceIndex, depthID);
+
+            if (existing >= 0)
+                modMatrix.removeConnection(existing);
+            else if (modMatrix.addConnection(depthSourceIndex, depthID, 0.5f) < 0)
+                DBG("Modulation table full: Source " << depthSourceIndex << " -> " << depthID);
+        }
+
+        repaint();
+    }
+
+    int findConnection(int sourceIndex, const juce::String& destinationID) const
+    {
+        const auto& connections = modMatrix.getConnections();
+        for (int i = 0; i < static_cast<int>(connections.size()); ++i)
+            if (connections[static_cast<size_t>(i)].sourceIndex == sourceIndex
+                && connections[static_cast<size_t>(i)].parameterID == destinationID)
+                return i;
+        return -1;
     }
 
     float getModulationDepth() const
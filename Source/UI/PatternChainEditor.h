@@ -0,0 +1,317 @@
+/*
+  ==============================================================================
+    PatternChainEditor.h
+
+    Editor for the pattern chain (song mode)
+    One row per entry: generator, Euclidean pattern, density, length and
+    repeats. Every edit recompiles the chain on the message thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "CustomLookAndFeel.h"
+#include "../Core/PatternChain.h"
+
+class PatternChainEntryRow : public juce::Component
+{
+public:
+    PatternChainEntryRow(int entryIdx, PatternChain& patternChain)
+        : entryIndex(entryIdx), chain(patternChain)
+    {
+        // Entry number label
+        addAndMakeVisible(indexLabel);
+        indexLabel.setText(juce::String(entryIndex + 1), juce::dontSendNotification);
+        indexLabel.setFont(juce::Font(14.0f, juce::Font::bold));
+        indexLabel.setJustificationType(juce::Justification::centred);
+        indexLabel.setColour(juce::Label::textColourId, juce::Colour(CustomLookAndFeel::GOLD_TEMPLE));
+
+        // Generator (same indices as the generatorType parameter)
+        addAndMakeVisible(generatorCombo);
+        generatorCombo.addItemList(getGeneratorNames(), 1);
+        generatorCombo.onChange = [this]() { commitEdit(); };
+
+        setUpSlider(stepsSlider, 1, 64, 1);
+        setUpSlider(pulsesSlider, 0, 64, 1);
+        setUpSlider(rotationSlider, 0, 63, 1);
+        setUpSlider(densitySlider, 0.0, 1.0, 0.01);
+        setUpSlider(barsSlider, 1, 16, 1);
+        setUpSlider(repeatsSlider, 1, 16, 1);
+
+        // Remove this entry
+        addAndMakeVisible(removeButton);
+        removeButton.setButtonText("X");
+        removeButton.onClick = [this]()
+        {
+            if (onRemove)
+                onRemove(entryIndex);
+        };
+    }
+
+    std::function<void(int entryIndex)> onRemove;
+
+    static juce::StringArray getGeneratorNames()
+    {
+        return { "Euclidean", "Polyrhythm", "Markov", "L-System", "Cellular", "Probabilistic",
+                 "Brownian", "Perlin Noise", "Drunk Walk", "Lorenz", "Life",
+                 "Rossler", "Thomas", "Henon", "Chua" };
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        // Brass panel background
+        juce::ColourGradient panelGrad(
+            juce::Colour(CustomLookAndFeel::STEEL_OBSIDIAN).brighter(0.05f),
+            bounds.getCentreX(), bounds.getY(),
+            juce::Colour(CustomLookAndFeel::STEEL_OBSIDIAN).darker(0.1f),
+            bounds.getCentreX(), bounds.getBottom(),
+            false);
+        g.setGradientFill(panelGrad);
+        g.fillRoundedRectangle(bounds, 4.0f);
+
+        // Brass rim
+        g.setColour(juce::Colour(CustomLookAndFeel::BRASS_AGED).withAlpha(0.5f));
+        g.drawRoundedRectangle(bounds, 4.0f, 1.5f);
+    }
+
+    void resized() override
+    {
+        auto area = getLocalBounds().reduced(3);
+
+        indexLabel.setBounds(area.removeFromLeft(30));
+        removeButton.setBounds(area.removeFromRight(30).reduced(2));
+
+        generatorCombo.setBounds(area.removeFromLeft(120).reduced(2));
+        area.removeFromLeft(3);
+
+        // Sliders share the rest of the row
+        juce::Slider* sliders[] = { &stepsSlider, &pulsesSlider, &rotationSlider,
+                                    &densitySlider, &barsSlider, &repeatsSlider };
+        const int sliderWidth = area.getWidth() / static_cast<int>(std::size(sliders));
+        for (auto* slider : sliders)
+            slider->setBounds(area.removeFromLeft(sliderWidth).reduced(1));
+    }
+
+    void updateFromChain()
+    {
+        const auto& entries = chain.getEntries();
+        if (!juce::isPositiveAndBelow(entryIndex, static_cast<int>(entries.size())))
+            return;
+
+        const auto& entry = entries[static_cast<size_t>(entryIndex)];
+        generatorCombo.setSelectedId(entry.generatorType + 1, juce::dontSendNotification);
+        stepsSlider.setValue(entry.euclideanSteps, juce::dontSendNotification);
+        pulsesSlider.setRange(0, entry.euclideanSteps, 1);
+        pulsesSlider.setValue(entry.euclideanPulses, juce::dontSendNotification);
+        rotationSlider.setValue(entry.euclideanRotation, juce::dontSendNotification);
+        densitySlider.setValue(entry.noteDensity, juce::dontSendNotification);
+        barsSlider.setValue(entry.lengthInBars, juce::dontSendNotification);
+        repeatsSlider.setValue(entry.repeats, juce::dontSendNotification);
+    }
+
+private:
+    void setUpSlider(juce::Slider& slider, double minimum, double maximum, double interval)
+    {
+        addAndMakeVisible(slider);
+        slider.setRange(minimum, maximum, interval);
+        slider.setSliderStyle(juce::Slider::LinearHorizontal);
+        slider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 35, 20);
+
+        // Each edit recompiles the chain (restarting it on the next bar line), so only commit on release
+        slider.setChangeNotificationOnlyOnRelease(true);
+        slider.onValueChange = [this]() { commitEdit(); };
+    }
+
+    void commitEdit()
+    {
+        auto entries = chain.getEntries();
+        if (!juce::isPositiveAndBelow(entryIndex, static_cast<int>(entries.size())))
+            return;
+
+        auto& entry = entries[static_cast<size_t>(entryIndex)];
+        entry.generatorType = juce::jmax(0, generatorCombo.getSelectedId() - 1);
+        entry.euclideanSteps = static_cast<int>(stepsSlider.getValue());
+        entry.euclideanPulses = juce::jmin(static_cast<int>(pulsesSlider.getValue()), entry.euclideanSteps);
+        entry.euclideanRotation = static_cast<int>(rotationSlider.getValue());
+        entry.noteDensity = static_cast<float>(densitySlider.getValue());
+        entry.lengthInBars = static_cast<int>(barsSlider.getValue());
+        entry.repeats = static_cast<int>(repeatsSlider.getValue());
+
+        chain.setEntries(entries);
+        updateFromChain();  // Pulses are limited to the new step count
+    }
+
+    int entryIndex;
+    PatternChain& chain;
+
+    juce::Label indexLabel;
+    juce::ComboBox generatorCombo;
+    juce::Slider stepsSlider;
+    juce::Slider pulsesSlider;
+    juce::Slider rotationSlider;
+    juce::Slider densitySlider;
+    juce::Slider barsSlider;
+    juce::Slider repeatsSlider;
+    juce::TextButton removeButton;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatternChainEntryRow)
+};
+
+class PatternChainEditor : public juce::Component, private juce::Timer
+{
+public:
+    PatternChainEditor(PatternChain& patternChain, juce::AudioProcessorValueTreeState& state)
+        : chain(patternChain)
+    {
+        // Chain mode (host-visible parameter)
+        addAndMakeVisible(chainModeButton);
+        chainModeButton.setButtonText("Play Chain");
+        chainModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            state, "chainMode", chainModeButton);
+
+        // Add entry button (copies the last entry so a chain is quick to build)
+        addAndMakeVisible(addEntryButton);
+        addEntryButton.setButtonText("+ Add Entry");
+        addEntryButton.onClick = [this]() { addEntry(); };
+
+        addAndMakeVisible(clearButton);
+        clearButton.setButtonText("Clear");
+        clearButton.onClick = [this]()
+        {
+            chain.clear();
+            rebuildRows();
+        };
+
+        // Column headers
+        addAndMakeVisible(headersLabel);
+        headersLabel.setFont(juce::Font(10.0f, juce::Font::plain));
+        headersLabel.setJustificationType(juce::Justification::left);
+        headersLabel.setColour(juce::Label::textColourId, juce::Colour(CustomLookAndFeel::COPPER_STEAM));
+        headersLabel.setText("   #   Generator              Steps          Pulses         Rotation       Density        Bars           Repeats",
+                             juce::dontSendNotification);
+
+        // Rows scroll once the chain outgrows the window
+        addAndMakeVisible(rowViewport);
+        rowViewport.setViewedComponent(&rowContainer, false);
+        rowViewport.setScrollBarsShown(true, false);
+
+        rebuildRows();
+
+        startTimerHz(10);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        // Background panel
+        g.setColour(juce::Colour(CustomLookAndFeel::ABYSS_NAVY).darker(0.3f));
+        g.fillRoundedRectangle(bounds, 6.0f);
+
+        // Brass border
+        g.setColour(juce::Colour(CustomLookAndFeel::BRASS_AGED).withAlpha(0.6f));
+        g.drawRoundedRectangle(bounds, 6.0f, 2.0f);
+    }
+
+    void resized() override
+    {
+        auto area = getLocalBounds().reduced(5);
+
+        // Top: Buttons
+        auto buttonArea = area.removeFromTop(25);
+        chainModeButton.setBounds(buttonArea.removeFromLeft(100).reduced(2));
+        buttonArea.removeFromLeft(5);
+        addEntryButton.setBounds(buttonArea.removeFromLeft(100).reduced(2));
+        buttonArea.removeFromLeft(5);
+        clearButton.setBounds(buttonArea.removeFromLeft(70).reduced(2));
+
+        area.removeFromTop(3);
+        headersLabel.setBounds(area.removeFromTop(15));
+        area.removeFromTop(3);
+
+        rowViewport.setBounds(area);
+        layoutRows();
+    }
+
+private:
+    static constexpr int rowHeight = 32;
+
+    void layoutRows()
+    {
+        const int width = rowViewport.getMaximumVisibleWidth();
+        rowContainer.setSize(width, rows.size() * (rowHeight + 3));
+
+        int y = 0;
+        for (auto* row : rows)
+        {
+            row->setBounds(0, y, width, rowHeight);
+            y += rowHeight + 3;
+        }
+    }
+
+    void rebuildRows()
+    {
+        rows.clear();
+
+        for (int i = 0; i < chain.getNumEntries(); ++i)
+        {
+            auto* row = rows.add(new PatternChainEntryRow(i, chain));
+            row->onRemove = [this](int entryIndex)
+            {
+                // Rebuilt asynchronously: the row that asked is deleted by the rebuild
+                chain.removeEntry(entryIndex);
+                juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<PatternChainEditor>(this)]()
+                {
+                    if (safeThis != nullptr)
+                        safeThis->rebuildRows();
+                });
+            };
+            rowContainer.addAndMakeVisible(row);
+            row->updateFromChain();
+        }
+
+        addEntryButton.setEnabled(chain.getNumEntries() < PatternChain::maxEntries);
+        layoutRows();
+    }
+
+    void addEntry()
+    {
+        const auto& entries = chain.getEntries();
+        const auto entry = entries.empty() ? PatternChainEntry{} : entries.back();
+
+        if (chain.addEntry(entry) >= 0)
+            rebuildRows();
+    }
+
+    void timerCallback() override
+    {
+        // The chain can be replaced behind the editor (state or preset load)
+        if (rows.size() != chain.getNumEntries())
+            rebuildRows();
+        else
+            for (auto* row : rows)
+                if (!row->isMouseOverOrDragging(true))    // Leave a row being edited alone
+                    row->updateFromChain();
+
+        // Reclaim timelines the audio thread has moved past
+        chain.collectGarbage();
+    }
+
+    PatternChain& chain;
+
+    juce::ToggleButton chainModeButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> chainModeAttachment;
+    juce::TextButton addEntryButton;
+    juce::TextButton clearButton;
+    juce::Label headersLabel;
+
+    juce::Component rowContainer;
+    juce::Viewport rowViewport;
+    juce::OwnedArray<PatternChainEntryRow> rows;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatternChainEditor)
+};
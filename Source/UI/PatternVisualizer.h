@@ -36,6 +36,21 @@ public:
         repaint();
     }
 
+    // Called with the step index when a step is right-clicked
+    std::function<void(int step)> onStepRightClicked;
+
+    void mouseDown(const juce::MouseEvent& e) override
+    {
+        if (!e.mods.isPopupMenu() || pattern.empty() || !onStepRightClicked)
+            return;
+
+        // Same layout as paint(): steps span the width inside a 10px margin
+        const float stepWidth = (getWidth() - 20.0f) / pattern.size();
+        const int step = static_cast<int>((e.position.x - 10.0f) / stepWidth);
+        if (juce::isPositiveAndBelow(step, static_cast<int>(pattern.size())))
+            onStepRightClicked(step);
+    }
+
     void setProbabilityMiss(int step, bool missed)
     {
         if (step >= 0 && step < probabilityMisses.size())
@@ -12,6 +12,7 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "CustomLookAndFeel.h"
+#include "StepConditionMenu.h"
 #include "../Core/PolyrhythmEngine.h"
 
 class PolyrhythmLayerRow : public juce::Component
@@ -66,8 +67,20 @@ public:
         velocitySlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 40, 20);
         velocitySlider.onValueChange = [this]() { onVelocityChanged(); };
 
-        // Pattern display (mini visualizer)
+        // MIDI channel (0 = follow the global MIDI channel)
+        addAndMakeVisible(channelSlider);
+        channelSlider.setRange(0, 16, 1);
+        channelSlider.setValue(0, juce::dontSendNotification);
+        channelSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+        channelSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 30, 20);
+        channelSlider.textFromValueFunction = [](double value) {
+            return value < 1.0 ? juce::String("G") : juce::String(static_cast<int>(value));
+        };
+        channelSlider.onValueChange = [this]() { onChannelChanged(); };
+
+        // Pattern display (mini visualizer); right-click a step for its conditions
         addAndMakeVisible(patternDisplay);
+        patternDisplay.onStepRightClicked = [this](int step) { showStepMenu(step); };
     }
 
     void paint(juce::Graphics& g) override
@@ -114,6 +127,8 @@ public:
         pitchSlider.setBounds(area.removeFromLeft(sliderWidth).reduced(1));
         area.removeFromLeft(3);
         velocitySlider.setBounds(area.removeFromLeft(sliderWidth).reduced(1));
+        area.removeFromLeft(3);
+        channelSlider.setBounds(area.removeFromLeft(70).reduced(1));
     }
 
     void updateFromEngine()
@@ -124,10 +139,11 @@ public:
             enableButton.setToggleState(layer->enabled, juce::dontSendNotification);
             divisionSlider.setValue(layer->division, juce::dontSendNotification);
             lengthSlider.setValue(layer->length, juce::dontSendNotification);
+            channelSlider.setValue(layer->routing.midiChannel, juce::dontSendNotification);
 
             // Update pattern display
             patternDisplay.setPattern(layer->pattern);
-            patternDisplay.setCurrentStep(layer->currentStep);
+            patternDisplay.setCurrentStep(polyEngine.getCurrentStep(layerIndex, layer->length));
         }
     }
 
@@ -160,6 +176,23 @@ private:
         DBG("Velocity multiplier changed to: " << velocitySlider.getValue());
     }
 
+    void onChannelChanged()
+    {
+        polyEngine.setLayerMidiChannel(layerIndex, static_cast<int>(channelSlider.getValue()));
+    }
+
+    void showStepMenu(int step)
+    {
+        auto* layer = polyEngine.getLayer(layerIndex);
+        if (layer == nullptr)
+            return;
+
+        StepConditionMenu::show(layer->conditions, layer->microtiming, step,
+            [&engine = polyEngine, index = layerIndex](const StepConditionMenu::LaneEdit& edit) {
+                engine.editLayer(index, [&edit](PolyrhythmLayer& edited) { edit(edited.conditions, edited.microtiming); });
+            });
+    }
+
     int layerIndex;
     PolyrhythmEngine& polyEngine;
 
@@ -169,6 +202,7 @@ private:
     juce::Slider lengthSlider;
     juce::Slider pitchSlider;
     juce::Slider velocitySlider;
+    juce::Slider channelSlider;
 
     // Mini pattern visualizer
     class MiniPatternDisplay : public juce::Component
@@ -186,6 +220,18 @@ private:
             repaint();
         }
 
+        std::function<void(int step)> onStepRightClicked;
+
+        void mouseDown(const juce::MouseEvent& e) override
+        {
+            if (!e.mods.isPopupMenu() || pattern.empty() || !onStepRightClicked)
+                return;
+
+            const int step = static_cast<int>(e.position.x * pattern.size() / juce::jmax(1, getWidth()));
+            if (juce::isPositiveAndBelow(step, static_cast<int>(pattern.size())))
+                onStepRightClicked(step);
+        }
+
         void paint(juce::Graphics& g) override
         {
             auto bounds = getLocalBounds().toFloat();
@@ -337,7 +383,7 @@ public:
         }
 
         // Update header text (compact)
-        headersLabel.setText("  #  Pattern           Div   Len   Pitch  Vel",
+        headersLabel.setText("  #  Pattern           Div   Len   Pitch  Vel   Ch",
                             juce::dontSendNotification);
 
         resized();
@@ -379,6 +425,9 @@ private:
         {
             row->updateFromEngine();
         }
+
+        // Reclaim layer snapshots the audio thread has moved past
+        polyEngine.collectGarbage();
     }
 
     PolyrhythmEngine& polyEngine;
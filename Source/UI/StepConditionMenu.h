@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+    StepConditionMenu.h
+
+    Right-click menu for one sequencer step: probability, conditional trig,
+    parameter locks and microtiming nudge. Shared by the Euclidean pattern display and the
+    polyrhythm layer rows; the chosen edit is handed back to the caller,
+    which publishes it through its engine.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Core/StepConditions.h"
+#include "../Core/MicrotimingLane.h"
+
+class StepConditionMenu
+{
+public:
+    using LaneEdit = std::function<void(StepConditionLane&, MicrotimingLane&)>;
+
+    static void show(const StepConditionLane& lane, const MicrotimingLane& microtiming, int step, std::function<void(const LaneEdit&)> applyEdit)
+    {
+        juce::PopupMenu menu;
+        menu.addSectionHeader("Step " + juce::String(step + 1));
+
+        // Probability
+        juce::PopupMenu probabilityMenu;
+        const int currentProbability = juce::roundToInt(lane.getProbability(step) * 100.0f);
+        for (int i = 0; i < juce::numElementsInArray(probabilityChoices); ++i)
+            probabilityMenu.addItem(probabilityBaseID + i, juce::String(probabilityChoices[i]) + "%",
+                                    true, probabilityChoices[i] == currentProbability);
+        menu.addSubMenu("Probability", probabilityMenu);
+
+        // Conditional trig
+        const auto& condition = lane.getCondition(step);
+        juce::PopupMenu conditionMenu;
+        for (int i = 0; i < juce::numElementsInArray(conditionChoices); ++i)
+            conditionMenu.addItem(conditionBaseID + i, conditionChoices[i].name,
+                                  true, condition.flags == conditionChoices[i].flags);
+
+        conditionMenu.addSeparator();
+        for (int b = 2; b <= StepConditionLane::maxRatioCycles; ++b)
+        {
+            juce::PopupMenu ratioMenu;
+            for (int a = 1; a <= b; ++a)
+            {
+                const bool ticked = condition.flags == TrigCondition::Ratio
+                                 && condition.ratioA == a && condition.ratioB == b;
+                ratioMenu.addItem(ratioBaseID + b * 10 + a, juce::String(a) + ":" + juce::String(b), true, ticked);
+            }
+            conditionMenu.addSubMenu("Ratio x:" + juce::String(b), ratioMenu);
+        }
+        menu.addSubMenu("Condition", conditionMenu);
+
+        // Parameter locks
+        const auto locks = lane.getParameterLocks(step);
+
+        juce::PopupMenu velocityMenu;
+        velocityMenu.addItem(velocityBaseID, "Unlocked", true, !locks.locksVelocity());
+        for (int i = 0; i < juce::numElementsInArray(velocityChoices); ++i)
+            velocityMenu.addItem(velocityBaseID + 1 + i, juce::String(velocityChoices[i]) + "%", true,
+                                 locks.locksVelocity() && juce::roundToInt(locks.velocity * 100.0f) == velocityChoices[i]);
+        menu.addSubMenu("Velocity Lock", velocityMenu);
+
+        juce::PopupMenu gateMenu;
+        gateMenu.addItem(gateBaseID, "Unlocked", true, !locks.locksGate());
+        for (int i = 0; i < juce::numElementsInArray(gateChoices); ++i)
+            gateMenu.addItem(gateBaseID + 1 + i, juce::String(gateChoices[i]) + "%", true,
+                             locks.locksGate() && juce::roundToInt(locks.gateLength * 100.0f) == gateChoices[i]);
+        menu.addSubMenu("Gate Lock", gateMenu);
+
+        // Microtiming (ticks of 96 PPQN; negative plays early)
+        juce::PopupMenu nudgeMenu;
+        const int currentNudge = microtiming.getNudgeTicks(step);
+        for (int i = 0; i < juce::numElementsInArray(nudgeChoices); ++i)
+            nudgeMenu.addItem(nudgeBaseID + i, nudgeChoices[i] == 0 ? juce::String("On Grid")
+                                                                     : (nudgeChoices[i] > 0 ? "+" : "") + juce::String(nudgeChoices[i]) + " ticks",
+                              true, nudgeChoices[i] == currentNudge);
+        menu.addSubMenu("Nudge", nudgeMenu);
+
+        menu.addSeparator();
+        menu.addItem(clearID, "Clear Step");
+
+        menu.showMenuAsync(juce::PopupMenu::Options(), [step, locks, applyEdit](int result) {
+            if (result != 0 && applyEdit)
+                if (auto edit = createEdit(result, step, locks))
+                    applyEdit(edit);
+        });
+    }
+
+private:
+    enum
+    {
+        probabilityBaseID = 100,
+        conditionBaseID = 200,
+        ratioBaseID = 300,      // + B * 10 + A
+        velocityBaseID = 400,   // + 0 unlocks
+        gateBaseID = 500,       // + 0 unlocks
+        nudgeBaseID = 600,
+        clearID = 900
+    };
+
+    struct ConditionChoice
+    {
+        const char* name;
+        juce::uint32 flags;
+    };
+
+    static constexpr int probabilityChoices[] { 100, 75, 50, 25, 10 };
+    static constexpr int velocityChoices[] { 25, 50, 75, 100 };
+    static constexpr int gateChoices[] { 25, 50, 100, 150 };
+    static constexpr int nudgeChoices[] { -12, -6, -3, 0, 3, 6, 12 };
+    static constexpr ConditionChoice conditionChoices[] {
+        { "Always", TrigCondition::None },
+        { "Fill", TrigCondition::Fill },
+        { "Not Fill", TrigCondition::NotFill },
+        { "First", TrigCondition::First },
+        { "Not First", TrigCondition::NotFirst },
+        { "Previous Fired", TrigCondition::PreviousFired },
+        { "Not Previous Fired", TrigCondition::NotPreviousFired }
+    };
+
+    static LaneEdit createEdit(int result, int step, StepParameterLocks locks)
+    {
+        if (result >= probabilityBaseID && result < conditionBaseID)
+        {
+            const float probability = probabilityChoices[result - probabilityBaseID] / 100.0f;
+            return [step, probability](StepConditionLane& lane, MicrotimingLane&) { lane.setProbability(step, probability); };
+        }
+
+        if (result >= conditionBaseID && result < ratioBaseID)
+        {
+            const auto flags = conditionChoices[result - conditionBaseID].flags;
+            return [step, flags](StepConditionLane& lane, MicrotimingLane&) { lane.setCondition(step, flags); };
+        }
+
+        if (result >= ratioBaseID && result < velocityBaseID)
+        {
+            const int ratioB = (result - ratioBaseID) / 10;
+            const int ratioA = (result - ratioBaseID) % 10;
+            return [step, ratioA, ratioB](StepConditionLane& lane, MicrotimingLane&) {
+                lane.setCondition(step, TrigCondition::Ratio, ratioA, ratioB);
+            };
+        }
+
+        if (result >= velocityBaseID && result < gateBaseID)
+        {
+            const int choice = result - velocityBaseID;
+            if (choice == 0)
+                locks.flags &= static_cast<juce::uint8>(~StepParameterLocks::LockVelocity);
+            else
+            {
+                locks.flags |= StepParameterLocks::LockVelocity;
+                locks.velocity = velocityChoices[choice - 1] / 100.0f;
+            }
+            return [step, locks](StepConditionLane& lane, MicrotimingLane&) { lane.setParameterLocks(step, locks); };
+        }
+
+        if (result >= gateBaseID && result < nudgeBaseID)
+        {
+            const int choice = result - gateBaseID;
+            if (choice == 0)
+                locks.flags &= static_cast<juce::uint8>(~StepParameterLocks::LockGate);
+            else
+            {
+                locks.flags |= StepParameterLocks::LockGate;
+                locks.gateLength = gateChoices[choice - 1] / 100.0f;
+            }
+            return [step, locks](StepConditionLane& lane, MicrotimingLane&) { lane.setParameterLocks(step, locks); };
+        }
+
+        if (result >= nudgeBaseID && result < clearID)
+        {
+            const int ticks = nudgeChoices[result - nudgeBaseID];
+            return [step, ticks](StepConditionLane&, MicrotimingLane& microtiming) {
+                microtiming.setNudgeTicks(step, ticks);
+            };
+        }
+
+        if (result == clearID)
+            return [step](StepConditionLane& lane, MicrotimingLane& microtiming) {
+                lane.clearStep(step);
+                microtiming.setNudge(step, 0.0f);
+            };
+
+        return {};
+    }
+};